@@ -0,0 +1,571 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "acumulado.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define MAX_HILOS 64
+/* below this many elements per thread, creating the thread costs more than it saves */
+#define MIN_TRABAJO (1UL << 16)
+/* parts start at multiples of this many elements, so no two threads write the same cache line */
+#define ALINEACION 16
+/* independent accumulators when reducing a part: the compiler keeps them in one vector register */
+#define LANES 8
+
+#define SUMAR(T, U, a, b) ((T) ((U) (a) + (U) (b)))
+/* b is the new element: a NaN never wins, so with doubles they are ignored */
+#define MAXIMO(T, U, a, b) (((b) > (a)) ? (b) : (a))
+
+
+typedef union {
+    int32_t i32;
+    int64_t i64;
+    double f64;
+} valor_t;
+
+
+typedef struct {
+    const void *entrada;
+    void *salida;
+    const bool *inicio;
+    bool exclusivo;
+    size_t limites[MAX_HILOS + 1];
+    /* first pass: what each part adds to the next one, and whether a segment starts in it */
+    valor_t totales[MAX_HILOS];
+    bool con_inicio[MAX_HILOS];
+    /* second pass: what each part starts from */
+    valor_t previos[MAX_HILOS];
+} trabajo_t;
+
+
+typedef void (*parte_fn_t)(trabajo_t *t, size_t parte);
+
+
+typedef struct {
+    parte_fn_t fn;
+    trabajo_t *t;
+    size_t parte;
+    pthread_t hilo;
+    bool lanzado;
+} hilo_t;
+
+
+static size_t minimo(size_t a, size_t b)
+{
+    return (a < b) ? a : b;
+}
+
+
+static size_t dividir(trabajo_t *t, size_t n, size_t hilos)
+{
+    size_t partes;
+    long cpus;
+
+    if (0 == hilos) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = (cpus > 0) ? (size_t) cpus : 1;
+    }
+    partes = minimo(minimo(hilos, MAX_HILOS), n / MIN_TRABAJO + 1);
+
+    for (size_t p = 0; p < partes; ++p) {
+        t->limites[p] = n / partes * p / ALINEACION * ALINEACION;
+    }
+    t->limites[partes] = n;
+
+    return partes;
+}
+
+
+static void *correr_parte(void *arg)
+{
+    hilo_t *h = (hilo_t *) arg;
+
+    h->fn(h->t, h->parte);
+
+    return NULL;
+}
+
+
+/* one thread per part; the calling thread takes the first one */
+static void correr(parte_fn_t fn, trabajo_t *t, size_t partes)
+{
+    hilo_t hilos[MAX_HILOS];
+
+    for (size_t p = 0; p < partes; ++p) {
+        hilos[p].fn = fn;
+        hilos[p].t = t;
+        hilos[p].parte = p;
+        hilos[p].lanzado = false;
+    }
+
+    for (size_t p = 1; p < partes; ++p) {
+        hilos[p].lanzado = (0 == pthread_create(&hilos[p].hilo, NULL, correr_parte, &hilos[p]));
+    }
+
+    /* a part whose thread could not be created is done here, so the result is always complete */
+    for (size_t p = 0; p < partes; ++p) {
+        if (!hilos[p].lanzado) {
+            correr_parte(&hilos[p]);
+        }
+    }
+    for (size_t p = 1; p < partes; ++p) {
+        if (hilos[p].lanzado) {
+            pthread_join(hilos[p].hilo, NULL);
+        }
+    }
+}
+
+
+#ifdef __AVX2__
+
+#define LANES_i32 8
+#define LANES_i64 4
+#define LANES_f64 4
+
+typedef __m256i vector_i32_t;
+typedef __m256i vector_i64_t;
+typedef __m256d vector_f64_t;
+
+
+/* lanes moved k places towards the end, the first k taken from `relleno`; k is a constant once inlined */
+static inline __m256i desplazar_i32(__m256i x, __m256i relleno, int k)
+{
+    const __m256i carriles = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i desplazamiento = _mm256_set1_epi32(k);
+    __m256i movidos = _mm256_permutevar8x32_epi32(x, _mm256_sub_epi32(carriles, desplazamiento));
+
+    return _mm256_blendv_epi8(movidos, relleno, _mm256_cmpgt_epi32(desplazamiento, carriles));
+}
+
+
+static inline __m256i desplazar_i64(__m256i x, __m256i relleno, int k)
+{
+    return desplazar_i32(x, relleno, 2 * k);
+}
+
+
+static inline __m256d desplazar_f64(__m256d x, __m256d relleno, int k)
+{
+    return _mm256_castsi256_pd(desplazar_i32(_mm256_castpd_si256(x), _mm256_castpd_si256(relleno), 2 * k));
+}
+
+
+/* segment starts as lane masks: all ones where inicio[i] is true */
+static inline __m256i cargar_inicios_i32(const bool inicio[])
+{
+    __m256i unos = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) inicio));
+
+    return _mm256_sub_epi32(_mm256_setzero_si256(), unos);
+}
+
+
+static inline __m256i cargar_inicios_i64(const bool inicio[])
+{
+    int32_t bytes;
+
+    memcpy(&bytes, inicio, sizeof(bytes));
+
+    return _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes)));
+}
+
+
+static inline __m256i cargar_inicios_f64(const bool inicio[])
+{
+    return cargar_inicios_i64(inicio);
+}
+
+
+static inline __m256i desplazar_inicios_i32(__m256i f, int k)
+{
+    return desplazar_i32(f, _mm256_setzero_si256(), k);
+}
+
+
+static inline __m256i desplazar_inicios_i64(__m256i f, int k)
+{
+    return desplazar_i64(f, _mm256_setzero_si256(), k);
+}
+
+
+static inline __m256i desplazar_inicios_f64(__m256i f, int k)
+{
+    return desplazar_i64(f, _mm256_setzero_si256(), k);
+}
+
+
+/* m ? a : b, lane by lane */
+static inline __m256i elegir_i32(__m256i m, __m256i a, __m256i b)
+{
+    return _mm256_blendv_epi8(b, a, m);
+}
+
+
+static inline __m256i elegir_i64(__m256i m, __m256i a, __m256i b)
+{
+    return _mm256_blendv_epi8(b, a, m);
+}
+
+
+static inline __m256d elegir_f64(__m256i m, __m256d a, __m256d b)
+{
+    return _mm256_blendv_pd(b, a, _mm256_castsi256_pd(m));
+}
+
+
+static inline __m256i cargar_i32(const int32_t v[])
+{
+    return _mm256_loadu_si256((const __m256i *) v);
+}
+
+
+static inline __m256i cargar_i64(const int64_t v[])
+{
+    return _mm256_loadu_si256((const __m256i *) v);
+}
+
+
+static inline __m256d cargar_f64(const double v[])
+{
+    return _mm256_loadu_pd(v);
+}
+
+
+static inline void guardar_i32(int32_t v[], __m256i x)
+{
+    _mm256_storeu_si256((__m256i *) v, x);
+}
+
+
+static inline void guardar_i64(int64_t v[], __m256i x)
+{
+    _mm256_storeu_si256((__m256i *) v, x);
+}
+
+
+static inline void guardar_f64(double v[], __m256d x)
+{
+    _mm256_storeu_pd(v, x);
+}
+
+
+static inline __m256i difundir_i32(int32_t x)
+{
+    return _mm256_set1_epi32(x);
+}
+
+
+static inline __m256i difundir_i64(int64_t x)
+{
+    return _mm256_set1_epi64x(x);
+}
+
+
+static inline __m256d difundir_f64(double x)
+{
+    return _mm256_set1_pd(x);
+}
+
+
+/* the last lane in every lane */
+static inline __m256i ultimo_i32(__m256i x)
+{
+    return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+}
+
+
+static inline __m256i ultimo_i64(__m256i x)
+{
+    return _mm256_permute4x64_epi64(x, 0xff);
+}
+
+
+static inline __m256d ultimo_f64(__m256d x)
+{
+    return _mm256_permute4x64_pd(x, 0xff);
+}
+
+
+static inline int32_t primero_i32(__m256i x)
+{
+    return _mm256_cvtsi256_si32(x);
+}
+
+
+static inline int64_t primero_i64(__m256i x)
+{
+    return _mm_cvtsi128_si64(_mm256_castsi256_si128(x));
+}
+
+
+static inline double primero_f64(__m256d x)
+{
+    return _mm256_cvtsd_f64(x);
+}
+
+
+static inline __m256i suma_i32(__m256i a, __m256i b)
+{
+    return _mm256_add_epi32(a, b);
+}
+
+
+static inline __m256i suma_i64(__m256i a, __m256i b)
+{
+    return _mm256_add_epi64(a, b);
+}
+
+
+static inline __m256d suma_f64(__m256d a, __m256d b)
+{
+    return _mm256_add_pd(a, b);
+}
+
+
+static inline __m256i maximo_i32(__m256i a, __m256i b)
+{
+    return _mm256_max_epi32(a, b);
+}
+
+
+/* AVX2 has no 64-bit max */
+static inline __m256i maximo_i64(__m256i a, __m256i b)
+{
+    return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+}
+
+
+static inline __m256d maximo_f64(__m256d a, __m256d b)
+{
+    return _mm256_max_pd(a, b);
+}
+
+
+/* _mm256_max_pd returns its second operand if either is NaN: in a max scan NaN lanes become the identity first */
+static inline __m256i limpiar_i32(__m256i x, __m256i neutro)
+{
+    (void) neutro;
+
+    return x;
+}
+
+
+static inline __m256i limpiar_i64(__m256i x, __m256i neutro)
+{
+    (void) neutro;
+
+    return x;
+}
+
+
+static inline __m256d limpiar_f64(__m256d x, __m256d neutro)
+{
+    return _mm256_blendv_pd(x, neutro, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+}
+
+
+#define LIMPIAR_suma(nombre, x, neutro) (x)
+#define LIMPIAR_maximo(nombre, x, neutro) limpiar_##nombre(x, neutro)
+
+
+/*
+ * Hillis-Steele scan inside a vector: after the step with shift k every lane holds the result of the 2k lanes ending
+ * at it. Segmented, a lane stops taking from the previous ones once a segment start is among the lanes it has
+ * covered (f accumulates those starts). The carry from the previous vector is added last, and the exclusive result is
+ * the inclusive one moved one lane.
+ */
+#define BLOQUE_DEFINE(T, nombre, op, IDENT)                                                                         \
+static size_t bloque_##op##_##nombre(T s[], const T e[], const bool inicio[], size_t n, T *previo, bool exclusivo)  \
+{                                                                                                                   \
+    const vector_##nombre##_t neutro = difundir_##nombre(IDENT);                                                    \
+    vector_##nombre##_t c = difundir_##nombre(*previo);                                                             \
+    vector_##nombre##_t x;                                                                                          \
+    vector_##nombre##_t y;                                                                                          \
+    __m256i f;                                                                                                      \
+    __m256i f0;                                                                                                     \
+    size_t i = 0;                                                                                                   \
+                                                                                                                    \
+    for (; i + LANES_##nombre <= n; i += LANES_##nombre) {                                                          \
+        x = LIMPIAR_##op(nombre, cargar_##nombre(e + i), neutro);                                                   \
+        if (NULL == inicio) {                                                                                       \
+            _Pragma("GCC unroll 4")                                                                                 \
+            for (int k = 1; k < LANES_##nombre; k *= 2) {                                                           \
+                x = op##_##nombre(x, desplazar_##nombre(x, neutro, k));                                             \
+            }                                                                                                       \
+            x = op##_##nombre(x, c);                                                                                \
+            y = desplazar_##nombre(x, c, 1);                                                                        \
+        } else {                                                                                                    \
+            f0 = cargar_inicios_##nombre(inicio + i);                                                               \
+            f = f0;                                                                                                 \
+            _Pragma("GCC unroll 4")                                                                                 \
+            for (int k = 1; k < LANES_##nombre; k *= 2) {                                                           \
+                x = elegir_##nombre(f, x, op##_##nombre(x, desplazar_##nombre(x, neutro, k)));                      \
+                f = _mm256_or_si256(f, desplazar_inicios_##nombre(f, k));                                           \
+            }                                                                                                       \
+            x = elegir_##nombre(f, x, op##_##nombre(x, c));                                                         \
+            y = elegir_##nombre(f0, neutro, desplazar_##nombre(x, c, 1));                                           \
+        }                                                                                                           \
+        guardar_##nombre(s + i, exclusivo ? y : x);                                                                 \
+        c = ultimo_##nombre(x);                                                                                     \
+    }                                                                                                               \
+    *previo = primero_##nombre(c);                                                                                  \
+                                                                                                                    \
+    return i;                                                                                                       \
+}
+
+#else
+
+#define BLOQUE_DEFINE(T, nombre, op, IDENT)                                                                         \
+static size_t bloque_##op##_##nombre(T s[], const T e[], const bool inicio[], size_t n, T *previo, bool exclusivo)  \
+{                                                                                                                   \
+    (void) s;                                                                                                       \
+    (void) e;                                                                                                       \
+    (void) inicio;                                                                                                  \
+    (void) n;                                                                                                       \
+    (void) previo;                                                                                                  \
+    (void) exclusivo;                                                                                               \
+                                                                                                                    \
+    return 0;                                                                                                       \
+}
+
+#endif
+
+
+#define ESCANEO_DEFINE(T, nombre, U, op, OP, IDENT)                                                                 \
+BLOQUE_DEFINE(T, nombre, op, IDENT)                                                                                 \
+                                                                                                                    \
+static T reducir_##op##_##nombre(const T e[], size_t n)                                                             \
+{                                                                                                                   \
+    T lanes[LANES];                                                                                                 \
+    T total = IDENT;                                                                                                \
+    size_t i = 0;                                                                                                   \
+                                                                                                                    \
+    for (size_t k = 0; k < LANES; ++k) {                                                                            \
+        lanes[k] = IDENT;                                                                                           \
+    }                                                                                                               \
+    for (; i + LANES <= n; i += LANES) {                                                                            \
+        for (size_t k = 0; k < LANES; ++k) {                                                                        \
+            lanes[k] = OP(T, U, lanes[k], e[i + k]);                                                                \
+        }                                                                                                           \
+    }                                                                                                               \
+    for (size_t k = 0; k < LANES; ++k) {                                                                            \
+        total = OP(T, U, total, lanes[k]);                                                                          \
+    }                                                                                                               \
+    for (; i < n; ++i) {                                                                                            \
+        total = OP(T, U, total, e[i]);                                                                              \
+    }                                                                                                               \
+                                                                                                                    \
+    return total;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+/* the vector loop first, then the elements left (all of them without AVX2) one by one */                           \
+static void escanear_##op##_##nombre(T s[], const T e[], const bool inicio[], size_t n, T previo, bool exclusivo)   \
+{                                                                                                                   \
+    size_t i = bloque_##op##_##nombre(s, e, inicio, n, &previo, exclusivo);                                         \
+    T x;                                                                                                            \
+    T a;                                                                                                            \
+                                                                                                                    \
+    for (; i < n; ++i) {                                                                                            \
+        x = e[i];                                                                                                   \
+        if ((NULL != inicio) && inicio[i]) {                                                                        \
+            previo = IDENT;                                                                                         \
+        }                                                                                                           \
+        a = OP(T, U, previo, x);                                                                                    \
+        s[i] = exclusivo ? previo : a;                                                                              \
+        previo = a;                                                                                                 \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+/* only what comes after the last segment start of the part reaches the next part */                                \
+static void reducir_parte_##op##_##nombre(trabajo_t *t, size_t parte)                                               \
+{                                                                                                                   \
+    size_t desde = t->limites[parte];                                                                               \
+    size_t hasta = t->limites[parte + 1];                                                                           \
+    size_t j = desde;                                                                                               \
+                                                                                                                    \
+    if (NULL != t->inicio) {                                                                                        \
+        j = hasta;                                                                                                  \
+        while ((j > desde) && !t->inicio[j - 1]) {                                                                  \
+            --j;                                                                                                    \
+        }                                                                                                           \
+    }                                                                                                               \
+    t->con_inicio[parte] = (j > desde);                                                                             \
+    if (j > desde) {                                                                                                \
+        desde = j - 1;                                                                                              \
+    }                                                                                                               \
+    t->totales[parte].nombre = reducir_##op##_##nombre((const T *) t->entrada + desde, hasta - desde);              \
+}                                                                                                                   \
+                                                                                                                    \
+static void escanear_parte_##op##_##nombre(trabajo_t *t, size_t parte)                                              \
+{                                                                                                                   \
+    size_t desde = t->limites[parte];                                                                               \
+    size_t hasta = t->limites[parte + 1];                                                                           \
+                                                                                                                    \
+    escanear_##op##_##nombre((T *) t->salida + desde, (const T *) t->entrada + desde,                               \
+                             (NULL != t->inicio) ? t->inicio + desde : NULL, hasta - desde,                         \
+                             t->previos[parte].nombre, t->exclusivo);                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static bool acumular_##op##_##nombre(T s[], const T e[], const bool inicio[], size_t n, acumulado_t tipo,           \
+                                     size_t hilos)                                                                  \
+{                                                                                                                   \
+    trabajo_t t;                                                                                                    \
+    size_t partes;                                                                                                  \
+                                                                                                                    \
+    t.entrada = e;                                                                                                  \
+    t.salida = s;                                                                                                   \
+    t.inicio = inicio;                                                                                              \
+    t.exclusivo = (ACUMULADO_EXCLUSIVO == tipo);                                                                    \
+    partes = dividir(&t, n, hilos);                                                                                 \
+                                                                                                                    \
+    /* the last part passes nothing on */                                                                           \
+    if (partes > 1) {                                                                                               \
+        correr(reducir_parte_##op##_##nombre, &t, partes - 1);                                                      \
+    }                                                                                                               \
+    t.previos[0].nombre = IDENT;                                                                                    \
+    for (size_t p = 1; p < partes; ++p) {                                                                           \
+        t.previos[p].nombre = t.con_inicio[p - 1] ? t.totales[p - 1].nombre                                         \
+                                                  : OP(T, U, t.previos[p - 1].nombre, t.totales[p - 1].nombre);     \
+    }                                                                                                               \
+    correr(escanear_parte_##op##_##nombre, &t, partes);                                                             \
+                                                                                                                    \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+bool acumulado_##op##_##nombre(T salida[], const T entrada[], size_t n, acumulado_t tipo, size_t hilos)             \
+{                                                                                                                   \
+    if ((NULL == salida) || (NULL == entrada)) {                                                                    \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    return acumular_##op##_##nombre(salida, entrada, NULL, n, tipo, hilos);                                         \
+}                                                                                                                   \
+                                                                                                                    \
+bool acumulado_##op##_segmentos_##nombre(T salida[], const T entrada[], const bool inicio[], size_t n,              \
+                                         acumulado_t tipo, size_t hilos)                                            \
+{                                                                                                                   \
+    if ((NULL == salida) || (NULL == entrada) || (NULL == inicio)) {                                                \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    return acumular_##op##_##nombre(salida, entrada, inicio, n, tipo, hilos);                                       \
+}
+
+
+#define ACUMULADO_DEFINE(T, nombre, U, MINIMO)                                                                      \
+ESCANEO_DEFINE(T, nombre, U, suma, SUMAR, 0)                                                                        \
+ESCANEO_DEFINE(T, nombre, U, maximo, MAXIMO, MINIMO)
+
+
+ACUMULADO_DEFINE(int32_t, i32, uint32_t, INT32_MIN)
+ACUMULADO_DEFINE(int64_t, i64, uint64_t, INT64_MIN)
+ACUMULADO_DEFINE(double, f64, double, -INFINITY)
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Sumas y máximos acumulados (prefix sums / scans) de arreglos de int32_t, int64_t y double.
+ *
+ * -   acumulado_suma_<t>: salida[i] = entrada[0] + ... + entrada[i] (ACUMULADO_INCLUSIVO) o
+ *     entrada[0] + ... + entrada[i - 1] (ACUMULADO_EXCLUSIVO, salida[0] = 0). Sirve, por ejemplo, para pasar de la
+ *     cantidad de elementos de cada balde a la posición donde empieza cada balde.
+ * -   acumulado_maximo_<t>: lo mismo con el máximo; el exclusivo empieza con el menor valor del tipo (INT32_MIN,
+ *     INT64_MIN o -INFINITY). Con double, los NaN no se tienen en cuenta.
+ * -   Las versiones `_segmentos` reinician el acumulado en cada i con inicio[i] verdadero, de modo que cada segmento
+ *     del arreglo se acumula por separado (en el exclusivo, el primer elemento de cada segmento es 0 o el mínimo).
+ *
+ * Con enteros la suma se hace módulo 2^32 o 2^64 (como si fueran sin signo): si desborda no hay comportamiento
+ * indefinido, y el resultado es el mismo que el del ciclo de a un elemento.
+ *
+ * El arreglo se reparte en partes contiguas entre `hilos` hilos (0: uno por procesador) si hay trabajo suficiente,
+ * en dos pasadas: primero cada hilo calcula el total de su parte, se acumulan los totales de las partes (son pocos) y
+ * después cada hilo acumula su parte empezando por el total de las anteriores. Dentro de cada parte, con AVX2, se
+ * acumulan de a 8 (int32_t) o de a 4 (int64_t y double) elementos por instrucción. Como la suma de enteros y el
+ * máximo son asociativos, el resultado no depende de la cantidad de hilos; la suma de double sí, en los últimos bits,
+ * porque el redondeo depende del orden en que se suma.
+ *
+ * `salida` puede ser el mismo arreglo que `entrada` (pero no superponerse de otra forma). Las funciones devuelven
+ * false si algún puntero es NULL.
+ */
+
+typedef enum {
+    ACUMULADO_INCLUSIVO,
+    ACUMULADO_EXCLUSIVO,
+} acumulado_t;
+
+
+#define ACUMULADO_DECLARE(T, nombre)                                                                                \
+bool acumulado_suma_##nombre(T salida[], const T entrada[], size_t n, acumulado_t tipo, size_t hilos);              \
+bool acumulado_maximo_##nombre(T salida[], const T entrada[], size_t n, acumulado_t tipo, size_t hilos);            \
+bool acumulado_suma_segmentos_##nombre(T salida[], const T entrada[], const bool inicio[], size_t n,                \
+                                       acumulado_t tipo, size_t hilos);                                             \
+bool acumulado_maximo_segmentos_##nombre(T salida[], const T entrada[], const bool inicio[], size_t n,              \
+                                         acumulado_t tipo, size_t hilos);
+
+
+ACUMULADO_DECLARE(int32_t, i32)
+ACUMULADO_DECLARE(int64_t, i64)
+ACUMULADO_DECLARE(double, f64)
+
+
+#define ACUMULADO_ELEGIR(fn, v) _Generic((v),                                                                       \
+    int32_t *: fn##_i32,                                                                                            \
+    int64_t *: fn##_i64,                                                                                            \
+    double *: fn##_f64)
+
+/* eligen la versión según el tipo de `salida` */
+#define acumulado_suma(s, e, n, tipo, hilos) ACUMULADO_ELEGIR(acumulado_suma, s)(s, e, n, tipo, hilos)
+#define acumulado_maximo(s, e, n, tipo, hilos) ACUMULADO_ELEGIR(acumulado_maximo, s)(s, e, n, tipo, hilos)
+#define acumulado_suma_segmentos(s, e, inicio, n, tipo, hilos)                                                      \
+    ACUMULADO_ELEGIR(acumulado_suma_segmentos, s)(s, e, inicio, n, tipo, hilos)
+#define acumulado_maximo_segmentos(s, e, inicio, n, tipo, hilos)                                                    \
+    ACUMULADO_ELEGIR(acumulado_maximo_segmentos, s)(s, e, inicio, n, tipo, hilos)
@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "acumulado.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Compara las sumas y máximos acumulados de acumulado.c (con un hilo y con varios) contra el ciclo de a un elemento,
+ * inclusivos y exclusivos, con y sin segmentos (uno cada SEGMENTO elementos en promedio). Con enteros verifica que el
+ * resultado sea idéntico al del ciclo; con double muestra el mayor error relativo de la suma.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -pthread -o bench_acumulado bench_acumulado.c acumulado.c -lm
+ * $ ./bench_acumulado [elementos] [hilos]
+ */
+
+#define DEFAULT_LENGTH (1UL << 25)
+#define SEGMENTO 1000
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/* the loop everyone writes; integers wrap around like in acumulado.c */
+#define SERIAL_DEFINE(T, nombre, U, MINIMO)                                                                         \
+static void serial_##nombre(T s[], const T e[], const bool inicio[], size_t n, bool maximo, bool exclusivo)         \
+{                                                                                                                   \
+    T previo = maximo ? MINIMO : 0;                                                                                 \
+    T a;                                                                                                            \
+                                                                                                                    \
+    for (size_t i = 0; i < n; ++i) {                                                                                \
+        if ((NULL != inicio) && inicio[i]) {                                                                        \
+            previo = maximo ? MINIMO : 0;                                                                           \
+        }                                                                                                           \
+        if (maximo) {                                                                                               \
+            a = (e[i] > previo) ? e[i] : previo;                                                                    \
+        } else {                                                                                                    \
+            a = (T) ((U) previo + (U) e[i]);                                                                        \
+        }                                                                                                           \
+        s[i] = exclusivo ? previo : a;                                                                              \
+        previo = a;                                                                                                 \
+    }                                                                                                               \
+}
+
+SERIAL_DEFINE(int32_t, i32, uint32_t, INT32_MIN)
+SERIAL_DEFINE(int64_t, i64, uint64_t, INT64_MIN)
+SERIAL_DEFINE(double, f64, double, -INFINITY)
+
+
+static double diferencia_i32(const int32_t a[], const int32_t b[], size_t n)
+{
+    return (0 == memcmp(a, b, n * sizeof(a[0]))) ? 0 : INFINITY;
+}
+
+
+static double diferencia_i64(const int64_t a[], const int64_t b[], size_t n)
+{
+    return (0 == memcmp(a, b, n * sizeof(a[0]))) ? 0 : INFINITY;
+}
+
+
+/* largest relative error (NaN where the loop has NaN); the max scan has to be exact */
+static double diferencia_f64(const double a[], const double b[], size_t n)
+{
+    double error = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (isnan(a[i]) != isnan(b[i])) {
+            return INFINITY;
+        }
+        if (a[i] != b[i]) {
+            error = fmax(error, fabs(a[i] - b[i]) / fmax(fabs(b[i]), 1));
+        }
+    }
+
+    return error;
+}
+
+
+/*
+ * For each scan: the serial loop, then acumulado with 1 and with `hilos` threads. The last one runs in place
+ * (salida == entrada), so the input is copied back afterwards.
+ */
+#define PROBAR_DEFINE(T, nombre)                                                                                    \
+static bool probar_##nombre(T *e, T *s, T *esperado, const bool inicio[], size_t n, size_t hilos)                   \
+{                                                                                                                   \
+    const char *nombres[] = {"suma", "máximo"};                                                                     \
+    T *copia = (T *) malloc(n * sizeof(T));                                                                         \
+    bool ok = true;                                                                                                 \
+    double t_serial;                                                                                                \
+    double t1;                                                                                                      \
+    double th;                                                                                                      \
+    double d;                                                                                                       \
+    const bool *seg;                                                                                                \
+    acumulado_t tipo;                                                                                               \
+                                                                                                                    \
+    if (NULL == copia) {                                                                                            \
+        return false;                                                                                               \
+    }                                                                                                               \
+    memcpy(copia, e, n * sizeof(T));                                                                                \
+    /* untimed: the first pass over fresh memory is several times slower */                                         \
+    serial_##nombre(esperado, e, NULL, n, false, false);                                                            \
+    acumulado_suma(s, e, n, ACUMULADO_INCLUSIVO, hilos);                                                            \
+                                                                                                                    \
+    for (int c = 0; c < 8; ++c) {                                                                                   \
+        bool maximo = c & 1;                                                                                        \
+        tipo = (c & 2) ? ACUMULADO_EXCLUSIVO : ACUMULADO_INCLUSIVO;                                                 \
+        seg = (c & 4) ? inicio : NULL;                                                                              \
+                                                                                                                    \
+        t_serial = now();                                                                                           \
+        serial_##nombre(esperado, e, seg, n, maximo, ACUMULADO_EXCLUSIVO == tipo);                                  \
+        t_serial = now() - t_serial;                                                                                \
+                                                                                                                    \
+        d = 0;                                                                                                      \
+        for (size_t h = 0; h < 2; ++h) {                                                                            \
+            T *salida = h ? e : s;                                                                                  \
+            double t = now();                                                                                       \
+            if (NULL == seg) {                                                                                      \
+                ok = (maximo ? acumulado_maximo(salida, e, n, tipo, h ? hilos : 1)                                  \
+                             : acumulado_suma(salida, e, n, tipo, h ? hilos : 1)) && ok;                            \
+            } else {                                                                                                \
+                ok = (maximo ? acumulado_maximo_segmentos(salida, e, seg, n, tipo, h ? hilos : 1)                   \
+                             : acumulado_suma_segmentos(salida, e, seg, n, tipo, h ? hilos : 1)) && ok;             \
+            }                                                                                                       \
+            t = now() - t;                                                                                          \
+            if (h) {                                                                                                \
+                th = t;                                                                                             \
+            } else {                                                                                                \
+                t1 = t;                                                                                             \
+            }                                                                                                       \
+            d = fmax(d, diferencia_##nombre(salida, esperado, n));                                                  \
+            memcpy(e, copia, n * sizeof(T));                                                                        \
+        }                                                                                                           \
+        ok = ok && (maximo ? (0 == d) : (d < 1e-9));                                                                \
+        printf("  %-7s %-10s %-10s %8.1f ms %8.1f ms %5.1fx %8.1f ms %5.1fx   %s (%.2g)\n",                         \
+               nombres[maximo], (ACUMULADO_EXCLUSIVO == tipo) ? "exclusivo" : "inclusivo",                          \
+               seg ? "segmentos" : "", t_serial * 1e3, t1 * 1e3, t_serial / t1, th * 1e3, t_serial / th,            \
+               (maximo ? (0 == d) : (d < 1e-9)) ? "ok" : "DISTINTO", d);                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    free(copia);                                                                                                    \
+                                                                                                                    \
+    return ok;                                                                                                      \
+}
+
+PROBAR_DEFINE(int32_t, i32)
+PROBAR_DEFINE(int64_t, i64)
+PROBAR_DEFINE(double, f64)
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LENGTH;
+    size_t hilos = (argc > 2) ? strtoul(argv[2], NULL, 10) : 0;
+    int64_t *e = (int64_t *) malloc(n * sizeof(int64_t));
+    int64_t *s = (int64_t *) malloc(n * sizeof(int64_t));
+    int64_t *esperado = (int64_t *) malloc(n * sizeof(int64_t));
+    bool *inicio = (bool *) malloc(n * sizeof(bool));
+    unsigned long semilla = 88172645463325252UL;
+    int32_t *e32 = (int32_t *) e;
+    double *ed = (double *) e;
+    bool ok = true;
+
+    if ((0 == n) || (NULL == e) || (NULL == s) || (NULL == esperado) || (NULL == inicio)) {
+        fprintf(stderr, "Uso: %s [elementos > 0] [hilos]\n", argv[0]);
+        free(e);
+        free(s);
+        free(esperado);
+        free(inicio);
+        return EXIT_FAILURE;
+    }
+
+    /* touched once here, so the first measurement does not pay for the page faults */
+    memset(s, 0, n * sizeof(int64_t));
+    memset(esperado, 0, n * sizeof(int64_t));
+    for (size_t i = 0; i < n; ++i) {
+        inicio[i] = (0 == siguiente(&semilla) % SEGMENTO);
+    }
+
+    printf("%zu elementos, %zu hilos (0: uno por procesador)\n", n, hilos);
+    printf("  %-29s %11s %18s %18s\n", "", "ciclo", "1 hilo", "hilos");
+
+    /* big enough to wrap around */
+    for (size_t i = 0; i < n; ++i) {
+        e32[i] = (int32_t) (siguiente(&semilla) >> 40) - (1 << 23);
+    }
+    printf("\nint32_t\n");
+    ok = probar_i32(e32, (int32_t *) s, (int32_t *) esperado, inicio, n, hilos) && ok;
+
+    for (size_t i = 0; i < n; ++i) {
+        e[i] = (int64_t) (siguiente(&semilla) >> 1) - INT64_MAX / 2;
+    }
+    printf("\nint64_t\n");
+    ok = probar_i64(e, s, esperado, inicio, n, hilos) && ok;
+
+    /* mostly positive, so the relative error of the sum means something */
+    for (size_t i = 0; i < n; ++i) {
+        ed[i] = (double) (siguiente(&semilla) >> 11) / (1UL << 53) - 0.25;
+    }
+    ed[n / 2] = NAN;
+    printf("\ndouble (con un NaN en el medio)\n");
+    ok = probar_f64(ed, (double *) s, (double *) esperado, inicio, n, hilos) && ok;
+
+    free(e);
+    free(s);
+    free(esperado);
+    free(inicio);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
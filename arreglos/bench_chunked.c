@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "chunked.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Llena un archivo con chunked_uniform y lo recorre con chunked_sum, chunked_meand y chunked_maximo, mostrando el
+ * tiempo y los MB/s de cada recorrido. Para verificar los resultados vuelve a leer el arreglo con chunked_get de atrás
+ * hacia adelante (así cada bloque desaloja a otro), modifica un elemento de cada bloque, cierra el archivo y lo abre
+ * de nuevo de sólo lectura para comprobar que los cambios se escribieron.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -o bench_chunked bench_chunked.c chunked.c sum.c random.c \
+ *       ../punteros/src/meand_st.c -lm
+ * $ ./bench_chunked [archivo] [elementos] [elementos por bloque] [bloques en memoria]
+ */
+
+#define DEFAULT_PATH "chunked.bin"
+#define DEFAULT_LENGTH (1UL << 25)
+#define DEFAULT_CHUNK (1UL << 20)
+#define DEFAULT_CACHE 4
+#define LO -1.0
+#define HI 3.0
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static void mostrar(const char *nombre, double t, size_t n)
+{
+    printf("  %-16s %9.1f ms %9.1f MB/s\n", nombre, t * 1e3, n * sizeof(double) / 1048576.0 / t);
+}
+
+
+/* walks the chunks backwards with chunked_get, so the cache never has the next one */
+static bool recorrer(chunked_t *a, double *suma, double *max)
+{
+    size_t chunks = (chunked_length(a) + chunked_chunk_length(a) - 1) / chunked_chunk_length(a);
+    double *data;
+    size_t n;
+
+    *suma = 0;
+    *max = -INFINITY;
+    for (size_t c = chunks; c-- > 0;) {
+        data = chunked_get(a, c, false, &n);
+        if (NULL == data) {
+            return false;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            *suma += data[i];
+            *max = fmax(*max, data[i]);
+        }
+    }
+
+    return true;
+}
+
+
+static bool cerca(double x, double y)
+{
+    return fabs(x - y) <= 1e-9 * fmax(1, fabs(y));
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : DEFAULT_PATH;
+    size_t n = (argc > 2) ? strtoul(argv[2], NULL, 10) : DEFAULT_LENGTH;
+    size_t chunk = (argc > 3) ? strtoul(argv[3], NULL, 10) : DEFAULT_CHUNK;
+    size_t cache = (argc > 4) ? strtoul(argv[4], NULL, 10) : DEFAULT_CACHE;
+    chunked_t *a;
+    double suma;
+    double media;
+    double max;
+    double suma_ref;
+    double max_ref;
+    double *data;
+    size_t chunks;
+    size_t k;
+    double t;
+    bool ok = true;
+
+    if ((0 == n) || (0 == chunk) || (0 == cache)) {
+        fprintf(stderr, "Uso: %s [archivo] [elementos > 0] [elementos por bloque > 0] [bloques en memoria > 0]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    a = chunked_open(path, n, chunk, cache, true);
+    if (NULL == a) {
+        fprintf(stderr, "No se pudo abrir %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    printf("%zu elementos (%.1f MB), bloques de %zu, %zu en memoria\n\n", n, n * sizeof(double) / 1048576.0, chunk,
+           cache);
+    srand(1);
+    t = now();
+    ok = chunked_uniform(a, LO, HI) && ok;
+    mostrar("chunked_uniform", now() - t, n);
+    t = now();
+    ok = chunked_sum(a, &suma) && ok;
+    mostrar("chunked_sum", now() - t, n);
+    t = now();
+    ok = chunked_meand(a, &media) && ok;
+    mostrar("chunked_meand", now() - t, n);
+    t = now();
+    ok = chunked_maximo(a, &max) && ok;
+    mostrar("chunked_maximo", now() - t, n);
+
+    ok = recorrer(a, &suma_ref, &max_ref) && ok;
+    printf("\n  suma %.6f (al revés %.6f), media %.6f, máximo %.6f (al revés %.6f)\n", suma, suma_ref, media, max,
+           max_ref);
+    if (!cerca(suma, suma_ref) || !cerca(media, suma_ref / n) || (max != max_ref) || (max < LO) || (max >= HI)) {
+        fprintf(stderr, "Los recorridos no coinciden\n");
+        ok = false;
+    }
+
+    /* the last element of every chunk goes to HI: a new maximum that has to survive being evicted and closed */
+    chunks = (n + chunk - 1) / chunk;
+    for (size_t c = 0; c < chunks; ++c) {
+        data = chunked_get(a, c, true, &k);
+        if (NULL == data) {
+            ok = false;
+            break;
+        }
+        suma_ref += HI - data[k - 1];
+        data[k - 1] = HI;
+    }
+    ok = chunked_close(&a) && ok;
+
+    a = chunked_open(path, 0, chunk, cache, false);
+    if ((NULL == a) || (n != chunked_length(a))) {
+        fprintf(stderr, "No se pudo volver a abrir %s\n", path);
+        chunked_close(&a);
+        return EXIT_FAILURE;
+    }
+    ok = chunked_sum(a, &suma) && chunked_maximo(a, &max) && ok;
+    printf("  después de modificar y cerrar: suma %.6f (esperada %.6f), máximo %.6f\n", suma, suma_ref, max);
+    if (!cerca(suma, suma_ref) || (HI != max)) {
+        fprintf(stderr, "Los cambios no se escribieron\n");
+        ok = false;
+    }
+    ok = (NULL == chunked_get(a, 0, true, NULL)) && ok;
+    ok = chunked_close(&a) && ok;
+
+    remove(path);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,184 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "dispersa.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Producto matriz-vector denso contra CSR y CSC, para varias densidades.
+ *
+ * Para cada densidad se arma una matriz de n x n con esa fracción de elementos no nulos en posiciones al azar, se
+ * guarda densa y dispersa y se mide el tiempo de y = A x en cada forma (el promedio de varias repeticiones), la
+ * memoria que ocupa y la diferencia entre los resultados. También se comparan las trazas.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -pthread -o bench_dispersa bench_dispersa.c dispersa.c -lm
+ * $ ./bench_dispersa [n] [hilos]
+ */
+
+#define DEFAULT_N 4000
+#define MIN_ELEMENTS (1UL << 28)
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/* the dense path at its best: DISPERSA_LANES partial sums per row so that it vectorizes too */
+static void producto_denso(const double *a, size_t n, const double x[], double y[])
+{
+    double s[DISPERSA_LANES];
+    size_t j;
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t l = 0; l < DISPERSA_LANES; ++l) {
+            s[l] = 0;
+        }
+        for (j = 0; j + DISPERSA_LANES <= n; j += DISPERSA_LANES) {
+            for (size_t l = 0; l < DISPERSA_LANES; ++l) {
+                s[l] += a[i * n + j + l] * x[j + l];
+            }
+        }
+        for (; j < n; ++j) {
+            s[0] += a[i * n + j] * x[j];
+        }
+        y[i] = (s[0] + s[2]) + (s[1] + s[3]);
+    }
+}
+
+
+static double diferencia(const double a[], const double b[], size_t n)
+{
+    double d = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        d = fmax(d, fabs(a[i] - b[i]) / fmax(fabs(a[i]), 1e-300));
+    }
+
+    return d;
+}
+
+
+/* ms per product, repeating until about MIN_ELEMENTS elements were read */
+static double medir(const dispersa_t *m, const double *denso, size_t n, const double x[], double y[], size_t hilos)
+{
+    size_t elementos = (NULL != m) ? m->nnz + n : n * n;
+    size_t reps = MIN_ELEMENTS / elementos + 1;
+    double t = now();
+
+    for (size_t r = 0; r < reps; ++r) {
+        if (NULL != m) {
+            dispersa_producto(m, x, y, hilos);
+        } else {
+            producto_denso(denso, n, x, y);
+        }
+    }
+
+    return (now() - t) / reps * 1e3;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_N;
+    size_t hilos = (argc > 2) ? strtoul(argv[2], NULL, 10) : 0;
+    const double densidades[] = {0.0001, 0.001, 0.01, 0.1, 0.5};
+    unsigned long semilla = 88172645463325252UL;
+    double *a = (double *) malloc(n * n * sizeof(double));
+    double *x = (double *) malloc(n * sizeof(double));
+    double *y = (double *) malloc(n * sizeof(double));
+    double *z = (double *) malloc(n * sizeof(double));
+    triplete_t *t = (triplete_t *) malloc(n * n * sizeof(triplete_t));
+    dispersa_t csr;
+    dispersa_t csc;
+    size_t nnz;
+    double traza;
+    double ms[4];
+    double error[3];
+
+    if ((0 == n) || (NULL == a) || (NULL == x) || (NULL == y) || (NULL == z) || (NULL == t)) {
+        fprintf(stderr, "Uso: %s [n > 0] [hilos]\n", argv[0]);
+        free(a);
+        free(x);
+        free(y);
+        free(z);
+        free(t);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = (double) (siguiente(&semilla) >> 11) / (1UL << 53) - 0.5;
+    }
+
+    printf("n = %zu, denso: %.1f MB\n\n", n, n * n * sizeof(double) / 1e6);
+    printf("%9s %12s %10s %10s %10s %10s %10s %10s %9s\n", "densidad", "no nulos", "MB", "denso ms", "CSR 1 ms",
+           "CSR ms", "CSC ms", "speedup", "error");
+    for (size_t d = 0; d < sizeof(densidades) / sizeof(densidades[0]); ++d) {
+        nnz = 0;
+        traza = 0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                a[i * n + j] = 0;
+                if ((double) (siguiente(&semilla) >> 11) / (1UL << 53) < densidades[d]) {
+                    a[i * n + j] = (double) (siguiente(&semilla) >> 11) / (1UL << 53) + 0.5;
+                    t[nnz++] = (triplete_t) {i, j, a[i * n + j]};
+                }
+            }
+            traza += a[i * n + i];
+        }
+
+        /* the triples go in reverse, so the builder really has to sort them */
+        for (size_t i = 0; i < nnz / 2; ++i) {
+            triplete_t aux = t[i];
+            t[i] = t[nnz - 1 - i];
+            t[nnz - 1 - i] = aux;
+        }
+        if (!dispersa_desde_tripletes(&csr, n, n, t, nnz, DISPERSA_CSR) ||
+            !dispersa_convertir(&csr, DISPERSA_CSC, &csc)) {
+            fprintf(stderr, "Not enough memory\n");
+            break;
+        }
+
+        ms[0] = medir(NULL, a, n, x, z, hilos);
+        ms[1] = medir(&csr, NULL, n, x, y, 1);
+        error[0] = diferencia(z, y, n);
+        ms[2] = medir(&csr, NULL, n, x, y, hilos);
+        error[1] = diferencia(z, y, n);
+        ms[3] = medir(&csc, NULL, n, x, y, hilos);
+        error[2] = diferencia(z, y, n);
+
+        printf("%9g %12zu %10.2f %10.3f %10.3f %10.3f %10.3f %10.1f %9.1e%s\n", densidades[d], csr.nnz,
+               ((n + 1) * sizeof(size_t) + csr.nnz * (sizeof(uint32_t) + sizeof(double))) / 1e6, ms[0], ms[1],
+               ms[2], ms[3], ms[0] / ms[2], fmax(error[0], fmax(error[1], error[2])),
+               (traza == dispersa_traza(&csr) && traza == dispersa_traza(&csc)) ? "" : "  (trazas distintas)");
+
+        dispersa_free(&csr);
+        dispersa_free(&csc);
+    }
+
+    free(a);
+    free(x);
+    free(y);
+    free(z);
+    free(t);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,525 @@
+#define _GNU_SOURCE
+
+#include <linux/perf_event.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * memdir_matr.c, memdir_cube.c y array_pos.c muestran dónde queda cada elemento; este programa mide qué diferencia
+ * hace recorrerlos en un orden u otro. Cada recorrido suma los mismos datos de distintas formas:
+ *
+ * -   una matriz double m[filas][COLUMNAS] por filas (memoria contigua) y por columnas (saltos de COLUMNAS * 8 bytes);
+ * -   un arreglo recorrido con distintos pasos, haciendo siempre la misma cantidad de sumas;
+ * -   una matriz float ** (como en ptr_array_2.c) con las filas en cualquier lugar de la memoria, por filas y por
+ *     columnas, contra float m[][] contigua (por columnas, todos los elementos de una columna de la contigua caen en el
+ *     mismo conjunto de la cache, porque están a 16 KB exactos; las filas de malloc no);
+ * -   una lista enlazada recorrida en el orden en que está en memoria y en un orden al azar (cada nodo en su línea de
+ *     cache: cada paso espera al anterior);
+ * -   el promedio de un campo de registros tipo estudiante_t guardados como arreglo de estructuras (AoS), como
+ *     estructura de arreglos (SoA) y como arreglo de punteros a estructuras (estudiante_t **).
+ *
+ * Además del tiempo, lee los contadores del procesador con perf_event_open (sólo Linux): ciclos y fallos de L1 de
+ * datos, del último nivel de cache (LLC) y de la TLB de datos, por elemento. Si el sistema no los permite (por
+ * ejemplo con /proc/sys/kernel/perf_event_paranoid en 3, o en algunas máquinas virtuales) se muestra un guion.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O2 -o bench_disposicion bench_disposicion.c
+ * $ ./bench_disposicion [MB por recorrido]
+ */
+
+#define DEFAULT_MB 32
+#define COLUMNAS 4096
+#define LINEA 64
+
+#define CACHE(cache, op, resultado)                                                                                 \
+    (PERF_COUNT_HW_CACHE_##cache | (PERF_COUNT_HW_CACHE_OP_##op << 8) | (PERF_COUNT_HW_CACHE_RESULT_##resultado << 16))
+
+
+typedef struct {
+    const char *nombre;
+    uint32_t tipo;
+    uint64_t config;
+    int fd;
+} contador_t;
+
+
+static contador_t contadores[] = {
+    {"ciclos", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1},
+    {"L1d", PERF_TYPE_HW_CACHE, CACHE(L1D, READ, MISS), -1},
+    {"LLC", PERF_TYPE_HW_CACHE, CACHE(LL, READ, MISS), -1},
+    {"dTLB", PERF_TYPE_HW_CACHE, CACHE(DTLB, READ, MISS), -1},
+};
+
+#define N_CONTADORES (sizeof(contadores) / sizeof(contadores[0]))
+
+
+typedef struct nodo {
+    struct nodo *siguiente;
+    double valor;
+    char relleno[LINEA - sizeof(struct nodo *) - sizeof(double)];
+} nodo_t;
+
+
+/* como estudiante_t, con los datos adentro: 64 bytes, de los que el promedio usa 4 */
+typedef struct {
+    char nombre[24];
+    char apellido[24];
+    unsigned padron;
+    float promedio;
+    unsigned materias;
+    unsigned anio;
+} registro_t;
+
+
+typedef struct {
+    size_t n;
+    size_t filas;
+    double *m;
+    size_t paso;
+    float **filas_ptr;
+    float *filas_contiguas;
+    size_t filas_f;
+    nodo_t *nodos;
+    nodo_t *en_orden;
+    nodo_t *al_azar;
+    size_t n_nodos;
+    registro_t *aos;
+    float *soa;
+    registro_t **punteros;
+    size_t n_registros;
+} datos_t;
+
+
+typedef double (*recorrido_fn_t)(const datos_t *d);
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/* counts only this process in user space, on whatever CPU it runs */
+static int abrir_contador(uint32_t tipo, uint64_t config)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = tipo;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+
+/* if there are more counters than hardware registers the kernel takes turns: the count is scaled to the full time */
+static double leer_contador(int fd)
+{
+    uint64_t v[3];
+
+    if ((fd < 0) || (read(fd, v, sizeof(v)) != (ssize_t) sizeof(v)) || (0 == v[2])) {
+        return -1;
+    }
+
+    return (double) v[0] * ((double) v[1] / (double) v[2]);
+}
+
+
+static void medir(const char *nombre, recorrido_fn_t fn, const datos_t *d, size_t elementos)
+{
+    volatile double sink;
+    double valores[N_CONTADORES];
+    double t;
+
+    /* once to bring in what fits in the caches and the TLB, as any repeated traversal would find it */
+    sink = fn(d);
+
+    for (size_t c = 0; c < N_CONTADORES; ++c) {
+        if (contadores[c].fd >= 0) {
+            ioctl(contadores[c].fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(contadores[c].fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    t = now();
+    sink = fn(d);
+    t = now() - t;
+    for (size_t c = 0; c < N_CONTADORES; ++c) {
+        if (contadores[c].fd >= 0) {
+            ioctl(contadores[c].fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        valores[c] = leer_contador(contadores[c].fd);
+    }
+    (void) sink;
+
+    printf("%-28s %9.2f ms %8.2f ns", nombre, t * 1e3, t / elementos * 1e9);
+    for (size_t c = 0; c < N_CONTADORES; ++c) {
+        if (valores[c] < 0) {
+            printf(" %8s", "-");
+        } else {
+            printf(" %8.3f", valores[c] / elementos);
+        }
+    }
+    printf("\n");
+}
+
+
+static double por_filas(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t i = 0; i < d->filas; ++i) {
+        for (size_t j = 0; j < COLUMNAS; ++j) {
+            s += d->m[i * COLUMNAS + j];
+        }
+    }
+
+    return s;
+}
+
+
+static double por_columnas(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t j = 0; j < COLUMNAS; ++j) {
+        for (size_t i = 0; i < d->filas; ++i) {
+            s += d->m[i * COLUMNAS + j];
+        }
+    }
+
+    return s;
+}
+
+
+/* every element once, in `paso` passes: element k, k + paso, k + 2 paso, ... */
+static double con_paso(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t k = 0; k < d->paso; ++k) {
+        for (size_t i = k; i < d->n; i += d->paso) {
+            s += d->m[i];
+        }
+    }
+
+    return s;
+}
+
+
+static double punteros_por_filas(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t i = 0; i < d->filas_f; ++i) {
+        for (size_t j = 0; j < COLUMNAS; ++j) {
+            s += d->filas_ptr[i][j];
+        }
+    }
+
+    return s;
+}
+
+
+static double punteros_por_columnas(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t j = 0; j < COLUMNAS; ++j) {
+        for (size_t i = 0; i < d->filas_f; ++i) {
+            s += d->filas_ptr[i][j];
+        }
+    }
+
+    return s;
+}
+
+
+static double contigua_por_filas(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t i = 0; i < d->filas_f; ++i) {
+        for (size_t j = 0; j < COLUMNAS; ++j) {
+            s += d->filas_contiguas[i * COLUMNAS + j];
+        }
+    }
+
+    return s;
+}
+
+
+static double contigua_por_columnas(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t j = 0; j < COLUMNAS; ++j) {
+        for (size_t i = 0; i < d->filas_f; ++i) {
+            s += d->filas_contiguas[i * COLUMNAS + j];
+        }
+    }
+
+    return s;
+}
+
+
+static double lista_en_orden(const datos_t *d)
+{
+    const nodo_t *p = d->en_orden;
+    double s = 0;
+
+    for (size_t i = 0; i < d->n_nodos; ++i) {
+        s += p->valor;
+        p = p->siguiente;
+    }
+
+    return s;
+}
+
+
+/* the random ring lives in the padding: the same nodes, so both lists touch exactly the same memory */
+static double lista_al_azar(const datos_t *d)
+{
+    const nodo_t *p = d->al_azar;
+    const nodo_t *q;
+    double s = 0;
+
+    for (size_t i = 0; i < d->n_nodos; ++i) {
+        s += p->valor;
+        memcpy(&q, p->relleno, sizeof(q));
+        p = q;
+    }
+
+    return s;
+}
+
+
+static double promedio_aos(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t i = 0; i < d->n_registros; ++i) {
+        s += d->aos[i].promedio;
+    }
+
+    return s / d->n_registros;
+}
+
+
+static double promedio_soa(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t i = 0; i < d->n_registros; ++i) {
+        s += d->soa[i];
+    }
+
+    return s / d->n_registros;
+}
+
+
+static double promedio_punteros(const datos_t *d)
+{
+    double s = 0;
+
+    for (size_t i = 0; i < d->n_registros; ++i) {
+        s += d->punteros[i]->promedio;
+    }
+
+    return s / d->n_registros;
+}
+
+
+static void mezclar(void *v[], size_t n, unsigned long *semilla)
+{
+    void *aux;
+    size_t j;
+
+    for (size_t i = n - 1; i > 0; --i) {
+        j = siguiente(semilla) % (i + 1);
+        aux = v[i];
+        v[i] = v[j];
+        v[j] = aux;
+    }
+}
+
+
+static bool preparar(datos_t *d, size_t bytes)
+{
+    unsigned long semilla = 88172645463325252UL;
+    nodo_t **orden;
+    bool ok = true;
+
+    memset(d, 0, sizeof(*d));
+    d->filas = bytes / (COLUMNAS * sizeof(double));
+    d->n = d->filas * COLUMNAS;
+    d->filas_f = bytes / (COLUMNAS * sizeof(float));
+    d->n_nodos = bytes / sizeof(nodo_t);
+    d->n_registros = bytes / sizeof(registro_t);
+
+    d->m = (double *) malloc(d->n * sizeof(double));
+    d->filas_ptr = (float **) calloc(d->filas_f, sizeof(float *));
+    d->filas_contiguas = (float *) malloc(d->filas_f * COLUMNAS * sizeof(float));
+    d->nodos = (nodo_t *) malloc(d->n_nodos * sizeof(nodo_t));
+    orden = (nodo_t **) malloc(d->n_nodos * sizeof(nodo_t *));
+    d->aos = (registro_t *) malloc(d->n_registros * sizeof(registro_t));
+    d->soa = (float *) malloc(d->n_registros * sizeof(float));
+    d->punteros = (registro_t **) calloc(d->n_registros, sizeof(registro_t *));
+    if ((NULL == d->m) || (NULL == d->filas_ptr) || (NULL == d->filas_contiguas) || (NULL == d->nodos) ||
+        (NULL == orden) || (NULL == d->aos) || (NULL == d->soa) || (NULL == d->punteros) || (0 == d->filas) ||
+        (0 == d->n_nodos)) {
+        free(orden);
+        return false;
+    }
+
+    for (size_t i = 0; i < d->n; ++i) {
+        d->m[i] = (double) (i % 1000);
+    }
+
+    /* one malloc per row, like a float ** built row by row; then the rows are shuffled */
+    for (size_t i = 0; ok && (i < d->filas_f); ++i) {
+        d->filas_ptr[i] = (float *) malloc(COLUMNAS * sizeof(float));
+        ok = (NULL != d->filas_ptr[i]);
+        for (size_t j = 0; ok && (j < COLUMNAS); ++j) {
+            d->filas_ptr[i][j] = d->filas_contiguas[i * COLUMNAS + j] = (float) (j % 100);
+        }
+    }
+    if (ok) {
+        mezclar((void **) d->filas_ptr, d->filas_f, &semilla);
+    }
+
+    for (size_t i = 0; i < d->n_nodos; ++i) {
+        d->nodos[i].valor = 1;
+        d->nodos[i].siguiente = &d->nodos[(i + 1) % d->n_nodos];
+        orden[i] = &d->nodos[i];
+    }
+    d->en_orden = d->nodos;
+    /* a second ring through the same nodes, in random order, kept apart from the first one */
+    mezclar((void **) orden, d->n_nodos, &semilla);
+    d->al_azar = orden[0];
+    for (size_t i = 0; i < d->n_nodos; ++i) {
+        memcpy(orden[i]->relleno, &orden[(i + 1) % d->n_nodos], sizeof(nodo_t *));
+    }
+    free(orden);
+
+    for (size_t i = 0; ok && (i < d->n_registros); ++i) {
+        memset(&d->aos[i], 0, sizeof(registro_t));
+        snprintf(d->aos[i].nombre, sizeof(d->aos[i].nombre), "Nombre %u", (unsigned) i);
+        d->aos[i].padron = (unsigned) (100000 + i);
+        d->aos[i].promedio = (float) (4 + i % 7);
+        d->soa[i] = d->aos[i].promedio;
+        d->punteros[i] = (registro_t *) malloc(sizeof(registro_t));
+        ok = (NULL != d->punteros[i]);
+        if (ok) {
+            *d->punteros[i] = d->aos[i];
+        }
+    }
+    if (ok) {
+        mezclar((void **) d->punteros, d->n_registros, &semilla);
+    }
+
+    return ok;
+}
+
+
+static void liberar(datos_t *d)
+{
+    for (size_t i = 0; (NULL != d->filas_ptr) && (i < d->filas_f); ++i) {
+        free(d->filas_ptr[i]);
+    }
+    for (size_t i = 0; (NULL != d->punteros) && (i < d->n_registros); ++i) {
+        free(d->punteros[i]);
+    }
+    free(d->m);
+    free(d->filas_ptr);
+    free(d->filas_contiguas);
+    free(d->nodos);
+    free(d->aos);
+    free(d->soa);
+    free(d->punteros);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t mb = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_MB;
+    const size_t pasos[] = {1, 2, 8, 16, 512};
+    char nombre[64];
+    datos_t d;
+    bool alguno = false;
+
+    if (0 == mb) {
+        fprintf(stderr, "Uso: %s [MB por recorrido > 0]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!preparar(&d, mb << 20)) {
+        fprintf(stderr, "No hay memoria para %zu MB por recorrido\n", mb);
+        liberar(&d);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t c = 0; c < N_CONTADORES; ++c) {
+        contadores[c].fd = abrir_contador(contadores[c].tipo, contadores[c].config);
+        alguno = alguno || (contadores[c].fd >= 0);
+    }
+    if (!alguno) {
+        fprintf(stderr, "perf_event_open no está disponible: sólo se mide el tiempo\n");
+    }
+
+    printf("%zu MB por recorrido; contadores por elemento\n\n", mb);
+    printf("%-28s %12s %11s", "recorrido", "tiempo", "por elem.");
+    for (size_t c = 0; c < N_CONTADORES; ++c) {
+        printf(" %8s", contadores[c].nombre);
+    }
+    printf("\n");
+
+    medir("double[][] por filas", por_filas, &d, d.n);
+    medir("double[][] por columnas", por_columnas, &d, d.n);
+    for (size_t p = 0; p < sizeof(pasos) / sizeof(pasos[0]); ++p) {
+        d.paso = pasos[p];
+        snprintf(nombre, sizeof(nombre), "paso %zu (%zu bytes)", pasos[p], pasos[p] * sizeof(double));
+        medir(nombre, con_paso, &d, d.n);
+    }
+    medir("float ** por filas", punteros_por_filas, &d, d.filas_f * COLUMNAS);
+    medir("float ** por columnas", punteros_por_columnas, &d, d.filas_f * COLUMNAS);
+    medir("float[][] por filas", contigua_por_filas, &d, d.filas_f * COLUMNAS);
+    medir("float[][] por columnas", contigua_por_columnas, &d, d.filas_f * COLUMNAS);
+    medir("lista en orden", lista_en_orden, &d, d.n_nodos);
+    medir("lista al azar", lista_al_azar, &d, d.n_nodos);
+    medir("promedio AoS", promedio_aos, &d, d.n_registros);
+    medir("promedio SoA", promedio_soa, &d, d.n_registros);
+    medir("promedio estudiante_t **", promedio_punteros, &d, d.n_registros);
+
+    for (size_t c = 0; c < N_CONTADORES; ++c) {
+        if (contadores[c].fd >= 0) {
+            close(contadores[c].fd);
+        }
+    }
+    liberar(&d);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,270 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "lote.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Calcula la traza de muchas matrices de n x n con lote_traza (matrices contiguas e intercaladas) y con
+ * lote_traza_ptr, con un hilo y con uno por procesador, y compara el tiempo con copiar cada matriz a un
+ * double[200][200] y llamar a traza (traza.c). Todas las versiones suman en el mismo orden, así que deben dar
+ * exactamente lo mismo que traza. Verifica además lote_suma_diagonal y lote_suma_diagonal_ptr contra la suma hecha a
+ * mano, y que lote_escalar_diagonal y lote_escalar_diagonal_ptr dejen las dos disposiciones iguales.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -pthread -o bench_lote bench_lote.c lote.c traza.c
+ * $ ./bench_lote [matrices] [n]
+ */
+
+#define DEFAULT_CANTIDAD (1UL << 19)
+#define DEFAULT_N 4
+#define MAX_N 200
+#define REPETICIONES 5
+
+/* arreglos/traza.c */
+double traza(double mat[][200], size_t n);
+
+
+typedef enum {
+    CONTIGUAS,
+    INTERCALADAS,
+    PUNTEROS,
+} disposicion_t;
+
+
+typedef struct {
+    lote_t contiguas;
+    lote_t intercaladas;
+    float ***matrices;
+    size_t cantidad;
+    size_t n;
+} datos_t;
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/* element (i, j) of matrix b, in the contiguous layout */
+static float elemento(const datos_t *d, size_t b, size_t i, size_t j)
+{
+    return d->contiguas.data[(b * d->n + i) * d->n + j];
+}
+
+
+/* what lote replaces: every matrix copied to the only shape traza accepts */
+static void trazas_traza(const datos_t *d, double trazas[])
+{
+    static double m[MAX_N][MAX_N];
+
+    for (size_t b = 0; b < d->cantidad; ++b) {
+        for (size_t i = 0; i < d->n; ++i) {
+            for (size_t j = 0; j < d->n; ++j) {
+                m[i][j] = elemento(d, b, i, j);
+            }
+        }
+        trazas[b] = traza(m, d->n);
+    }
+}
+
+
+static bool trazas_lote(const datos_t *d, disposicion_t disposicion, double trazas[], size_t hilos)
+{
+    switch (disposicion) {
+    case CONTIGUAS:
+        return lote_traza(&d->contiguas, trazas, hilos);
+    case INTERCALADAS:
+        return lote_traza(&d->intercaladas, trazas, hilos);
+    case PUNTEROS:
+        return lote_traza_ptr((float **const *) d->matrices, d->cantidad, d->n, trazas, hilos);
+    }
+
+    return false;
+}
+
+
+static bool iguales(const char *nombre, const double v[], const double esperado[], size_t n)
+{
+    for (size_t b = 0; b < n; ++b) {
+        if (v[b] != esperado[b]) {
+            fprintf(stderr, "%s: la matriz %zu da %.17g y debería dar %.17g\n", nombre, b, v[b], esperado[b]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static bool probar_suma_diagonal(const datos_t *d, long k, double sumas[], double esperado[])
+{
+    size_t fila = (k < 0) ? (size_t) (-k) : 0;
+    size_t columna = (k > 0) ? (size_t) k : 0;
+    bool ok = true;
+
+    for (size_t b = 0; b < d->cantidad; ++b) {
+        esperado[b] = 0;
+        for (size_t i = 0; (fila + i < d->n) && (columna + i < d->n); ++i) {
+            esperado[b] += elemento(d, b, fila + i, columna + i);
+        }
+    }
+
+    ok = lote_suma_diagonal(&d->intercaladas, k, sumas, 0)
+         && iguales("lote_suma_diagonal", sumas, esperado, d->cantidad) && ok;
+    ok = lote_suma_diagonal_ptr((float **const *) d->matrices, d->cantidad, d->n, d->n, k, sumas, 0)
+         && iguales("lote_suma_diagonal_ptr", sumas, esperado, d->cantidad) && ok;
+
+    return ok;
+}
+
+
+/* scales the contiguous matrices through their row pointers and the interleaved ones directly */
+static bool probar_escalar(datos_t *d, unsigned long *semilla)
+{
+    float *factores = (float *) malloc(d->cantidad * sizeof(float));
+    float *diagonal = (float *) malloc(d->cantidad * d->n * sizeof(float));
+    const size_t n = d->n;
+    bool ok = (NULL != factores) && (NULL != diagonal);
+
+    for (size_t b = 0; ok && (b < d->cantidad); ++b) {
+        factores[b] = (float) (siguiente(semilla) >> 40) / (1UL << 24) * 4;
+        for (size_t i = 0; i < n; ++i) {
+            diagonal[b * n + i] = elemento(d, b, i, i);
+        }
+    }
+
+    ok = ok && lote_escalar_diagonal(&d->intercaladas, factores, 0)
+         && lote_escalar_diagonal_ptr((float **const *) d->matrices, d->cantidad, n, factores, 0);
+
+    for (size_t b = 0; ok && (b < d->cantidad); ++b) {
+        for (size_t i = 0; ok && (i < n); ++i) {
+            for (size_t j = 0; ok && (j < n); ++j) {
+                ok = (elemento(d, b, i, j) == d->intercaladas.data[(i * n + j) * d->cantidad + b])
+                     && ((i != j) || (elemento(d, b, i, i) == diagonal[b * n + i] * factores[b]));
+                if (!ok) {
+                    fprintf(stderr, "lote_escalar_diagonal: la matriz %zu difiere en (%zu, %zu)\n", b, i, j);
+                }
+            }
+        }
+    }
+
+    free(factores);
+    free(diagonal);
+
+    return ok;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *nombres[] = {"lote_traza (contiguas)", "lote_traza (intercaladas)", "lote_traza_ptr"};
+    const size_t hilos[] = {1, 0};
+    size_t cantidad = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_CANTIDAD;
+    size_t n = (argc > 2) ? strtoul(argv[2], NULL, 10) : DEFAULT_N;
+    unsigned long semilla = 88172645463325252UL;
+    datos_t d = {.cantidad = cantidad, .n = n};
+    float *contiguas = NULL;
+    float *intercaladas = NULL;
+    float **filas = NULL;
+    double *esperado = NULL;
+    double *trazas = NULL;
+    double t;
+    double t_traza;
+    bool ok = true;
+
+    if ((0 == cantidad) || (0 == n) || (n > MAX_N)) {
+        fprintf(stderr, "Uso: %s [matrices > 0] [n (1 a %d)]\n", argv[0], MAX_N);
+        return EXIT_FAILURE;
+    }
+
+    contiguas = (float *) malloc(cantidad * n * n * sizeof(float));
+    intercaladas = (float *) malloc(cantidad * n * n * sizeof(float));
+    filas = (float **) malloc(cantidad * n * sizeof(float *));
+    d.matrices = (float ***) malloc(cantidad * sizeof(float **));
+    esperado = (double *) malloc(cantidad * sizeof(double));
+    trazas = (double *) malloc(cantidad * sizeof(double));
+    if ((NULL == contiguas) || (NULL == intercaladas) || (NULL == filas) || (NULL == d.matrices)
+        || (NULL == esperado) || (NULL == trazas)) {
+        fprintf(stderr, "No hay memoria\n");
+        free(contiguas);
+        free(intercaladas);
+        free(filas);
+        free(d.matrices);
+        free(esperado);
+        free(trazas);
+        return EXIT_FAILURE;
+    }
+
+    /* the same matrices in the three layouts; values with 24 bits, so every float is exact */
+    lote_init(&d.contiguas, contiguas, cantidad, n, n);
+    lote_init_intercalado(&d.intercaladas, intercaladas, cantidad, n, n);
+    for (size_t b = 0; b < cantidad; ++b) {
+        d.matrices[b] = filas + b * n;
+        for (size_t i = 0; i < n; ++i) {
+            filas[b * n + i] = contiguas + (b * n + i) * n;
+            for (size_t j = 0; j < n; ++j) {
+                contiguas[(b * n + i) * n + j] = (float) (siguiente(&semilla) >> 40) / (1UL << 24);
+                intercaladas[(i * n + j) * cantidad + b] = contiguas[(b * n + i) * n + j];
+            }
+        }
+    }
+
+    printf("%zu matrices de %zu x %zu\n\n", cantidad, n, n);
+    printf("%-26s %6s %10s %14s\n", "", "hilos", "tiempo", "matrices/s");
+
+    t = now();
+    for (int k = 0; k < REPETICIONES; ++k) {
+        trazas_traza(&d, esperado);
+    }
+    t_traza = (now() - t) / REPETICIONES;
+    printf("%-26s %6d %7.2f ms %14.3g\n", "traza (copiando)", 1, t_traza * 1e3, cantidad / t_traza);
+
+    for (disposicion_t disposicion = CONTIGUAS; disposicion <= PUNTEROS; ++disposicion) {
+        for (size_t h = 0; h < sizeof(hilos) / sizeof(hilos[0]); ++h) {
+            t = now();
+            for (int k = 0; k < REPETICIONES; ++k) {
+                ok = trazas_lote(&d, disposicion, trazas, hilos[h]) && ok;
+            }
+            t = (now() - t) / REPETICIONES;
+            printf("%-26s %6s %7.2f ms %14.3g\n", nombres[disposicion], (1 == hilos[h]) ? "1" : "todos", t * 1e3,
+                   cantidad / t);
+            ok = iguales(nombres[disposicion], trazas, esperado, cantidad) && ok;
+        }
+    }
+
+    /* the diagonals right above and below the main one, if the matrices have them */
+    if (n > 1) {
+        ok = probar_suma_diagonal(&d, 1, trazas, esperado) && ok;
+        ok = probar_suma_diagonal(&d, -1, trazas, esperado) && ok;
+    }
+    ok = probar_escalar(&d, &semilla) && ok;
+
+    puts(ok ? "\nTodas las verificaciones pasaron" : "\nAlguna verificación falló");
+
+    free(contiguas);
+    free(intercaladas);
+    free(filas);
+    free(d.matrices);
+    free(esperado);
+    free(trazas);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
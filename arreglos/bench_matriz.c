@@ -0,0 +1,144 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "matriz.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Multiplica, traspone, calcula la traza, el determinante y la inversa de millones de matrices de 2 x 2 hasta 8 x 8,
+ * en lotes de POOL matrices que se recorren una y otra vez (para medir el cálculo y no la memoria). La columna
+ * "control" resume los resultados: tiene que dar lo mismo (o casi) compilando con y sin -DMATRIZ_GENERICA, que
+ * usa los ciclos comunes en lugar de las versiones desenrolladas. También verifica que A A^-1 sea la identidad.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -o bench_matriz bench_matriz.c matriz.c -lm
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -DMATRIZ_GENERICA -o bench_matriz_gen bench_matriz.c matriz.c -lm
+ * $ ./bench_matriz [matrices]
+ */
+
+#define DEFAULT_MATRICES (1UL << 22)
+#define POOL 1024
+#define N_MAX MATRIZ_MAX_DESENROLLADA
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+static double suma(const double v[], size_t n)
+{
+    double s = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        s += v[i];
+    }
+
+    return s;
+}
+
+
+static void reportar(const char *nombre, double t, size_t matrices, double control)
+{
+    printf("  %-14s %8.2f ns/matriz   control %.12g\n", nombre, t / matrices * 1e9, control);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t matrices = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_MATRICES;
+    static double a[POOL * N_MAX * N_MAX];
+    static double b[POOL * N_MAX * N_MAX];
+    static double c[POOL * N_MAX * N_MAX];
+    static double r[POOL];
+    static bool invertible[POOL];
+    unsigned long semilla = 88172645463325252UL;
+    size_t lotes;
+    size_t n2;
+    double producto[N_MAX * N_MAX];
+    double error;
+    double t;
+
+    if (matrices < POOL) {
+        fprintf(stderr, "Uso: %s [matrices >= %d]\n", argv[0], POOL);
+        return EXIT_FAILURE;
+    }
+    lotes = matrices / POOL;
+    matrices = lotes * POOL;
+
+    printf("%zu matrices de cada tamaño, en lotes de %d\n", matrices, POOL);
+
+    for (size_t n = 2; n <= N_MAX; ++n) {
+        n2 = n * n;
+        /* diagonal dominant, so every one has an inverse */
+        for (size_t i = 0; i < POOL * n2; ++i) {
+            a[i] = (double) (siguiente(&semilla) >> 11) / (1UL << 53) - 0.5;
+            b[i] = (double) (siguiente(&semilla) >> 11) / (1UL << 53) - 0.5;
+            if (i % n2 % (n + 1) == 0) {
+                a[i] += n;
+            }
+        }
+
+        printf("\n%zu x %zu\n", n, n);
+
+        t = now();
+        for (size_t l = 0; l < lotes; ++l) {
+            matriz_multiplicar_lote(c, a, b, n, POOL);
+        }
+        reportar("multiplicar", now() - t, matrices, suma(c, POOL * n2));
+
+        t = now();
+        for (size_t l = 0; l < lotes; ++l) {
+            matriz_trasponer_lote(c, a, n, POOL);
+        }
+        reportar("trasponer", now() - t, matrices, suma(c, POOL * n2));
+
+        t = now();
+        for (size_t l = 0; l < lotes; ++l) {
+            matriz_traza_lote(r, a, n, POOL);
+        }
+        reportar("traza", now() - t, matrices, suma(r, POOL));
+
+        t = now();
+        for (size_t l = 0; l < lotes; ++l) {
+            matriz_determinante_lote(r, a, n, POOL);
+        }
+        reportar("determinante", now() - t, matrices, suma(r, POOL));
+
+        t = now();
+        for (size_t l = 0; l < lotes; ++l) {
+            matriz_inversa_lote(c, a, n, POOL, invertible);
+        }
+        reportar("inversa", now() - t, matrices, suma(c, POOL * n2));
+
+        error = 0;
+        for (size_t m = 0; m < POOL; ++m) {
+            matriz_multiplicar(producto, a + m * n2, c + m * n2, n, n, n);
+            for (size_t i = 0; i < n2; ++i) {
+                error = fmax(error, fabs(producto[i] - (i % (n + 1) == 0)));
+            }
+            error = invertible[m] ? error : INFINITY;
+        }
+        printf("  |A A^-1 - I| <= %.3g\n", error);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "reducido.h"
+#include "../punteros/src/meand.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Guarda mediciones simuladas (alrededor de 20, con 3 cifras significativas) como double y en cada formato de
+ * reducido.h, y compara cuánto tardan sum, meand y sumar sobre cada uno, cuánta memoria ocupan y cuánto se pierde al
+ * guardarlos (el mayor error relativo de un elemento, y el de la suma respecto de la suma de los double).
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -o bench_reducido bench_reducido.c reducido.c sum.c sumar.c \
+ *       ../punteros/src/meand_st.c -lm
+ * $ ./bench_reducido [elementos]
+ */
+
+#define DEFAULT_LENGTH (1UL << 24)
+#define REPETICIONES 5
+#define BLOQUE 4096
+
+/* arreglos/sum.c y arreglos/sumar.c */
+double sum(const double v[], size_t n);
+void sumar(double lhs[], const double rhs1[], const double rhs2[], size_t n);
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/* largest relative error of a stored element, read back in blocks */
+static double error_elementos(const reducido_t *r, const double v[])
+{
+    double bloque[BLOQUE];
+    double error = 0;
+    size_t n;
+
+    for (size_t i = 0; i < r->n; i += n) {
+        n = (r->n - i < BLOQUE) ? r->n - i : BLOQUE;
+        reducido_leer(bloque, r, i, n);
+        for (size_t j = 0; j < n; ++j) {
+            error = fmax(error, fabs(bloque[j] - v[i + j]) / fabs(v[i + j]));
+        }
+    }
+
+    return error;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LENGTH;
+    const char *nombres[] = {"float", "half (F16)", "bfloat16"};
+    double *v = (double *) malloc(n * sizeof(double));
+    double *w = (double *) malloc(n * sizeof(double));
+    unsigned long semilla = 88172645463325252UL;
+    reducido_t r;
+    reducido_t s;
+    double suma_exacta;
+    double suma;
+    double media;
+    double t_sum;
+    double t_meand;
+    double t_sumar;
+    double t;
+
+    if ((0 == n) || (NULL == v) || (NULL == w)) {
+        fprintf(stderr, "Uso: %s [elementos > 0]\n", argv[0]);
+        free(v);
+        free(w);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = round(((double) (siguiente(&semilla) >> 11) / (1UL << 53) * 10 + 15) * 10) / 10;
+    }
+
+    t = now();
+    for (int k = 0; k < REPETICIONES; ++k) {
+        suma_exacta = sum(v, n);
+    }
+    t_sum = (now() - t) / REPETICIONES;
+    t = now();
+    for (int k = 0; k < REPETICIONES; ++k) {
+        meand(&media, v, n);
+    }
+    t_meand = (now() - t) / REPETICIONES;
+    t = now();
+    for (int k = 0; k < REPETICIONES; ++k) {
+        sumar(w, v, v, n);
+    }
+    t_sumar = (now() - t) / REPETICIONES;
+
+    printf("%zu elementos\n\n", n);
+    printf("%-12s %8s %10s %10s %10s %12s %12s\n", "formato", "MB", "sum", "meand", "sumar", "error elem.",
+           "error suma");
+    printf("%-12s %8.1f %7.2f ms %7.2f ms %7.2f ms %12s %12s\n", "double", n * sizeof(double) / 1048576.0, t_sum * 1e3,
+           t_meand * 1e3, t_sumar * 1e3, "-", "-");
+
+    for (reducido_formato_t f = REDUCIDO_F32; f <= REDUCIDO_BF16; ++f) {
+        if (!reducido_init(&r, f, n) || !reducido_init(&s, f, n)) {
+            fprintf(stderr, "No hay memoria\n");
+            reducido_destroy(&r);
+            free(v);
+            free(w);
+            return EXIT_FAILURE;
+        }
+        reducido_guardar(&r, 0, v, n);
+        reducido_guardar(&s, 0, v, n);
+
+        t = now();
+        for (int k = 0; k < REPETICIONES; ++k) {
+            reducido_sum(&r, &suma);
+        }
+        t_sum = (now() - t) / REPETICIONES;
+        t = now();
+        for (int k = 0; k < REPETICIONES; ++k) {
+            reducido_meand(&r, &media);
+        }
+        t_meand = (now() - t) / REPETICIONES;
+        t = now();
+        for (int k = 0; k < REPETICIONES; ++k) {
+            reducido_sumar(&s, &r, &r);
+        }
+        t_sumar = (now() - t) / REPETICIONES;
+
+        printf("%-12s %8.1f %7.2f ms %7.2f ms %7.2f ms %12.2g %12.2g\n", nombres[f], reducido_bytes(&r) / 1048576.0,
+               t_sum * 1e3, t_meand * 1e3, t_sumar * 1e3, error_elementos(&r, v),
+               fabs(suma - suma_exacta) / fabs(suma_exacta));
+
+        reducido_destroy(&r);
+        reducido_destroy(&s);
+    }
+
+    free(v);
+    free(w);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,223 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "sistema.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Resuelve A X = B con LU (A al azar) y con Cholesky (A simétrica con n en la diagonal, definida positiva), y compara
+ * las factorizaciones con la versión de tres ciclos de los libros. Muestra el tiempo, los GFLOPS (2/3 n^3 operaciones
+ * la LU, 1/3 n^3 Cholesky), el residuo de la solución y el de la inversa, y el log del determinante de las dos formas.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -pthread -o bench_sistema bench_sistema.c sistema.c -lm
+ * $ ./bench_sistema [n] [hilos]
+ */
+
+#define DEFAULT_N 2000
+#define COLUMNAS 16
+/* the loops of the textbook are O(n^3) without blocking: above this they take too long */
+#define MAX_N_SIMPLE 2500
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+static double al_azar(unsigned long *x)
+{
+    return (double) (siguiente(x) >> 11) / (1UL << 53) - 0.5;
+}
+
+
+/* the textbook LU: for each column, pivot and update the whole rest of the matrix */
+static void lu_simple(double a[], size_t n, size_t pivotes[])
+{
+    double factor;
+    double z;
+    size_t p;
+
+    for (size_t j = 0; j < n; ++j) {
+        p = j;
+        for (size_t i = j + 1; i < n; ++i) {
+            if (fabs(a[i * n + j]) > fabs(a[p * n + j])) {
+                p = i;
+            }
+        }
+        pivotes[j] = p;
+        for (size_t k = 0; k < n; ++k) {
+            z = a[j * n + k];
+            a[j * n + k] = a[p * n + k];
+            a[p * n + k] = z;
+        }
+        for (size_t i = j + 1; i < n; ++i) {
+            a[i * n + j] /= a[j * n + j];
+            factor = a[i * n + j];
+            for (size_t k = j + 1; k < n; ++k) {
+                a[i * n + k] -= factor * a[j * n + k];
+            }
+        }
+    }
+}
+
+
+/* the textbook Cholesky, row by row with dot products */
+static void cholesky_simple(double a[], size_t n)
+{
+    double s;
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            s = a[i * n + j];
+            for (size_t k = 0; k < j; ++k) {
+                s -= a[i * n + k] * a[j * n + k];
+            }
+            a[i * n + j] = (i == j) ? sqrt(s) : s / a[j * n + j];
+        }
+    }
+}
+
+
+static void mostrar(const char *nombre, double t, double operaciones)
+{
+    printf("  %-30s %9.1f ms %7.2f GFLOPS\n", nombre, t * 1e3, operaciones / t * 1e-9);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_N;
+    size_t hilos = (argc > 2) ? strtoul(argv[2], NULL, 10) : 0;
+    double *a = (double *) malloc(n * n * sizeof(double));
+    double *f = (double *) malloc(n * n * sizeof(double));
+    double *inv = (double *) malloc(n * n * sizeof(double));
+    double *identidad = (double *) malloc(n * n * sizeof(double));
+    double *b = (double *) malloc(n * COLUMNAS * sizeof(double));
+    double *x = (double *) malloc(n * COLUMNAS * sizeof(double));
+    size_t *pivotes = (size_t *) malloc(n * sizeof(size_t));
+    unsigned long semilla = 88172645463325252UL;
+    double lu = 2.0 / 3 * n * n * n;
+    double residuo;
+    double residuo_inversa;
+    double log_det;
+    double log_det_lu;
+    double det;
+    int signo;
+    double t;
+    bool ok;
+
+    if ((0 == n) || (NULL == a) || (NULL == f) || (NULL == inv) || (NULL == identidad) || (NULL == b) || (NULL == x) ||
+        (NULL == pivotes)) {
+        fprintf(stderr, "Uso: %s [n > 0] [hilos]\n", argv[0]);
+        free(a);
+        free(f);
+        free(inv);
+        free(identidad);
+        free(b);
+        free(x);
+        free(pivotes);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n * n; ++i) {
+        a[i] = al_azar(&semilla);
+        identidad[i] = (0 == i % (n + 1)) ? 1 : 0;
+    }
+    for (size_t i = 0; i < n * COLUMNAS; ++i) {
+        b[i] = al_azar(&semilla);
+    }
+    /* touched once here, so the first measurement does not pay for the page faults */
+    memset(inv, 0, n * n * sizeof(double));
+
+    printf("n = %zu, %d columnas, %zu hilos (0: uno por procesador)\n\nLU\n", n, COLUMNAS, hilos);
+    if (n <= MAX_N_SIMPLE) {
+        memcpy(f, a, n * n * sizeof(double));
+        t = now();
+        lu_simple(f, n, pivotes);
+        mostrar("tres ciclos", now() - t, lu);
+    }
+    memcpy(f, a, n * n * sizeof(double));
+    t = now();
+    ok = lu_factorizar(f, n, pivotes, hilos);
+    mostrar("lu_factorizar", now() - t, lu);
+
+    memcpy(x, b, n * COLUMNAS * sizeof(double));
+    t = now();
+    ok = lu_resolver(f, n, pivotes, x, COLUMNAS, hilos) && ok;
+    mostrar("lu_resolver", now() - t, 2.0 * n * n * COLUMNAS);
+    t = now();
+    ok = lu_inversa(inv, f, n, pivotes, hilos) && ok;
+    mostrar("lu_inversa", now() - t, 2.0 * n * n * n);
+
+    ok = sistema_residuo(a, n, x, b, COLUMNAS, hilos, &residuo) && ok;
+    ok = sistema_residuo(a, n, inv, identidad, n, hilos, &residuo_inversa) && ok;
+    ok = lu_determinante(f, n, pivotes, &det) && lu_log_determinante(f, n, pivotes, &log_det_lu, &signo) && ok;
+    printf("  residuo %.2g, de la inversa %.2g, det %g, log |det| %.6f, signo %d\n", residuo, residuo_inversa, det,
+           log_det_lu, signo);
+
+    /* symmetric, with |a_ij| <= 0.5 off the diagonal and n on it: by Gershgorin all its eigenvalues are positive */
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            a[j * n + i] = a[i * n + j];
+        }
+        a[i * n + i] = n;
+    }
+
+    printf("\nCholesky\n");
+    if (n <= MAX_N_SIMPLE) {
+        memcpy(f, a, n * n * sizeof(double));
+        t = now();
+        cholesky_simple(f, n);
+        mostrar("tres ciclos", now() - t, lu / 2);
+    }
+    memcpy(f, a, n * n * sizeof(double));
+    t = now();
+    ok = cholesky_factorizar(f, n, hilos) && ok;
+    mostrar("cholesky_factorizar", now() - t, lu / 2);
+
+    memcpy(x, b, n * COLUMNAS * sizeof(double));
+    t = now();
+    ok = cholesky_resolver(f, n, x, COLUMNAS, hilos) && ok;
+    mostrar("cholesky_resolver", now() - t, 2.0 * n * n * COLUMNAS);
+    t = now();
+    ok = cholesky_inversa(inv, f, n, hilos) && ok;
+    mostrar("cholesky_inversa", now() - t, 2.0 * n * n * n);
+
+    ok = sistema_residuo(a, n, x, b, COLUMNAS, hilos, &residuo) && ok;
+    ok = sistema_residuo(a, n, inv, identidad, n, hilos, &residuo_inversa) && ok;
+    ok = cholesky_log_determinante(f, n, &log_det) && ok;
+    memcpy(f, a, n * n * sizeof(double));
+    ok = lu_factorizar(f, n, pivotes, hilos) && lu_log_determinante(f, n, pivotes, &log_det_lu, &signo) && ok;
+    printf("  residuo %.2g, de la inversa %.2g, log det %.6f (con LU: %.6f)\n", residuo, residuo_inversa, log_det,
+           log_det_lu);
+
+    free(a);
+    free(f);
+    free(inv);
+    free(identidad);
+    free(b);
+    free(x);
+    free(pivotes);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
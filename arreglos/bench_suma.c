@@ -0,0 +1,145 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "suma.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Costo y error de cada modo de suma_mode, contra el ciclo de sum.c.
+ *
+ * Se mide con un arreglo grande (limitado por la memoria) y con uno chico que entra en la caché y se suma muchas veces
+ * (limitado por el cómputo). El error es relativo a SUM_EXACT, sobre datos con mucha cancelación.
+ * Al final se suma el arreglo partido en bloques de distinto tamaño: sólo SUM_EXACT da siempre el mismo resultado.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -o bench_suma bench_suma.c suma.c sum.c -lm
+ * $ ./bench_suma [elementos]
+ */
+
+#define DEFAULT_LENGTH (1UL << 24)
+#define SMALL_LENGTH 4096
+#define MIN_ELEMENTS (1UL << 28)
+
+/* arreglos/sum.c */
+double sum(const double v[], size_t n);
+
+
+static const char *names[] = {"sum.c", "SUM_NAIVE", "SUM_PAIRWISE", "SUM_NEUMAIER", "SUM_EXACT"};
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static double run(int mode, const double v[], size_t n)
+{
+    return (mode < 0) ? sum(v, n) : sum_mode(v, n, (sum_mode_t) mode);
+}
+
+
+/* returns ns per element, repeating the sum until MIN_ELEMENTS elements were added */
+static double timed(int mode, const double v[], size_t n, double *result)
+{
+    size_t reps = (MIN_ELEMENTS + n - 1) / n;
+    volatile double sink = 0;
+    double t = now();
+
+    for (size_t r = 0; r < reps; ++r) {
+        sink = run(mode, v, n);
+    }
+    t = now() - t;
+    *result = sink;
+
+    return t / (reps * n) * 1e9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+static double chunked_sum(int mode, const double v[], size_t n, size_t chunk)
+{
+    sum_exact_t total;
+    sum_exact_t part;
+    double s = 0;
+
+    sum_exact_init(&total);
+    for (size_t i = 0; i < n; i += chunk) {
+        if (SUM_EXACT == mode) {
+            sum_exact_init(&part);
+            sum_exact_add(&part, v + i, (n - i < chunk) ? n - i : chunk);
+            sum_exact_merge(&total, &part);
+        } else {
+            s += run(mode, v + i, (n - i < chunk) ? n - i : chunk);
+        }
+    }
+
+    return (SUM_EXACT == mode) ? sum_exact_result(&total) : s;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LENGTH;
+    double *v = (double *) malloc(n * sizeof(double));
+    unsigned long semilla = 88172645463325252UL;
+    const size_t chunks[] = {1000, 4096, 65536};
+    double exact;
+    double big;
+    double small;
+    double result;
+
+    if ((0 == n) || (NULL == v)) {
+        fprintf(stderr, "Uso: %s [elementos > 0]\n", argv[0]);
+        free(v);
+        return EXIT_FAILURE;
+    }
+
+    /* values of very different magnitudes and both signs: the exact sum is tiny compared to the terms */
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = ldexp((double) (siguiente(&semilla) >> 11) / (1UL << 53), (int) (siguiente(&semilla) % 60) - 30);
+        v[i] = (siguiente(&semilla) & 1) ? v[i] : -v[i];
+    }
+    exact = sum_mode(v, n, SUM_EXACT);
+
+    printf("%zu elementos, suma exacta %.17g\n\n", n, exact);
+    printf("%-14s %12s %12s %14s\n", "modo", "ns/elem", "ns/elem", "error");
+    printf("%-14s %12s %12s %14s\n", "", "(memoria)", "(caché)", "relativo");
+    for (int mode = -1; mode <= SUM_EXACT; ++mode) {
+        big = timed(mode, v, n, &result);
+        small = timed(mode, v, (n < SMALL_LENGTH) ? n : SMALL_LENGTH, &(double){0});
+        printf("%-14s %12.3f %12.3f %14.3e\n", names[mode + 1], big, small, fabs((result - exact) / exact));
+    }
+
+    printf("\nsuma por bloques de");
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+        printf(" %25zu", chunks[c]);
+    }
+    putchar('\n');
+    for (int mode = -1; mode <= SUM_EXACT; ++mode) {
+        printf("%-19s", names[mode + 1]);
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+            printf(" %25.17g", chunked_sum(mode, v, n, chunks[c]));
+        }
+        putchar('\n');
+    }
+
+    free(v);
+
+    return EXIT_SUCCESS;
+}
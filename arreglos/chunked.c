@@ -0,0 +1,443 @@
+#define _XOPEN_SOURCE 700
+
+#include "chunked.h"
+#include "../memdin/alloc_hook.h"
+#include "../punteros/src/meand.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define READAHEAD_CHUNKS 2
+
+/* arreglos/sum.c y arreglos/random.c */
+double sum(const double v[], size_t n);
+void uniform(double v[], size_t n, double a, double b);
+
+
+typedef struct {
+    size_t chunk;
+    size_t n;
+    double *data;
+    bool valid;
+    bool dirty;
+    unsigned long last_use;
+} slot_t;
+
+
+struct chunked {
+    int fd;
+    bool writable;
+    size_t length;
+    size_t chunk_length;
+    size_t chunks;
+    size_t cache_chunks;
+    unsigned long clock;
+    slot_t *slots;
+};
+
+
+static bool read_full(int fd, void *buf, size_t bytes, off_t offset)
+{
+    char *p = (char *) buf;
+    ssize_t r;
+
+    while (bytes > 0) {
+        r = pread(fd, p, bytes, offset);
+        if (r < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        if (0 == r) {
+            /* past the end of the file: the rest reads as zeros */
+            memset(p, 0, bytes);
+            return true;
+        }
+        p += r;
+        offset += r;
+        bytes -= (size_t) r;
+    }
+
+    return true;
+}
+
+
+static bool write_full(int fd, const void *buf, size_t bytes, off_t offset)
+{
+    const char *p = (const char *) buf;
+    ssize_t w;
+
+    while (bytes > 0) {
+        w = pwrite(fd, p, bytes, offset);
+        if (w < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        p += w;
+        offset += w;
+        bytes -= (size_t) w;
+    }
+
+    return true;
+}
+
+
+static off_t chunk_offset(const chunked_t *a, size_t chunk)
+{
+    return (off_t) (chunk * a->chunk_length * sizeof(double));
+}
+
+
+static size_t chunk_size(const chunked_t *a, size_t chunk)
+{
+    size_t first = chunk * a->chunk_length;
+
+    return (a->length - first < a->chunk_length) ? a->length - first : a->chunk_length;
+}
+
+
+chunked_t *chunked_open(const char *path, size_t length, size_t chunk_length, size_t cache_chunks, bool writable)
+{
+    chunked_t *a;
+    struct stat st;
+
+    if ((NULL == path) || (0 == chunk_length) || (0 == cache_chunks)
+        || (chunk_length > SIZE_MAX / sizeof(double)) || (length > SIZE_MAX / sizeof(double))) {
+        return NULL;
+    }
+
+    a = (chunked_t *) HOOK_CALLOC(1, sizeof(chunked_t));
+    if (NULL == a) {
+        return NULL;
+    }
+
+    a->fd = open(path, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (a->fd < 0) {
+        HOOK_FREE(a);
+        return NULL;
+    }
+
+    if (0 != fstat(a->fd, &st)) {
+        close(a->fd);
+        HOOK_FREE(a);
+        return NULL;
+    }
+
+    /* read-only, the file must already have `length` elements: past its end every read would give zeros */
+    if (0 == length) {
+        length = (size_t) st.st_size / sizeof(double);
+    } else if (writable ? (0 != ftruncate(a->fd, (off_t) (length * sizeof(double))))
+                        : (length > (size_t) st.st_size / sizeof(double))) {
+        close(a->fd);
+        HOOK_FREE(a);
+        return NULL;
+    }
+
+    a->writable = writable;
+    a->length = length;
+    a->chunk_length = chunk_length;
+    a->chunks = (length + chunk_length - 1) / chunk_length;
+    a->cache_chunks = cache_chunks;
+
+    a->slots = (slot_t *) HOOK_CALLOC(cache_chunks, sizeof(slot_t));
+    if (NULL == a->slots) {
+        close(a->fd);
+        HOOK_FREE(a);
+        return NULL;
+    }
+
+    posix_fadvise(a->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    return a;
+}
+
+
+size_t chunked_length(const chunked_t *a)
+{
+    return (NULL == a) ? 0 : a->length;
+}
+
+
+size_t chunked_chunk_length(const chunked_t *a)
+{
+    return (NULL == a) ? 0 : a->chunk_length;
+}
+
+
+static bool write_back(chunked_t *a, slot_t *s)
+{
+    if (!s->valid || !s->dirty) {
+        return true;
+    }
+
+    if (!write_full(a->fd, s->data, s->n * sizeof(double), chunk_offset(a, s->chunk))) {
+        return false;
+    }
+    s->dirty = false;
+
+    return true;
+}
+
+
+static slot_t *victim(chunked_t *a)
+{
+    slot_t *lru = &a->slots[0];
+
+    for (size_t i = 0; i < a->cache_chunks; ++i) {
+        if (!a->slots[i].valid) {
+            return &a->slots[i];
+        }
+        if (a->slots[i].last_use < lru->last_use) {
+            lru = &a->slots[i];
+        }
+    }
+
+    return lru;
+}
+
+
+double *chunked_get(chunked_t *a, size_t chunk, bool write, size_t *n)
+{
+    slot_t *s = NULL;
+
+    if ((NULL == a) || (chunk >= a->chunks) || (write && !a->writable)) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < a->cache_chunks; ++i) {
+        if (a->slots[i].valid && (a->slots[i].chunk == chunk)) {
+            s = &a->slots[i];
+            break;
+        }
+    }
+
+    if (NULL == s) {
+        s = victim(a);
+        if (!write_back(a, s)) {
+            return NULL;
+        }
+        if (NULL == s->data) {
+            s->data = (double *) HOOK_MALLOC(a->chunk_length * sizeof(double));
+            if (NULL == s->data) {
+                return NULL;
+            }
+        }
+        s->valid = false;
+        s->chunk = chunk;
+        s->n = chunk_size(a, chunk);
+        if (!read_full(a->fd, s->data, s->n * sizeof(double), chunk_offset(a, chunk))) {
+            return NULL;
+        }
+        s->valid = true;
+    }
+
+    s->last_use = ++a->clock;
+    s->dirty = s->dirty || write;
+    if (NULL != n) {
+        *n = s->n;
+    }
+
+    return s->data;
+}
+
+
+bool chunked_for_each(chunked_t *a, chunked_fn_t fn, void *ctx, bool write)
+{
+    double *data;
+    size_t n;
+    size_t ahead;
+
+    if ((NULL == a) || (NULL == fn)) {
+        return false;
+    }
+
+    for (size_t c = 0; c < a->chunks; ++c) {
+        /* ask the kernel to start reading the next chunks while this one is being processed */
+        ahead = (a->chunks - c - 1 < READAHEAD_CHUNKS) ? a->chunks - c - 1 : READAHEAD_CHUNKS;
+        if (ahead > 0) {
+            posix_fadvise(a->fd, chunk_offset(a, c + 1), (off_t) (ahead * a->chunk_length * sizeof(double)),
+                          POSIX_FADV_WILLNEED);
+        }
+
+        data = chunked_get(a, c, write, &n);
+        if (NULL == data) {
+            return false;
+        }
+        fn(data, n, c * a->chunk_length, ctx);
+
+        if (!write) {
+            /* already copied into the cache: drop it from the page cache so a 200 GB scan does not evict everything */
+            posix_fadvise(a->fd, chunk_offset(a, c), (off_t) (n * sizeof(double)), POSIX_FADV_DONTNEED);
+        }
+    }
+
+    return true;
+}
+
+
+bool chunked_flush(chunked_t *a)
+{
+    bool ok = true;
+
+    if (NULL == a) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a->cache_chunks; ++i) {
+        ok = write_back(a, &a->slots[i]) && ok;
+    }
+
+    return ok;
+}
+
+
+bool chunked_close(chunked_t **a)
+{
+    bool ok;
+
+    if ((NULL == a) || (NULL == *a)) {
+        return false;
+    }
+
+    ok = chunked_flush(*a);
+    for (size_t i = 0; i < (*a)->cache_chunks; ++i) {
+        HOOK_FREE((*a)->slots[i].data);
+    }
+    HOOK_FREE((*a)->slots);
+    ok = (0 == close((*a)->fd)) && ok;
+    HOOK_FREE(*a);
+    *a = NULL;
+
+    return ok;
+}
+
+
+static void sum_chunk(double *chunk, size_t n, size_t offset, void *ctx)
+{
+    (void) offset;
+    *(double *) ctx += sum(chunk, n);
+}
+
+
+bool chunked_sum(chunked_t *a, double *suma)
+{
+    double s = 0;
+
+    if ((NULL == suma) || !chunked_for_each(a, sum_chunk, &s, false)) {
+        return false;
+    }
+
+    *suma = s;
+
+    return true;
+}
+
+
+typedef struct {
+    double weighted;
+    bool ok;
+} meand_ctx_t;
+
+
+static void meand_chunk(double *chunk, size_t n, size_t offset, void *ctx)
+{
+    meand_ctx_t *m = (meand_ctx_t *) ctx;
+    double mean;
+
+    (void) offset;
+    if (ST_OK != meand(&mean, chunk, n)) {
+        m->ok = false;
+        return;
+    }
+    /* every chunk's mean is weighted by its number of elements */
+    m->weighted += mean * n;
+}
+
+
+bool chunked_meand(chunked_t *a, double *mean)
+{
+    meand_ctx_t m = {.weighted = 0, .ok = true};
+
+    if ((NULL == mean) || (NULL == a) || (0 == a->length)) {
+        return false;
+    }
+
+    if (!chunked_for_each(a, meand_chunk, &m, false) || !m.ok) {
+        return false;
+    }
+
+    *mean = m.weighted / a->length;
+
+    return true;
+}
+
+
+typedef struct {
+    double max;
+    bool primero;
+} maximo_ctx_t;
+
+
+static void maximo_chunk(double *chunk, size_t n, size_t offset, void *ctx)
+{
+    maximo_ctx_t *m = (maximo_ctx_t *) ctx;
+
+    (void) offset;
+    if (m->primero && (n > 0)) {
+        m->max = chunk[0];
+        m->primero = false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (chunk[i] > m->max) {
+            m->max = chunk[i];
+        }
+    }
+}
+
+
+bool chunked_maximo(chunked_t *a, double *max)
+{
+    maximo_ctx_t m = {.max = 0, .primero = true};
+
+    if ((NULL == max) || (NULL == a) || (0 == a->length)) {
+        return false;
+    }
+
+    if (!chunked_for_each(a, maximo_chunk, &m, false) || m.primero) {
+        return false;
+    }
+
+    *max = m.max;
+
+    return true;
+}
+
+
+typedef struct {
+    double lo;
+    double hi;
+} uniform_ctx_t;
+
+
+static void uniform_chunk(double *chunk, size_t n, size_t offset, void *ctx)
+{
+    uniform_ctx_t *u = (uniform_ctx_t *) ctx;
+
+    (void) offset;
+    uniform(chunk, n, u->lo, u->hi);
+}
+
+
+bool chunked_uniform(chunked_t *a, double lo, double hi)
+{
+    uniform_ctx_t u = {.lo = lo, .hi = hi};
+
+    return chunked_for_each(a, uniform_chunk, &u, true) && chunked_flush(a);
+}
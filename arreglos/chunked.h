@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Arreglo de doubles almacenado en disco y procesado por bloques (chunks).
+ *
+ * El archivo contiene los doubles tal cual están en memoria. Sólo `cache_chunks` bloques de `chunk_length` elementos
+ * están en memoria a la vez; al desalojar un bloque modificado se escribe de vuelta al archivo.
+ *
+ * chunked_open con `length` 0 toma el largo del archivo. Si no, para escribir lleva el archivo a `length` elementos, y
+ * para sólo leer falla si el archivo tiene menos.
+ *
+ * chunked_get devuelve un puntero al bloque pedido, válido hasta la próxima llamada que pueda desalojarlo.
+ * chunked_for_each recorre el arreglo en orden avisándole al kernel (posix_fadvise) qué bloques se leerán a
+ * continuación, de modo que la lectura de los siguientes se solapa con el cómputo del actual.
+ *
+ * Las reducciones usan sum.c, random.c y ../punteros/src/meand_st.c, que deben compilarse junto con chunked.c.
+ */
+
+typedef struct chunked chunked_t;
+
+typedef void (*chunked_fn_t)(double *chunk, size_t n, size_t offset, void *ctx);
+
+
+chunked_t *chunked_open(const char *path, size_t length, size_t chunk_length, size_t cache_chunks, bool writable);
+size_t chunked_length(const chunked_t *a);
+size_t chunked_chunk_length(const chunked_t *a);
+double *chunked_get(chunked_t *a, size_t chunk, bool write, size_t *n);
+bool chunked_for_each(chunked_t *a, chunked_fn_t fn, void *ctx, bool write);
+bool chunked_flush(chunked_t *a);
+bool chunked_close(chunked_t **a);
+
+/* reducciones existentes (sum, meand, uniform) aplicadas bloque a bloque */
+bool chunked_sum(chunked_t *a, double *suma);
+bool chunked_meand(chunked_t *a, double *mean);
+bool chunked_maximo(chunked_t *a, double *max);
+bool chunked_uniform(chunked_t *a, double lo, double hi);
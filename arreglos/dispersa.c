@@ -0,0 +1,437 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "dispersa.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define MAX_HILOS 64
+/* below this many elements per thread, creating the thread costs more than it saves */
+#define MIN_TRABAJO (1UL << 16)
+
+
+typedef struct {
+    const dispersa_t *m;
+    const double *x;
+    double *y;
+    size_t desde;
+    size_t hasta;
+    pthread_t hilo;
+    bool lanzado;
+} parte_t;
+
+
+static size_t minimo(size_t a, size_t b)
+{
+    return (a < b) ? a : b;
+}
+
+
+/* rows of a CSR matrix are its major dimension; columns, of a CSC one */
+static size_t mayor(const dispersa_t *m)
+{
+    return (DISPERSA_CSR == m->formato) ? m->filas : m->columnas;
+}
+
+
+static size_t menor(const dispersa_t *m)
+{
+    return (DISPERSA_CSR == m->formato) ? m->columnas : m->filas;
+}
+
+
+static bool reservar(dispersa_t *m, dispersa_formato_t formato, size_t filas, size_t columnas, size_t nnz)
+{
+    m->formato = formato;
+    m->filas = filas;
+    m->columnas = columnas;
+    m->nnz = nnz;
+    m->inicio = (size_t *) calloc(mayor(m) + 1, sizeof(size_t));
+    m->indices = (uint32_t *) malloc((nnz ? nnz : 1) * sizeof(uint32_t));
+    m->valores = (double *) malloc((nnz ? nnz : 1) * sizeof(double));
+
+    if ((NULL == m->inicio) || (NULL == m->indices) || (NULL == m->valores)) {
+        dispersa_free(m);
+        return false;
+    }
+
+    return true;
+}
+
+
+/* counts per index become the start of each segment: cuenta[i] ends up as the first position of segment i */
+static void acumular(size_t cuenta[], size_t n)
+{
+    size_t total = 0;
+    size_t c;
+
+    for (size_t i = 0; i < n; ++i) {
+        c = cuenta[i];
+        cuenta[i] = total;
+        total += c;
+    }
+    cuenta[n] = total;
+}
+
+
+/*
+ * Two stable counting sorts: first by minor index, then by major index. Each segment comes out sorted without a
+ * single comparison, and repeated entries end up next to each other, where they are added.
+ */
+bool dispersa_desde_tripletes(dispersa_t *m, size_t filas, size_t columnas, const triplete_t t[], size_t n,
+                              dispersa_formato_t formato)
+{
+    const bool csr = (DISPERSA_CSR == formato);
+    size_t *cuenta;
+    size_t *orden;
+    size_t *pos;
+    size_t k;
+    size_t escrito = 0;
+    size_t desde;
+
+    if ((NULL == m) || ((NULL == t) && (0 != n)) || (filas > INT32_MAX) || (columnas > INT32_MAX)) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if ((t[i].fila >= filas) || (t[i].columna >= columnas)) {
+            return false;
+        }
+    }
+
+    if (!reservar(m, formato, filas, columnas, n)) {
+        return false;
+    }
+    /* one counter per index of either dimension */
+    cuenta = (size_t *) malloc((((filas > columnas) ? filas : columnas) + 1) * sizeof(size_t));
+    orden = (size_t *) malloc((n ? n : 1) * sizeof(size_t));
+    if ((NULL == cuenta) || (NULL == orden)) {
+        free(cuenta);
+        free(orden);
+        dispersa_free(m);
+        return false;
+    }
+
+    memset(cuenta, 0, (menor(m) + 1) * sizeof(size_t));
+    for (size_t i = 0; i < n; ++i) {
+        cuenta[csr ? t[i].columna : t[i].fila]++;
+    }
+    acumular(cuenta, menor(m));
+    for (size_t i = 0; i < n; ++i) {
+        orden[cuenta[csr ? t[i].columna : t[i].fila]++] = i;
+    }
+
+    pos = m->inicio;
+    for (size_t i = 0; i < n; ++i) {
+        pos[csr ? t[i].fila : t[i].columna]++;
+    }
+    acumular(pos, mayor(m));
+    memcpy(cuenta, pos, mayor(m) * sizeof(size_t));
+    for (size_t i = 0; i < n; ++i) {
+        k = cuenta[csr ? t[orden[i]].fila : t[orden[i]].columna]++;
+        m->indices[k] = (uint32_t) (csr ? t[orden[i]].columna : t[orden[i]].fila);
+        m->valores[k] = t[orden[i]].valor;
+    }
+    free(orden);
+    free(cuenta);
+
+    /* repeated entries are adjacent: they are merged while the arrays are compacted */
+    for (size_t i = 0; i < mayor(m); ++i) {
+        desde = pos[i];
+        pos[i] = escrito;
+        for (k = desde; k < pos[i + 1]; ++k) {
+            if ((escrito > pos[i]) && (m->indices[escrito - 1] == m->indices[k])) {
+                m->valores[escrito - 1] += m->valores[k];
+            } else {
+                m->indices[escrito] = m->indices[k];
+                m->valores[escrito] = m->valores[k];
+                escrito++;
+            }
+        }
+    }
+    pos[mayor(m)] = escrito;
+    m->nnz = escrito;
+
+    return true;
+}
+
+
+/* a counting transposition of the storage: reading the old segments in order leaves the new ones sorted */
+bool dispersa_convertir(const dispersa_t *m, dispersa_formato_t formato, dispersa_t *out)
+{
+    size_t *pos;
+    size_t k;
+
+    if ((NULL == m) || (NULL == out) || (out == m)) {
+        return false;
+    }
+
+    if (!reservar(out, formato, m->filas, m->columnas, m->nnz)) {
+        return false;
+    }
+
+    if (formato == m->formato) {
+        memcpy(out->inicio, m->inicio, (mayor(m) + 1) * sizeof(size_t));
+        memcpy(out->indices, m->indices, m->nnz * sizeof(uint32_t));
+        memcpy(out->valores, m->valores, m->nnz * sizeof(double));
+        return true;
+    }
+
+    pos = (size_t *) malloc((mayor(out) + 1) * sizeof(size_t));
+    if (NULL == pos) {
+        dispersa_free(out);
+        return false;
+    }
+
+    for (size_t j = 0; j < m->nnz; ++j) {
+        out->inicio[m->indices[j]]++;
+    }
+    acumular(out->inicio, mayor(out));
+    memcpy(pos, out->inicio, (mayor(out) + 1) * sizeof(size_t));
+    for (size_t i = 0; i < mayor(m); ++i) {
+        for (size_t j = m->inicio[i]; j < m->inicio[i + 1]; ++j) {
+            k = pos[m->indices[j]]++;
+            out->indices[k] = (uint32_t) i;
+            out->valores[k] = m->valores[j];
+        }
+    }
+    free(pos);
+
+    return true;
+}
+
+
+void dispersa_free(dispersa_t *m)
+{
+    if (NULL != m) {
+        free(m->inicio);
+        free(m->indices);
+        free(m->valores);
+        m->inicio = NULL;
+        m->indices = NULL;
+        m->valores = NULL;
+        m->nnz = 0;
+    }
+}
+
+
+/* (i, i) is searched in segment i, which is sorted: the same code serves CSR and CSC */
+static double elemento_diagonal(const dispersa_t *m, size_t i)
+{
+    size_t desde = m->inicio[i];
+    size_t hasta = m->inicio[i + 1];
+    size_t medio;
+
+    while (desde < hasta) {
+        medio = desde + (hasta - desde) / 2;
+        if (m->indices[medio] < i) {
+            desde = medio + 1;
+        } else {
+            hasta = medio;
+        }
+    }
+
+    return ((desde < m->inicio[i + 1]) && (m->indices[desde] == i)) ? m->valores[desde] : 0;
+}
+
+
+double dispersa_traza(const dispersa_t *m)
+{
+    double t = 0;
+
+    if ((NULL == m) || (NULL == m->inicio)) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < minimo(m->filas, m->columnas); ++i) {
+        t += elemento_diagonal(m, i);
+    }
+
+    return t;
+}
+
+
+bool dispersa_diagonal(const dispersa_t *m, double diag[])
+{
+    if ((NULL == m) || (NULL == m->inicio) || (NULL == diag)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < minimo(m->filas, m->columnas); ++i) {
+        diag[i] = elemento_diagonal(m, i);
+    }
+
+    return true;
+}
+
+
+/* one dot product per row, DISPERSA_LANES independent partial sums at a time */
+static double fila(const uint32_t *restrict indices, const double *restrict valores, const double *restrict x,
+                   size_t n)
+{
+    double s = 0;
+    size_t k = 0;
+
+#ifdef __AVX2__
+    __m256d acc = _mm256_setzero_pd();
+    __m128d mitad;
+
+    for (; k + DISPERSA_LANES <= n; k += DISPERSA_LANES) {
+        __m128i j = _mm_loadu_si128((const __m128i *) (indices + k));
+        __m256d xs = _mm256_i32gather_pd(x, j, sizeof(double));
+
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(valores + k), xs));
+    }
+    mitad = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    s = _mm_cvtsd_f64(_mm_add_sd(mitad, _mm_unpackhi_pd(mitad, mitad)));
+#else
+    double acc[DISPERSA_LANES] = {0};
+
+    for (; k + DISPERSA_LANES <= n; k += DISPERSA_LANES) {
+        for (size_t l = 0; l < DISPERSA_LANES; ++l) {
+            acc[l] += valores[k + l] * x[indices[k + l]];
+        }
+    }
+    s = (acc[0] + acc[2]) + (acc[1] + acc[3]);
+#endif
+
+    for (; k < n; ++k) {
+        s += valores[k] * x[indices[k]];
+    }
+
+    return s;
+}
+
+
+static void producto_filas(const parte_t *p)
+{
+    const dispersa_t *m = p->m;
+
+    for (size_t i = p->desde; i < p->hasta; ++i) {
+        p->y[i] = fila(m->indices + m->inicio[i], m->valores + m->inicio[i], p->x, m->inicio[i + 1] - m->inicio[i]);
+    }
+}
+
+
+/* column j adds x[j] times itself to y: the writes are scattered, so each part needs its own y */
+static void producto_columnas(const parte_t *p)
+{
+    const dispersa_t *m = p->m;
+    const uint32_t *restrict indices = m->indices;
+    const double *restrict valores = m->valores;
+    double *restrict y = p->y;
+    double xj;
+
+    memset(y, 0, m->filas * sizeof(double));
+    for (size_t j = p->desde; j < p->hasta; ++j) {
+        xj = p->x[j];
+        for (size_t k = m->inicio[j]; k < m->inicio[j + 1]; ++k) {
+            y[indices[k]] += valores[k] * xj;
+        }
+    }
+}
+
+
+static void *correr_parte(void *arg)
+{
+    parte_t *p = (parte_t *) arg;
+
+    if (DISPERSA_CSR == p->m->formato) {
+        producto_filas(p);
+    } else {
+        producto_columnas(p);
+    }
+
+    return NULL;
+}
+
+
+/* first segment i whose elements (each segment also counts as one, for the empty ones) reach `objetivo` */
+static size_t corte(const dispersa_t *m, size_t objetivo)
+{
+    size_t desde = 0;
+    size_t hasta = mayor(m);
+    size_t medio;
+
+    while (desde < hasta) {
+        medio = desde + (hasta - desde) / 2;
+        if (m->inicio[medio] + medio < objetivo) {
+            desde = medio + 1;
+        } else {
+            hasta = medio;
+        }
+    }
+
+    return desde;
+}
+
+
+bool dispersa_producto(const dispersa_t *m, const double x[], double y[], size_t hilos)
+{
+    parte_t partes[MAX_HILOS];
+    double *parciales = NULL;
+    size_t trabajo;
+    long cpus;
+
+    if ((NULL == m) || (NULL == m->inicio) || (NULL == x) || (NULL == y)) {
+        return false;
+    }
+
+    if (0 == hilos) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = (cpus > 0) ? (size_t) cpus : 1;
+    }
+    trabajo = m->nnz + mayor(m);
+    hilos = minimo(minimo(hilos, MAX_HILOS), trabajo / MIN_TRABAJO + 1);
+
+    /* in CSC every part but the first writes into a vector of its own; without memory for them, a single part */
+    if ((DISPERSA_CSC == m->formato) && (hilos > 1)) {
+        parciales = (double *) malloc((hilos - 1) * m->filas * sizeof(double));
+        if (NULL == parciales) {
+            hilos = 1;
+        }
+    }
+
+    for (size_t h = 0; h < hilos; ++h) {
+        partes[h].m = m;
+        partes[h].x = x;
+        partes[h].y = ((NULL == parciales) || (0 == h)) ? y : parciales + (h - 1) * m->filas;
+        partes[h].desde = (0 == h) ? 0 : partes[h - 1].hasta;
+        partes[h].hasta = (hilos - 1 == h) ? mayor(m) : corte(m, trabajo / hilos * (h + 1));
+        partes[h].lanzado = false;
+    }
+
+    for (size_t h = 1; h < hilos; ++h) {
+        partes[h].lanzado = (0 == pthread_create(&partes[h].hilo, NULL, correr_parte, &partes[h]));
+    }
+
+    /* a part whose thread could not be created is done here, so the result is always complete */
+    for (size_t h = 0; h < hilos; ++h) {
+        if (!partes[h].lanzado) {
+            correr_parte(&partes[h]);
+        }
+    }
+    for (size_t h = 1; h < hilos; ++h) {
+        if (partes[h].lanzado) {
+            pthread_join(partes[h].hilo, NULL);
+        }
+    }
+
+    if (NULL != parciales) {
+        for (size_t h = 1; h < hilos; ++h) {
+            for (size_t i = 0; i < m->filas; ++i) {
+                y[i] += partes[h].y[i];
+            }
+        }
+        free(parciales);
+    }
+
+    return true;
+}
@@ -0,0 +1,346 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "lote.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* matrices per block: the partial sums of a block stay in L1 while the diagonal is walked */
+#define BLOQUE 512
+#define MAX_HILOS 64
+/* below this many diagonal elements per thread, creating the thread costs more than it saves */
+#define MIN_TRABAJO (1UL << 16)
+
+
+typedef struct {
+    size_t fila;
+    size_t columna;
+    size_t largo;
+} diagonal_t;
+
+
+typedef struct {
+    const lote_t *l;
+    float **const *m;
+    diagonal_t d;
+    double *sumas;
+    const float *factores;
+} trabajo_t;
+
+
+typedef void (*rango_fn_t)(const trabajo_t *t, size_t desde, size_t hasta);
+
+
+typedef struct {
+    rango_fn_t fn;
+    const trabajo_t *t;
+    size_t desde;
+    size_t hasta;
+    pthread_t hilo;
+    bool lanzado;
+} parte_t;
+
+
+static size_t minimo(size_t a, size_t b)
+{
+    return (a < b) ? a : b;
+}
+
+
+static diagonal_t diagonal(size_t filas, size_t columnas, long k)
+{
+    diagonal_t d = {0, 0, 0};
+
+    if (k >= 0) {
+        d.columna = (size_t) k;
+        if (d.columna < columnas) {
+            d.largo = minimo(filas, columnas - d.columna);
+        }
+    } else {
+        d.fila = 0UL - (unsigned long) k;
+        if (d.fila < filas) {
+            d.largo = minimo(filas - d.fila, columnas);
+        }
+    }
+
+    return d;
+}
+
+
+static void *correr_parte(void *arg)
+{
+    parte_t *p = (parte_t *) arg;
+
+    p->fn(p->t, p->desde, p->hasta);
+
+    return NULL;
+}
+
+
+/* splits [0, cantidad) in contiguous ranges, one per thread; the calling thread takes the first one */
+static void repartir(rango_fn_t fn, const trabajo_t *t, size_t cantidad, size_t por_matriz, size_t hilos)
+{
+    parte_t partes[MAX_HILOS];
+    size_t trabajo = cantidad * (por_matriz ? por_matriz : 1);
+    size_t desde = 0;
+    long cpus;
+
+    if (0 == hilos) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = (cpus > 0) ? (size_t) cpus : 1;
+    }
+    hilos = minimo(minimo(hilos, MAX_HILOS), minimo(cantidad, trabajo / MIN_TRABAJO + 1));
+
+    if (hilos <= 1) {
+        fn(t, 0, cantidad);
+        return;
+    }
+
+    for (size_t h = 0; h < hilos; ++h) {
+        partes[h].fn = fn;
+        partes[h].t = t;
+        partes[h].desde = desde;
+        partes[h].hasta = desde + cantidad / hilos + (h < cantidad % hilos);
+        partes[h].lanzado = false;
+        desde = partes[h].hasta;
+    }
+
+    for (size_t h = 1; h < hilos; ++h) {
+        partes[h].lanzado = (0 == pthread_create(&partes[h].hilo, NULL, correr_parte, &partes[h]));
+    }
+
+    /* a range whose thread could not be created is done here, so the result is always complete */
+    for (size_t h = 0; h < hilos; ++h) {
+        if (!partes[h].lanzado) {
+            correr_parte(&partes[h]);
+        }
+    }
+    for (size_t h = 1; h < hilos; ++h) {
+        if (partes[h].lanzado) {
+            pthread_join(partes[h].hilo, NULL);
+        }
+    }
+}
+
+
+/*
+ * Interleaved batch (paso_lote 1): for each position of the diagonal, one contiguous pass over the matrices of the
+ * block, which vectorizes. Otherwise each matrix is walked on its own, which is what the caches prefer.
+ */
+static void sumar_rango(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    const lote_t *l = t->l;
+    const size_t paso_diagonal = l->paso_fila + l->paso_columna;
+    const size_t paso = l->paso_lote;
+    const float *inicio = l->data + t->d.fila * l->paso_fila + t->d.columna * l->paso_columna;
+    const float *restrict p;
+    double *restrict s;
+    double suma;
+    size_t n;
+
+    if (1 != paso) {
+        for (size_t b = desde; b < hasta; ++b) {
+            p = inicio + b * paso;
+            suma = 0;
+            for (size_t i = 0; i < t->d.largo; ++i) {
+                suma += p[i * paso_diagonal];
+            }
+            t->sumas[b] = suma;
+        }
+        return;
+    }
+
+    for (size_t b = desde; b < hasta; b += n) {
+        n = minimo(BLOQUE, hasta - b);
+        s = t->sumas + b;
+        for (size_t j = 0; j < n; ++j) {
+            s[j] = 0;
+        }
+        for (size_t i = 0; i < t->d.largo; ++i) {
+            p = inicio + i * paso_diagonal + b;
+            for (size_t j = 0; j < n; ++j) {
+                s[j] += p[j];
+            }
+        }
+    }
+}
+
+
+static void escalar_rango(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    const lote_t *l = t->l;
+    const size_t paso_diagonal = l->paso_fila + l->paso_columna;
+    const size_t paso = l->paso_lote;
+    const float *restrict f;
+    float *restrict p;
+    size_t n;
+
+    if (1 != paso) {
+        for (size_t b = desde; b < hasta; ++b) {
+            p = l->data + b * paso;
+            for (size_t i = 0; i < t->d.largo; ++i) {
+                p[i * paso_diagonal] *= t->factores[b];
+            }
+        }
+        return;
+    }
+
+    for (size_t b = desde; b < hasta; b += n) {
+        n = minimo(BLOQUE, hasta - b);
+        f = t->factores + b;
+        for (size_t i = 0; i < t->d.largo; ++i) {
+            p = l->data + i * paso_diagonal + b;
+            for (size_t j = 0; j < n; ++j) {
+                p[j] *= f[j];
+            }
+        }
+    }
+}
+
+
+static void sumar_rango_ptr(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    double s;
+
+    for (size_t b = desde; b < hasta; ++b) {
+        s = 0;
+        for (size_t i = 0; i < t->d.largo; ++i) {
+            s += t->m[b][t->d.fila + i][t->d.columna + i];
+        }
+        t->sumas[b] = s;
+    }
+}
+
+
+static void escalar_rango_ptr(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    for (size_t b = desde; b < hasta; ++b) {
+        for (size_t i = 0; i < t->d.largo; ++i) {
+            t->m[b][i][i] *= t->factores[b];
+        }
+    }
+}
+
+
+bool lote_init(lote_t *l, float *data, size_t cantidad, size_t filas, size_t columnas)
+{
+    if ((NULL == l) || (NULL == data)) {
+        return false;
+    }
+
+    l->data = data;
+    l->cantidad = cantidad;
+    l->filas = filas;
+    l->columnas = columnas;
+    l->paso_lote = filas * columnas;
+    l->paso_fila = columnas;
+    l->paso_columna = 1;
+
+    return true;
+}
+
+
+bool lote_init_intercalado(lote_t *l, float *data, size_t cantidad, size_t filas, size_t columnas)
+{
+    if ((NULL == l) || (NULL == data)) {
+        return false;
+    }
+
+    l->data = data;
+    l->cantidad = cantidad;
+    l->filas = filas;
+    l->columnas = columnas;
+    l->paso_lote = 1;
+    l->paso_fila = columnas * cantidad;
+    l->paso_columna = cantidad;
+
+    return true;
+}
+
+
+bool lote_suma_diagonal(const lote_t *l, long k, double sumas[], size_t hilos)
+{
+    trabajo_t t;
+
+    if ((NULL == l) || (NULL == l->data) || (NULL == sumas)) {
+        return false;
+    }
+
+    t.l = l;
+    t.d = diagonal(l->filas, l->columnas, k);
+    t.sumas = sumas;
+    repartir(sumar_rango, &t, l->cantidad, t.d.largo, hilos);
+
+    return true;
+}
+
+
+bool lote_traza(const lote_t *l, double trazas[], size_t hilos)
+{
+    if ((NULL == l) || (l->filas != l->columnas)) {
+        return false;
+    }
+
+    return lote_suma_diagonal(l, 0, trazas, hilos);
+}
+
+
+bool lote_escalar_diagonal(lote_t *l, const float factores[], size_t hilos)
+{
+    trabajo_t t;
+
+    if ((NULL == l) || (NULL == l->data) || (NULL == factores)) {
+        return false;
+    }
+
+    t.l = l;
+    t.d = diagonal(l->filas, l->columnas, 0);
+    t.factores = factores;
+    repartir(escalar_rango, &t, l->cantidad, t.d.largo, hilos);
+
+    return true;
+}
+
+
+bool lote_suma_diagonal_ptr(float **const matrices[], size_t cantidad, size_t filas, size_t columnas, long k,
+                            double sumas[], size_t hilos)
+{
+    trabajo_t t;
+
+    if ((NULL == matrices) || (NULL == sumas)) {
+        return false;
+    }
+
+    t.m = matrices;
+    t.d = diagonal(filas, columnas, k);
+    t.sumas = sumas;
+    repartir(sumar_rango_ptr, &t, cantidad, t.d.largo, hilos);
+
+    return true;
+}
+
+
+bool lote_traza_ptr(float **const matrices[], size_t cantidad, size_t n, double trazas[], size_t hilos)
+{
+    return lote_suma_diagonal_ptr(matrices, cantidad, n, n, 0, trazas, hilos);
+}
+
+
+bool lote_escalar_diagonal_ptr(float **const matrices[], size_t cantidad, size_t n, const float factores[],
+                               size_t hilos)
+{
+    trabajo_t t;
+
+    if ((NULL == matrices) || (NULL == factores)) {
+        return false;
+    }
+
+    t.m = matrices;
+    t.d = diagonal(n, n, 0);
+    t.factores = factores;
+    repartir(escalar_rango_ptr, &t, cantidad, t.d.largo, hilos);
+
+    return true;
+}
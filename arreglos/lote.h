@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Operaciones sobre la diagonal de un lote de muchas matrices pequeñas.
+ *
+ * Un lote_t describe `cantidad` matrices de `filas` x `columnas` floats dentro de un mismo bloque de memoria: el
+ * elemento (i, j) de la matriz b está en data[b * paso_lote + i * paso_fila + j * paso_columna]. Con lote_init las
+ * matrices quedan una a continuación de la otra (como float[cantidad][filas][columnas]); con lote_init_intercalado
+ * quedan intercaladas (como float[filas][columnas][cantidad]), de modo que el mismo elemento de matrices vecinas es
+ * contiguo en memoria.
+ *
+ * Los cálculos recorren la diagonal de a bloques de matrices y, para cada posición de la diagonal, avanzan sobre las
+ * matrices del bloque: con la disposición intercalada ese ciclo lee memoria contigua y se vectoriza. Las sumas se
+ * acumulan en double. El lote se reparte entre `hilos` hilos (0: uno por procesador) si hay trabajo suficiente.
+ *
+ * Las funciones `_ptr` hacen lo mismo con matrices de la forma `float **` (un arreglo de punteros a filas, como en
+ * ptr_array_2.c), que pueden estar en cualquier lugar de la memoria.
+ */
+
+typedef struct {
+    float *data;
+    size_t cantidad;
+    size_t filas;
+    size_t columnas;
+    size_t paso_lote;
+    size_t paso_fila;
+    size_t paso_columna;
+} lote_t;
+
+
+bool lote_init(lote_t *l, float *data, size_t cantidad, size_t filas, size_t columnas);
+bool lote_init_intercalado(lote_t *l, float *data, size_t cantidad, size_t filas, size_t columnas);
+
+/* traza de cada matriz (sólo matrices cuadradas) */
+bool lote_traza(const lote_t *l, double trazas[], size_t hilos);
+/* suma de la diagonal k de cada matriz: k > 0 por encima de la principal, k < 0 por debajo */
+bool lote_suma_diagonal(const lote_t *l, long k, double sumas[], size_t hilos);
+/* multiplica la diagonal principal de la matriz b por factores[b] */
+bool lote_escalar_diagonal(lote_t *l, const float factores[], size_t hilos);
+
+bool lote_traza_ptr(float **const matrices[], size_t cantidad, size_t n, double trazas[], size_t hilos);
+bool lote_suma_diagonal_ptr(float **const matrices[], size_t cantidad, size_t filas, size_t columnas, long k,
+                            double sumas[], size_t hilos);
+bool lote_escalar_diagonal_ptr(float **const matrices[], size_t cantidad, size_t n, const float factores[],
+                               size_t hilos);
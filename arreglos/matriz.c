@@ -0,0 +1,569 @@
+#include "matriz.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* scratch for the generic elimination lives on the stack up to this many elements */
+#define LOCAL (MATRIZ_MAX_DESENROLLADA * MATRIZ_MAX_DESENROLLADA)
+#define DESENROLLAR _Pragma("GCC unroll 64")
+
+
+/* one size, a whole batch per call */
+typedef struct {
+    void (*multiplicar)(double c[], const double a[], const double b[], size_t cantidad);
+    void (*trasponer)(double t[], const double a[], size_t cantidad);
+    void (*traza)(double trazas[], const double a[], size_t cantidad);
+    void (*determinante)(double dets[], const double a[], size_t cantidad);
+    void (*invertir)(double inv[], const double a[], size_t cantidad, bool invertible[]);
+} kernels_t;
+
+
+static void multiplicar(double c[], const double a[], const double b[], size_t n, size_t m, size_t p)
+{
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < p; ++j) {
+            c[i * p + j] = 0;
+        }
+        for (size_t k = 0; k < m; ++k) {
+            for (size_t j = 0; j < p; ++j) {
+                c[i * p + j] += a[i * m + k] * b[k * p + j];
+            }
+        }
+    }
+}
+
+
+static void trasponer(double t[], const double a[], size_t filas, size_t columnas)
+{
+    for (size_t i = 0; i < filas; ++i) {
+        for (size_t j = 0; j < columnas; ++j) {
+            t[j * filas + i] = a[i * columnas + j];
+        }
+    }
+}
+
+
+static double traza(const double a[], size_t n)
+{
+    double t = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        t += a[i * n + i];
+    }
+
+    return t;
+}
+
+
+static void intercambiar_filas(double x[], size_t n, size_t i, size_t k, size_t desde)
+{
+    double t;
+
+    for (size_t j = desde; j < n; ++j) {
+        t = x[k * n + j];
+        x[k * n + j] = x[i * n + j];
+        x[i * n + j] = t;
+    }
+}
+
+
+/*
+ * Forward elimination with partial pivoting, as the unrolled kernels do it: going down column k, every row with a
+ * larger value than the current pivot is swapped with the pivot row, so the largest one ends up there. The same row
+ * operations are applied to y (n x n) if it is not NULL. Leaves U in the upper triangle of x and the determinant in
+ * *det; false at the first zero pivot. The determinant and the inverse both come from here, so a matrix is singular
+ * for one exactly when it is for the other.
+ */
+static bool eliminar(double x[], size_t n, double y[], double *det)
+{
+    double f;
+
+    *det = 1;
+    for (size_t k = 0; k < n; ++k) {
+        for (size_t i = k + 1; i < n; ++i) {
+            if (fabs(x[i * n + k]) > fabs(x[k * n + k])) {
+                intercambiar_filas(x, n, i, k, k);
+                if (NULL != y) {
+                    intercambiar_filas(y, n, i, k, 0);
+                }
+                *det = -*det;
+            }
+        }
+        if (0 == x[k * n + k]) {
+            *det = 0;
+            return false;
+        }
+        *det *= x[k * n + k];
+        for (size_t i = k + 1; i < n; ++i) {
+            f = x[i * n + k] / x[k * n + k];
+            for (size_t j = k + 1; j < n; ++j) {
+                x[i * n + j] -= f * x[k * n + j];
+            }
+            if (NULL != y) {
+                for (size_t j = 0; j < n; ++j) {
+                    y[i * n + j] -= f * y[k * n + j];
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/* x is scratch (n x n) */
+static double determinante(const double a[], size_t n, double x[])
+{
+    double det;
+
+    memcpy(x, a, n * n * sizeof(double));
+    eliminar(x, n, NULL, &det);
+
+    return det;
+}
+
+
+/* the elimination applied to the identity leaves U y = L^-1 P, and back substitution turns y into the inverse */
+static bool invertir(double y[], const double a[], size_t n, double x[])
+{
+    double det;
+    double f;
+
+    memcpy(x, a, n * n * sizeof(double));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            y[i * n + j] = (i == j);
+        }
+    }
+
+    if (!eliminar(x, n, y, &det)) {
+        for (size_t j = 0; j < n * n; ++j) {
+            y[j] = NAN;
+        }
+        return false;
+    }
+
+    for (size_t k = n; k-- > 0;) {
+        for (size_t i = k + 1; i < n; ++i) {
+            f = x[k * n + i];
+            for (size_t j = 0; j < n; ++j) {
+                y[k * n + j] -= f * y[i * n + j];
+            }
+        }
+        f = 1 / x[k * n + k];
+        for (size_t j = 0; j < n; ++j) {
+            y[k * n + j] *= f;
+        }
+    }
+
+    return true;
+}
+
+
+#ifndef MATRIZ_GENERICA
+/*
+ * The same computations for a size N known at compile time. Every loop has constant bounds and is fully unrolled, so
+ * the matrices are local arrays indexed by constants that the compiler keeps in registers; the pivot row swaps are
+ * selects instead of branches, for the same reason. The arithmetic is done in the same order as above.
+ */
+#define MATRIZ_DEFINE(N)                                                                                            \
+static inline void cargar_##N(double x[N][N], const double a[])                                                     \
+{                                                                                                                   \
+    DESENROLLAR for (int i = 0; i < N; ++i) {                                                                       \
+        DESENROLLAR for (int j = 0; j < N; ++j) {                                                                   \
+            x[i][j] = a[i * N + j];                                                                                 \
+        }                                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static inline void guardar_##N(double c[], double z[N][N])                                                          \
+{                                                                                                                   \
+    DESENROLLAR for (int i = 0; i < N; ++i) {                                                                       \
+        DESENROLLAR for (int j = 0; j < N; ++j) {                                                                   \
+            c[i * N + j] = z[i][j];                                                                                 \
+        }                                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+/* rows k and i exchange their columns from `desde` on if s */                                                      \
+static inline void elegir_filas_##N(double x[N][N], int k, int i, int desde, bool s)                                \
+{                                                                                                                   \
+    double u;                                                                                                       \
+    double v;                                                                                                       \
+                                                                                                                    \
+    DESENROLLAR for (int j = desde; j < N; ++j) {                                                                   \
+        u = x[k][j];                                                                                                \
+        v = x[i][j];                                                                                                \
+        x[k][j] = s ? v : u;                                                                                        \
+        x[i][j] = s ? u : v;                                                                                        \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void multiplicar_##N(double c[], const double a[], const double b[], size_t cantidad)                        \
+{                                                                                                                   \
+    double x[N][N];                                                                                                 \
+    double y[N][N];                                                                                                 \
+    double z[N][N];                                                                                                 \
+                                                                                                                    \
+    for (size_t m = 0; m < cantidad; ++m) {                                                                         \
+        cargar_##N(x, a + m * N * N);                                                                               \
+        cargar_##N(y, b + m * N * N);                                                                               \
+        DESENROLLAR for (int i = 0; i < N; ++i) {                                                                   \
+            DESENROLLAR for (int j = 0; j < N; ++j) {                                                               \
+                z[i][j] = 0;                                                                                        \
+            }                                                                                                       \
+            DESENROLLAR for (int k = 0; k < N; ++k) {                                                               \
+                DESENROLLAR for (int j = 0; j < N; ++j) {                                                           \
+                    z[i][j] += x[i][k] * y[k][j];                                                                   \
+                }                                                                                                   \
+            }                                                                                                       \
+        }                                                                                                           \
+        guardar_##N(c + m * N * N, z);                                                                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+/* only the rows are unrolled: unrolling both loops, gcc interleaves matrices with long permutation chains */       \
+static void trasponer_##N(double t[], const double a[], size_t cantidad)                                            \
+{                                                                                                                   \
+    for (size_t m = 0; m < cantidad; ++m) {                                                                         \
+        for (int i = 0; i < N; ++i) {                                                                               \
+            DESENROLLAR for (int j = 0; j < N; ++j) {                                                               \
+                t[m * N * N + j * N + i] = a[m * N * N + i * N + j];                                                \
+            }                                                                                                       \
+        }                                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void traza_##N(double trazas[], const double a[], size_t cantidad)                                           \
+{                                                                                                                   \
+    double t;                                                                                                       \
+                                                                                                                    \
+    for (size_t m = 0; m < cantidad; ++m) {                                                                         \
+        t = 0;                                                                                                      \
+        DESENROLLAR for (int i = 0; i < N; ++i) {                                                                   \
+            t += a[m * N * N + i * N + i];                                                                          \
+        }                                                                                                           \
+        trazas[m] = t;                                                                                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+/* eliminar for size N, y untouched without `con_inversa`; gcc does not inline it on its own, so it is forced */    \
+static inline __attribute__((always_inline)) bool eliminar_##N(double x[N][N], double y[N][N], bool con_inversa,    \
+                                                             double *det)                                           \
+{                                                                                                                   \
+    double f;                                                                                                       \
+    bool s;                                                                                                         \
+                                                                                                                    \
+    *det = 1;                                                                                                       \
+    DESENROLLAR for (int k = 0; k < N; ++k) {                                                                       \
+        DESENROLLAR for (int i = k + 1; i < N; ++i) {                                                               \
+            s = fabs(x[i][k]) > fabs(x[k][k]);                                                                      \
+            elegir_filas_##N(x, k, i, k, s);                                                                        \
+            if (con_inversa) {                                                                                      \
+                elegir_filas_##N(y, k, i, 0, s);                                                                    \
+            }                                                                                                       \
+            *det = s ? -*det : *det;                                                                                \
+        }                                                                                                           \
+        if (0 == x[k][k]) {                                                                                         \
+            *det = 0;                                                                                               \
+            return false;                                                                                           \
+        }                                                                                                           \
+        *det *= x[k][k];                                                                                            \
+        DESENROLLAR for (int i = k + 1; i < N; ++i) {                                                               \
+            f = x[i][k] / x[k][k];                                                                                  \
+            DESENROLLAR for (int j = k + 1; j < N; ++j) {                                                           \
+                x[i][j] -= f * x[k][j];                                                                             \
+            }                                                                                                       \
+            if (con_inversa) {                                                                                      \
+                DESENROLLAR for (int j = 0; j < N; ++j) {                                                           \
+                    y[i][j] -= f * y[k][j];                                                                         \
+                }                                                                                                   \
+            }                                                                                                       \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static inline double determinante_uno_##N(const double a[])                                                         \
+{                                                                                                                   \
+    double x[N][N];                                                                                                 \
+    double det;                                                                                                     \
+                                                                                                                    \
+    cargar_##N(x, a);                                                                                               \
+    eliminar_##N(x, NULL, false, &det);                                                                             \
+                                                                                                                    \
+    return det;                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+static void determinante_##N(double dets[], const double a[], size_t cantidad)                                      \
+{                                                                                                                   \
+    for (size_t m = 0; m < cantidad; ++m) {                                                                         \
+        dets[m] = determinante_uno_##N(a + m * N * N);                                                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static inline bool invertir_uno_##N(double inv[], const double a[])                                                 \
+{                                                                                                                   \
+    double x[N][N];                                                                                                 \
+    double y[N][N];                                                                                                 \
+    double det;                                                                                                     \
+    double f;                                                                                                       \
+                                                                                                                    \
+    cargar_##N(x, a);                                                                                               \
+    DESENROLLAR for (int i = 0; i < N; ++i) {                                                                       \
+        DESENROLLAR for (int j = 0; j < N; ++j) {                                                                   \
+            y[i][j] = (i == j);                                                                                     \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    if (!eliminar_##N(x, y, true, &det)) {                                                                          \
+        for (int j = 0; j < N * N; ++j) {                                                                           \
+            inv[j] = NAN;                                                                                           \
+        }                                                                                                           \
+        return false;                                                                                               \
+    }                                                                                                               \
+    DESENROLLAR for (int k = N - 1; k >= 0; --k) {                                                                  \
+        DESENROLLAR for (int i = k + 1; i < N; ++i) {                                                               \
+            f = x[k][i];                                                                                            \
+            DESENROLLAR for (int j = 0; j < N; ++j) {                                                               \
+                y[k][j] -= f * y[i][j];                                                                             \
+            }                                                                                                       \
+        }                                                                                                           \
+        f = 1 / x[k][k];                                                                                            \
+        DESENROLLAR for (int j = 0; j < N; ++j) {                                                                   \
+            y[k][j] *= f;                                                                                           \
+        }                                                                                                           \
+    }                                                                                                               \
+    guardar_##N(inv, y);                                                                                            \
+                                                                                                                    \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void invertir_##N(double inv[], const double a[], size_t cantidad, bool invertible[])                        \
+{                                                                                                                   \
+    for (size_t m = 0; m < cantidad; ++m) {                                                                         \
+        invertible[m] = invertir_uno_##N(inv + m * N * N, a + m * N * N);                                           \
+    }                                                                                                               \
+}
+
+
+MATRIZ_DEFINE(2)
+MATRIZ_DEFINE(3)
+MATRIZ_DEFINE(4)
+MATRIZ_DEFINE(5)
+MATRIZ_DEFINE(6)
+MATRIZ_DEFINE(7)
+MATRIZ_DEFINE(8)
+
+
+#define KERNELS(N) {multiplicar_##N, trasponer_##N, traza_##N, determinante_##N, invertir_##N}
+
+static const kernels_t kernels[MATRIZ_MAX_DESENROLLADA + 1] = {
+    [2] = KERNELS(2),
+    [3] = KERNELS(3),
+    [4] = KERNELS(4),
+    [5] = KERNELS(5),
+    [6] = KERNELS(6),
+    [7] = KERNELS(7),
+    [8] = KERNELS(8),
+};
+#endif
+
+
+static const kernels_t *elegir(size_t n)
+{
+#ifdef MATRIZ_GENERICA
+    (void) n;
+    return NULL;
+#else
+    return ((n >= 2) && (n <= MATRIZ_MAX_DESENROLLADA)) ? &kernels[n] : NULL;
+#endif
+}
+
+
+static double *pedir(double local[], size_t elementos)
+{
+    return (elementos <= LOCAL) ? local : (double *) malloc(elementos * sizeof(double));
+}
+
+
+static void devolver(double *x, double local[])
+{
+    if (x != local) {
+        free(x);
+    }
+}
+
+
+bool matriz_multiplicar(double c[], const double a[], const double b[], size_t n, size_t m, size_t p)
+{
+    if ((NULL == c) || (NULL == a) || (NULL == b)) {
+        return false;
+    }
+
+    if ((n == m) && (m == p)) {
+        return matriz_multiplicar_lote(c, a, b, n, 1);
+    }
+
+    multiplicar(c, a, b, n, m, p);
+
+    return true;
+}
+
+
+bool matriz_trasponer(double t[], const double a[], size_t filas, size_t columnas)
+{
+    if ((NULL == t) || (NULL == a)) {
+        return false;
+    }
+
+    if (filas == columnas) {
+        return matriz_trasponer_lote(t, a, filas, 1);
+    }
+
+    trasponer(t, a, filas, columnas);
+
+    return true;
+}
+
+
+bool matriz_traza(const double a[], size_t n, double *t)
+{
+    return matriz_traza_lote(t, a, n, 1);
+}
+
+
+bool matriz_determinante(const double a[], size_t n, double *det)
+{
+    return matriz_determinante_lote(det, a, n, 1);
+}
+
+
+bool matriz_inversa(double inv[], const double a[], size_t n)
+{
+    bool invertible;
+
+    return matriz_inversa_lote(inv, a, n, 1, &invertible) && invertible;
+}
+
+
+bool matriz_multiplicar_lote(double c[], const double a[], const double b[], size_t n, size_t cantidad)
+{
+    const kernels_t *k = elegir(n);
+
+    if ((NULL == c) || (NULL == a) || (NULL == b)) {
+        return false;
+    }
+
+    if (NULL != k) {
+        k->multiplicar(c, a, b, cantidad);
+        return true;
+    }
+
+    for (size_t m = 0; m < cantidad; ++m) {
+        multiplicar(c + m * n * n, a + m * n * n, b + m * n * n, n, n, n);
+    }
+
+    return true;
+}
+
+
+bool matriz_trasponer_lote(double t[], const double a[], size_t n, size_t cantidad)
+{
+    const kernels_t *k = elegir(n);
+
+    if ((NULL == t) || (NULL == a)) {
+        return false;
+    }
+
+    if (NULL != k) {
+        k->trasponer(t, a, cantidad);
+        return true;
+    }
+
+    for (size_t m = 0; m < cantidad; ++m) {
+        trasponer(t + m * n * n, a + m * n * n, n, n);
+    }
+
+    return true;
+}
+
+
+bool matriz_traza_lote(double trazas[], const double a[], size_t n, size_t cantidad)
+{
+    const kernels_t *k = elegir(n);
+
+    if ((NULL == trazas) || (NULL == a)) {
+        return false;
+    }
+
+    if (NULL != k) {
+        k->traza(trazas, a, cantidad);
+        return true;
+    }
+
+    for (size_t m = 0; m < cantidad; ++m) {
+        trazas[m] = traza(a + m * n * n, n);
+    }
+
+    return true;
+}
+
+
+bool matriz_determinante_lote(double dets[], const double a[], size_t n, size_t cantidad)
+{
+    const kernels_t *k = elegir(n);
+    double local[LOCAL];
+    double *x;
+
+    if ((NULL == dets) || (NULL == a)) {
+        return false;
+    }
+
+    if (NULL != k) {
+        k->determinante(dets, a, cantidad);
+        return true;
+    }
+
+    x = pedir(local, n * n);
+    if (NULL == x) {
+        return false;
+    }
+    for (size_t m = 0; m < cantidad; ++m) {
+        dets[m] = determinante(a + m * n * n, n, x);
+    }
+    devolver(x, local);
+
+    return true;
+}
+
+
+bool matriz_inversa_lote(double inv[], const double a[], size_t n, size_t cantidad, bool invertible[])
+{
+    const kernels_t *k = elegir(n);
+    double local[LOCAL];
+    double *x;
+
+    if ((NULL == inv) || (NULL == a) || (NULL == invertible)) {
+        return false;
+    }
+
+    if (NULL != k) {
+        k->invertir(inv, a, cantidad, invertible);
+        return true;
+    }
+
+    x = pedir(local, n * n);
+    if (NULL == x) {
+        return false;
+    }
+    for (size_t m = 0; m < cantidad; ++m) {
+        invertible[m] = invertir(inv + m * n * n, a + m * n * n, n, x);
+    }
+    devolver(x, local);
+
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Operaciones sobre matrices de doubles guardadas por filas en un arreglo contiguo (como double m[filas][columnas]):
+ * el elemento (i, j) está en m[i * columnas + j].
+ *
+ * Para matrices cuadradas de 2 x 2 hasta MATRIZ_MAX_DESENROLLADA x MATRIZ_MAX_DESENROLLADA hay una versión de cada
+ * operación generada con una macro para ese tamaño: los ciclos tienen límites constantes y se desenrollan por
+ * completo, de modo que la matriz puede quedar en registros y el compilador vectoriza las filas. Las funciones eligen
+ * esa versión según el tamaño; para los demás tamaños usan ciclos comunes. Compilando con -DMATRIZ_GENERICA se
+ * usan siempre los ciclos comunes (para comparar).
+ *
+ * Las funciones `_lote` aplican la operación a `cantidad` matrices de n x n consecutivas (como double
+ * m[cantidad][n][n]) eligiendo la versión una sola vez, que es donde se nota la diferencia con matrices chicas.
+ *
+ * -   El determinante y la inversa usan la misma eliminación gaussiana con pivoteo parcial (el pivote de mayor valor
+ *     absoluto en cada columna), así que coinciden en qué matrices son singulares: aquéllas en que algún pivote es
+ *     exactamente 0. El determinante da 0 y la inversa queda llena de NaN.
+ * -   El resultado no puede superponerse con los operandos.
+ *
+ * Devuelven false si algún puntero es NULL, si no hay memoria (el determinante y la inversa de más de
+ * MATRIZ_MAX_DESENROLLADA filas la necesitan) o, matriz_inversa, si la matriz es singular.
+ */
+
+#define MATRIZ_MAX_DESENROLLADA 8
+
+
+/* c (n x p) = a (n x m) b (m x p) */
+bool matriz_multiplicar(double c[], const double a[], const double b[], size_t n, size_t m, size_t p);
+bool matriz_trasponer(double t[], const double a[], size_t filas, size_t columnas);
+bool matriz_traza(const double a[], size_t n, double *traza);
+bool matriz_determinante(const double a[], size_t n, double *det);
+bool matriz_inversa(double inv[], const double a[], size_t n);
+
+bool matriz_multiplicar_lote(double c[], const double a[], const double b[], size_t n, size_t cantidad);
+bool matriz_trasponer_lote(double t[], const double a[], size_t n, size_t cantidad);
+bool matriz_traza_lote(double trazas[], const double a[], size_t n, size_t cantidad);
+bool matriz_determinante_lote(double dets[], const double a[], size_t n, size_t cantidad);
+/* invertible[k] indica si la matriz k tiene inversa */
+bool matriz_inversa_lote(double inv[], const double a[], size_t n, size_t cantidad, bool invertible[]);
@@ -0,0 +1,400 @@
+#include "reducido.h"
+#include "../punteros/src/meand.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+/* elements converted at a time: three blocks of doubles fit in L1 */
+#define BLOQUE 1024
+
+/* arreglos/sum.c y arreglos/sumar.c */
+double sum(const double v[], size_t n);
+void sumar(double lhs[], const double rhs1[], const double rhs2[], size_t n);
+
+
+static size_t tamanio(reducido_formato_t formato)
+{
+    return (REDUCIDO_F32 == formato) ? sizeof(float) : sizeof(uint16_t);
+}
+
+
+static size_t minimo(size_t a, size_t b)
+{
+    return (a < b) ? a : b;
+}
+
+
+/*
+ * Rounding a double to the nearest float and then to half (or bfloat16) can round twice in the same direction: a
+ * double just below a tie of the half becomes the tie as a float, which then goes to even. Narrowing to float by
+ * rounding to odd instead (truncate, and set the last bit when something was lost) keeps that lost part visible, and
+ * float has more than 2 bits beyond both, so the second rounding gives the same result as rounding the double once.
+ * Without branches, so the loops that call it vectorize; NaN stays NaN.
+ */
+static inline float a_float_impar(double x)
+{
+    float f = (float) x;
+    uint32_t u;
+
+    memcpy(&u, &f, sizeof(u));
+    /* rounded away from zero (it may even be infinity): the truncated float is the previous one */
+    u -= (fabs((double) f) > fabs(x));
+    u |= ((double) f != x);
+    memcpy(&f, &u, sizeof(f));
+
+    return f;
+}
+
+
+/* x must come from a_float_impar */
+static uint16_t float_a_f16(float x)
+{
+    uint32_t u;
+    uint32_t signo;
+    uint32_t absoluto;
+
+    memcpy(&u, &x, sizeof(u));
+    signo = (u >> 16) & 0x8000;
+    absoluto = u & 0x7fffffff;
+
+    if (absoluto > 0x7f800000) {
+        return (uint16_t) (signo | 0x7e00);
+    }
+    /* 65520 and above round to infinity */
+    if (absoluto >= 0x477ff000) {
+        return (uint16_t) (signo | 0x7c00);
+    }
+    /* below 2^-14 the half is subnormal: its bits are the value in units of 2^-24 (1024 is the smallest normal) */
+    if (absoluto < 0x38800000) {
+        return (uint16_t) (signo | (uint32_t) lrintf(fabsf(x) * 0x1p24f));
+    }
+    /* rebias the exponent (127 to 15) and round the 23 bits of mantissa to 10, to even */
+    absoluto -= 0x38000000;
+    absoluto += 0xfff + ((absoluto >> 13) & 1);
+
+    return (uint16_t) (signo | (absoluto >> 13));
+}
+
+
+static float f16_a_float(uint16_t h)
+{
+    uint32_t signo = (uint32_t) (h & 0x8000) << 16;
+    uint32_t exponente = (h >> 10) & 0x1f;
+    uint32_t mantisa = h & 0x3ff;
+    uint32_t u;
+    float x;
+
+    if (0 == exponente) {
+        x = ldexpf((float) mantisa, -24);
+        return signo ? -x : x;
+    }
+    if (0x1f == exponente) {
+        u = signo | 0x7f800000 | (mantisa << 13);
+    } else {
+        u = signo | ((exponente + 112) << 23) | (mantisa << 13);
+    }
+    memcpy(&x, &u, sizeof(x));
+
+    return x;
+}
+
+
+/* without branches, so the loops that call it vectorize; NaN stays NaN (the quiet bit is set) */
+static inline uint16_t float_a_bf16(float x)
+{
+    uint32_t u;
+    uint32_t redondeado;
+
+    memcpy(&u, &x, sizeof(u));
+    redondeado = (u + 0x7fff + ((u >> 16) & 1)) >> 16;
+
+    return (uint16_t) (((u & 0x7fffffff) > 0x7f800000) ? ((u >> 16) | 0x40) : redondeado);
+}
+
+
+static inline float bf16_a_float(uint16_t b)
+{
+    uint32_t u = (uint32_t) b << 16;
+    float x;
+
+    memcpy(&x, &u, sizeof(x));
+
+    return x;
+}
+
+
+#ifdef __F16C__
+/* the 4 masks of a comparison of doubles, as 32 bit masks (both halves of each one are equal) */
+static inline __m128i mascara_32(__m256d m)
+{
+    __m256 f = _mm256_castpd_ps(m);
+
+    return _mm_castps_si128(_mm_shuffle_ps(_mm256_castps256_ps128(f), _mm256_extractf128_ps(f, 1),
+                                           _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+
+/* a_float_impar for 4 doubles; a true mask is -1, so adding it subtracts 1 */
+static inline __m128 a_float_impar_x4(__m256d x)
+{
+    __m256d signo = _mm256_set1_pd(-0.0);
+    __m128 f = _mm256_cvtpd_ps(x);
+    __m256d vuelta = _mm256_cvtps_pd(f);
+    __m256d lejos = _mm256_cmp_pd(_mm256_andnot_pd(signo, vuelta), _mm256_andnot_pd(signo, x), _CMP_GT_OQ);
+    __m256d inexacto = _mm256_cmp_pd(vuelta, x, _CMP_NEQ_UQ);
+    __m128i u = _mm_castps_si128(f);
+
+    u = _mm_add_epi32(u, mascara_32(lejos));
+    u = _mm_or_si128(u, _mm_and_si128(mascara_32(inexacto), _mm_set1_epi32(1)));
+
+    return _mm_castsi128_ps(u);
+}
+#endif
+
+
+static void guardar_f16(uint16_t h[], const double v[], size_t n)
+{
+    size_t i = 0;
+
+#ifdef __F16C__
+    __m128 bajo;
+    __m128 alto;
+    __m256 f;
+
+    for (; i + 8 <= n; i += 8) {
+        bajo = a_float_impar_x4(_mm256_loadu_pd(v + i));
+        alto = a_float_impar_x4(_mm256_loadu_pd(v + i + 4));
+        f = _mm256_insertf128_ps(_mm256_castps128_ps256(bajo), alto, 1);
+        _mm_storeu_si128((__m128i *) (h + i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    }
+#endif
+    for (; i < n; ++i) {
+        h[i] = float_a_f16(a_float_impar(v[i]));
+    }
+}
+
+
+static void leer_f16(double v[], const uint16_t h[], size_t n)
+{
+    size_t i = 0;
+
+#ifdef __F16C__
+    __m256 f;
+
+    for (; i + 8 <= n; i += 8) {
+        f = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) (h + i)));
+        _mm256_storeu_pd(v + i, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+        _mm256_storeu_pd(v + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+    }
+#endif
+    for (; i < n; ++i) {
+        v[i] = f16_a_float(h[i]);
+    }
+}
+
+
+static void guardar_bf16(uint16_t b[], const double v[], size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        b[i] = float_a_bf16(a_float_impar(v[i]));
+    }
+}
+
+
+static void leer_bf16(double v[], const uint16_t b[], size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = bf16_a_float(b[i]);
+    }
+}
+
+
+static void guardar_f32(float f[], const double v[], size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        f[i] = (float) v[i];
+    }
+}
+
+
+static void leer_f32(double v[], const float f[], size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = f[i];
+    }
+}
+
+
+/* reducido_guardar and reducido_leer without the checks */
+static void convertir_desde(reducido_t *r, size_t desde, const double v[], size_t n)
+{
+    switch (r->formato) {
+    case REDUCIDO_F32:
+        guardar_f32((float *) r->data + desde, v, n);
+        break;
+    case REDUCIDO_F16:
+        guardar_f16((uint16_t *) r->data + desde, v, n);
+        break;
+    case REDUCIDO_BF16:
+        guardar_bf16((uint16_t *) r->data + desde, v, n);
+        break;
+    }
+}
+
+
+static void convertir_hacia(double v[], const reducido_t *r, size_t desde, size_t n)
+{
+    switch (r->formato) {
+    case REDUCIDO_F32:
+        leer_f32(v, (const float *) r->data + desde, n);
+        break;
+    case REDUCIDO_F16:
+        leer_f16(v, (const uint16_t *) r->data + desde, n);
+        break;
+    case REDUCIDO_BF16:
+        leer_bf16(v, (const uint16_t *) r->data + desde, n);
+        break;
+    }
+}
+
+
+static bool valido(const reducido_t *r)
+{
+    return (NULL != r) && ((NULL != r->data) || (0 == r->n));
+}
+
+
+bool reducido_init(reducido_t *r, reducido_formato_t formato, size_t n)
+{
+    if ((NULL == r) || (formato > REDUCIDO_BF16) || (n > SIZE_MAX / sizeof(float))) {
+        return false;
+    }
+
+    r->data = NULL;
+    if ((n > 0) && (NULL == (r->data = malloc(n * tamanio(formato))))) {
+        return false;
+    }
+    r->n = n;
+    r->formato = formato;
+
+    return true;
+}
+
+
+void reducido_destroy(reducido_t *r)
+{
+    if (NULL == r) {
+        return;
+    }
+
+    free(r->data);
+    r->data = NULL;
+    r->n = 0;
+}
+
+
+size_t reducido_bytes(const reducido_t *r)
+{
+    return (NULL == r) ? 0 : r->n * tamanio(r->formato);
+}
+
+
+bool reducido_guardar(reducido_t *r, size_t desde, const double v[], size_t n)
+{
+    if (!valido(r) || (NULL == v) || (desde > r->n) || (n > r->n - desde)) {
+        return false;
+    }
+
+    convertir_desde(r, desde, v, n);
+
+    return true;
+}
+
+
+bool reducido_leer(double v[], const reducido_t *r, size_t desde, size_t n)
+{
+    if (!valido(r) || (NULL == v) || (desde > r->n) || (n > r->n - desde)) {
+        return false;
+    }
+
+    convertir_hacia(v, r, desde, n);
+
+    return true;
+}
+
+
+bool reducido_sum(const reducido_t *r, double *suma)
+{
+    double bloque[BLOQUE];
+    double s = 0;
+    size_t n;
+
+    if (!valido(r) || (NULL == suma)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < r->n; i += n) {
+        n = minimo(BLOQUE, r->n - i);
+        convertir_hacia(bloque, r, i, n);
+        s += sum(bloque, n);
+    }
+    *suma = s;
+
+    return true;
+}
+
+
+bool reducido_meand(const reducido_t *r, double *mean)
+{
+    double bloque[BLOQUE];
+    double weighted = 0;
+    double m;
+    size_t n;
+
+    if (!valido(r) || (NULL == mean) || (0 == r->n)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < r->n; i += n) {
+        n = minimo(BLOQUE, r->n - i);
+        convertir_hacia(bloque, r, i, n);
+        if (ST_OK != meand(&m, bloque, n)) {
+            return false;
+        }
+        /* every block's mean is weighted by its number of elements */
+        weighted += m * n;
+    }
+    *mean = weighted / r->n;
+
+    return true;
+}
+
+
+bool reducido_sumar(reducido_t *lhs, const reducido_t *rhs1, const reducido_t *rhs2)
+{
+    double a[BLOQUE];
+    double b[BLOQUE];
+    double c[BLOQUE];
+    size_t n;
+
+    if (!valido(lhs) || !valido(rhs1) || !valido(rhs2) || (lhs->n != rhs1->n) || (lhs->n != rhs2->n)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < lhs->n; i += n) {
+        n = minimo(BLOQUE, lhs->n - i);
+        convertir_hacia(a, rhs1, i, n);
+        convertir_hacia(b, rhs2, i, n);
+        sumar(c, a, b, n);
+        convertir_desde(lhs, i, c, n);
+    }
+
+    return true;
+}
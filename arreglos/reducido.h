@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Arreglo de números guardados con menos precisión que un double, para datos que no la necesitan (por ejemplo,
+ * mediciones con 3 cifras significativas): ocupan menos memoria y, como recorrer un arreglo grande está limitado por
+ * la memoria y no por el cálculo, también se recorren más rápido.
+ *
+ * | formato       | bytes | cifras significativas | rango                     |
+ * |---------------|-------|-----------------------|---------------------------|
+ * | REDUCIDO_F32  | 4     | ~7                    | como float                |
+ * | REDUCIDO_F16  | 2     | ~3.3 (error < 2^-11)  | ±65504 (6e-8 el menor)    |
+ * | REDUCIDO_BF16 | 2     | ~2.4 (error < 2^-8)   | como float                |
+ *
+ * REDUCIDO_F16 es el half de IEEE 754; REDUCIDO_BF16 es un float sin los 16 bits menos significativos. Al guardar
+ * cada double se redondea una sola vez al más cercano (a par en caso de empate), como si se convirtiera directamente:
+ * el paso intermedio por float redondea a impar, y no al más cercano, para no crear empates que el double no tenía.
+ * Lo que no entra en el rango de F16 queda como ±infinito. Compilando con -mf16c (o -march=native en una máquina
+ * que lo soporte) las conversiones de F16 se hacen de a 8 elementos con las instrucciones F16C; las de F32 y BF16
+ * las vectoriza el compilador (con -O3). test_reducido.c compara lo guardado con un redondeo de referencia.
+ *
+ * reducido_sum, reducido_meand y reducido_sumar son sum, meand y sumar sobre un arreglo reducido: lo recorren de a
+ * bloques que se convierten a double en un arreglo chico (que queda en la cache) y se pasan a la función original,
+ * que debe compilarse junto con reducido.c (sum.c, sumar.c y ../punteros/src/meand_st.c). Las cuentas se hacen en
+ * double. reducido_sumar guarda la suma de cada par redondeada al formato del resultado: la suma en double ya está
+ * redondeada a 53 bits, pero eso es más del doble de los 24 de un float más 2, así que redondearla de nuevo da lo
+ * mismo que redondear la suma exacta. Los operandos pueden tener distinto formato, y el resultado puede ser uno de
+ * ellos.
+ *
+ * Devuelven false si algún puntero es NULL, si no hay memoria, si el rango pedido se sale del arreglo o si los
+ * largos no coinciden; reducido_meand también si el arreglo está vacío.
+ */
+
+typedef enum {
+    REDUCIDO_F32,
+    REDUCIDO_F16,
+    REDUCIDO_BF16,
+} reducido_formato_t;
+
+
+typedef struct {
+    void *data;
+    size_t n;
+    reducido_formato_t formato;
+} reducido_t;
+
+
+bool reducido_init(reducido_t *r, reducido_formato_t formato, size_t n);
+void reducido_destroy(reducido_t *r);
+size_t reducido_bytes(const reducido_t *r);
+
+/* r[desde], ..., r[desde + n - 1] = v[0], ..., v[n - 1] */
+bool reducido_guardar(reducido_t *r, size_t desde, const double v[], size_t n);
+/* v[0], ..., v[n - 1] = r[desde], ..., r[desde + n - 1] */
+bool reducido_leer(double v[], const reducido_t *r, size_t desde, size_t n);
+
+bool reducido_sum(const reducido_t *r, double *suma);
+bool reducido_meand(const reducido_t *r, double *mean);
+bool reducido_sumar(reducido_t *lhs, const reducido_t *rhs1, const reducido_t *rhs2);
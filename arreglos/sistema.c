@@ -0,0 +1,835 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "sistema.h"
+
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+/* micro-kernel tile: its MR x NR accumulators fit in 12 AVX2 registers */
+#define MR 6
+#define NR 8
+/* packed blocks: MC x KC of A stays in L2, KC x NR of B in L1 and KC x NC of B in L3 */
+#define MC 72
+#define KC 256
+#define NC 2048
+/* a triangular solve walks this many columns of B at a time, so the rows it re-reads stay in cache */
+#define COLUMNAS 256
+/* rows of the symmetric update per product: the tile on the diagonal computes a whole square, so not much bigger */
+#define DIAGONAL (2 * MC)
+/* LU panels this narrow are factored one column at a time */
+#define PANEL_MINIMO 8
+#define MAX_HILOS 64
+/* below this many multiply-adds per thread, creating the thread costs more than it saves */
+#define MIN_TRABAJO (1UL << 22)
+/* thread ranges start at multiples of this: whole cache lines of a row, whole tiles of a column */
+#define ALINEACION 8
+
+
+/* matrix element (i, j) is p[i * paso_fila + j * paso_columna]: swapping the steps transposes it */
+typedef struct {
+    const double *p;
+    size_t paso_fila;
+    size_t paso_columna;
+} operando_t;
+
+
+typedef struct {
+    operando_t a;
+    operando_t b;
+    double *c;
+    size_t paso_c;
+    size_t n;
+    size_t k;
+    bool inferior;
+    bool unitaria;
+} trabajo_t;
+
+
+typedef bool (*rango_fn_t)(const trabajo_t *t, size_t desde, size_t hasta);
+
+
+typedef struct {
+    rango_fn_t fn;
+    const trabajo_t *t;
+    size_t desde;
+    size_t hasta;
+    pthread_t hilo;
+    bool lanzado;
+    bool ok;
+} parte_t;
+
+
+static size_t minimo(size_t a, size_t b)
+{
+    return (a < b) ? a : b;
+}
+
+
+static operando_t por_filas(const double *p, size_t paso)
+{
+    operando_t o = {p, paso, 1};
+
+    return o;
+}
+
+
+static operando_t traspuesto(operando_t o)
+{
+    operando_t t = {o.p, o.paso_columna, o.paso_fila};
+
+    return t;
+}
+
+
+/* the submatrix that starts at (i, j) */
+static operando_t desde_elemento(operando_t o, size_t i, size_t j)
+{
+    o.p += i * o.paso_fila + j * o.paso_columna;
+
+    return o;
+}
+
+
+static inline double elemento(operando_t o, size_t i, size_t j)
+{
+    return o.p[i * o.paso_fila + j * o.paso_columna];
+}
+
+
+static void *correr_parte(void *arg)
+{
+    parte_t *p = (parte_t *) arg;
+
+    p->ok = p->fn(p->t, p->desde, p->hasta);
+
+    return NULL;
+}
+
+
+/*
+ * Splits [0, cantidad) in contiguous ranges, one per thread; the calling thread takes the first one. `por_unidad` is
+ * the work of each unit (to decide how many threads are worth it). With `triangular` unit i costs about i (the rows
+ * of a lower triangle), so the ranges get shorter towards the end.
+ */
+static bool repartir(rango_fn_t fn, const trabajo_t *t, size_t cantidad, size_t por_unidad, size_t hilos,
+                     bool triangular)
+{
+    parte_t partes[MAX_HILOS];
+    size_t trabajo = cantidad * (por_unidad ? por_unidad : 1);
+    double fraccion;
+    size_t hasta;
+    bool ok = true;
+    long cpus;
+
+    if (0 == hilos) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = (cpus > 0) ? (size_t) cpus : 1;
+    }
+    hilos = minimo(minimo(hilos, MAX_HILOS), minimo(cantidad / ALINEACION + 1, trabajo / MIN_TRABAJO + 1));
+
+    if (hilos <= 1) {
+        return fn(t, 0, cantidad);
+    }
+
+    for (size_t h = 0; h < hilos; ++h) {
+        fraccion = (double) (h + 1) / hilos;
+        hasta = (size_t) (cantidad * (triangular ? sqrt(fraccion) : fraccion)) / ALINEACION * ALINEACION;
+        partes[h].fn = fn;
+        partes[h].t = t;
+        partes[h].desde = (0 == h) ? 0 : partes[h - 1].hasta;
+        partes[h].hasta = (h + 1 == hilos) ? cantidad : minimo(cantidad, (hasta > partes[h].desde) ? hasta
+                                                                                                  : partes[h].desde);
+        partes[h].lanzado = false;
+    }
+
+    for (size_t h = 1; h < hilos; ++h) {
+        partes[h].lanzado = (0 == pthread_create(&partes[h].hilo, NULL, correr_parte, &partes[h]));
+    }
+
+    /* a range whose thread could not be created is done here, so the result is always complete */
+    for (size_t h = 0; h < hilos; ++h) {
+        if (!partes[h].lanzado) {
+            correr_parte(&partes[h]);
+        }
+    }
+    for (size_t h = 1; h < hilos; ++h) {
+        if (partes[h].lanzado) {
+            pthread_join(partes[h].hilo, NULL);
+        }
+    }
+    for (size_t h = 0; h < hilos; ++h) {
+        ok = ok && partes[h].ok;
+    }
+
+    return ok;
+}
+
+
+/* m x k of A in panels of MR rows (padded with zeros): element (i, kk) at (i / MR) * MR * k + kk * MR + i % MR */
+static void empaquetar_a(double *restrict ap, operando_t a, size_t m, size_t k)
+{
+    for (size_t i = 0; i < m; i += MR) {
+        for (size_t kk = 0; kk < k; ++kk) {
+            for (size_t r = 0; r < MR; ++r) {
+                *ap++ = (i + r < m) ? elemento(a, i + r, kk) : 0;
+            }
+        }
+    }
+}
+
+
+/* k x n of B in panels of NR columns (padded with zeros): element (kk, j) at (j / NR) * NR * k + kk * NR + j % NR */
+static void empaquetar_b(double *restrict bp, operando_t b, size_t k, size_t n)
+{
+    for (size_t j = 0; j < n; j += NR) {
+        for (size_t kk = 0; kk < k; ++kk) {
+            for (size_t c = 0; c < NR; ++c) {
+                *bp++ = (j + c < n) ? elemento(b, kk, j + c) : 0;
+            }
+        }
+    }
+}
+
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+/* c (MR x NR) -= ap bp: per step, two rows of 4 of B times each element of the column of A, broadcast */
+static void restar_tile(size_t k, const double *restrict ap, const double *restrict bp, double *restrict c,
+                        size_t paso_c)
+{
+    __m256d acc[MR][2];
+    __m256d b0;
+    __m256d b1;
+    __m256d x;
+
+    _Pragma("GCC unroll 6")
+    for (size_t r = 0; r < MR; ++r) {
+        acc[r][0] = _mm256_setzero_pd();
+        acc[r][1] = _mm256_setzero_pd();
+    }
+    for (size_t kk = 0; kk < k; ++kk) {
+        b0 = _mm256_loadu_pd(bp + kk * NR);
+        b1 = _mm256_loadu_pd(bp + kk * NR + 4);
+        _Pragma("GCC unroll 6")
+        for (size_t r = 0; r < MR; ++r) {
+            x = _mm256_broadcast_sd(ap + kk * MR + r);
+            acc[r][0] = _mm256_fmadd_pd(x, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_pd(x, b1, acc[r][1]);
+        }
+    }
+    _Pragma("GCC unroll 6")
+    for (size_t r = 0; r < MR; ++r) {
+        _mm256_storeu_pd(c + r * paso_c, _mm256_sub_pd(_mm256_loadu_pd(c + r * paso_c), acc[r][0]));
+        _mm256_storeu_pd(c + r * paso_c + 4, _mm256_sub_pd(_mm256_loadu_pd(c + r * paso_c + 4), acc[r][1]));
+    }
+}
+
+#else
+
+/* c (MR x NR) -= ap bp; with constant bounds the compiler keeps acc in registers */
+static void restar_tile(size_t k, const double *restrict ap, const double *restrict bp, double *restrict c,
+                        size_t paso_c)
+{
+    double acc[MR][NR] = {{0}};
+
+    for (size_t kk = 0; kk < k; ++kk) {
+        _Pragma("GCC unroll 6")
+        for (size_t r = 0; r < MR; ++r) {
+            _Pragma("GCC unroll 8")
+            for (size_t j = 0; j < NR; ++j) {
+                acc[r][j] += ap[kk * MR + r] * bp[kk * NR + j];
+            }
+        }
+    }
+    for (size_t r = 0; r < MR; ++r) {
+        for (size_t j = 0; j < NR; ++j) {
+            c[r * paso_c + j] -= acc[r][j];
+        }
+    }
+}
+
+#endif
+
+
+/* a tile cut by the edge of C goes through a full one and only the part inside C is copied back */
+static void micronucleo(size_t k, const double *ap, const double *bp, double *c, size_t paso_c, size_t m, size_t n)
+{
+    double tile[MR * NR] = {0};
+
+    if ((MR == m) && (NR == n)) {
+        restar_tile(k, ap, bp, c, paso_c);
+        return;
+    }
+
+    restar_tile(k, ap, bp, tile, NR);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            c[i * paso_c + j] += tile[i * NR + j];
+        }
+    }
+}
+
+
+/* C (m x n) -= A (m x k) B (k x n), one block of each that fits in cache at a time */
+static bool producto(size_t m, size_t n, size_t k, operando_t a, operando_t b, double *c, size_t paso_c)
+{
+    size_t ancho = minimo(NC, (n + NR - 1) / NR * NR);
+    double *ap;
+    double *bp;
+    size_t nb;
+    size_t kb;
+    size_t mb;
+
+    if ((0 == m) || (0 == n) || (0 == k)) {
+        return true;
+    }
+
+    ap = (double *) malloc((MC + MR) * KC * sizeof(double));
+    bp = (double *) malloc(KC * ancho * sizeof(double));
+    if ((NULL == ap) || (NULL == bp)) {
+        free(ap);
+        free(bp);
+        return false;
+    }
+
+    for (size_t j0 = 0; j0 < n; j0 += nb) {
+        nb = minimo(NC, n - j0);
+        for (size_t k0 = 0; k0 < k; k0 += kb) {
+            kb = minimo(KC, k - k0);
+            empaquetar_b(bp, desde_elemento(b, k0, j0), kb, nb);
+            for (size_t i0 = 0; i0 < m; i0 += mb) {
+                mb = minimo(MC, m - i0);
+                empaquetar_a(ap, desde_elemento(a, i0, k0), mb, kb);
+                for (size_t j = 0; j < nb; j += NR) {
+                    for (size_t i = 0; i < mb; i += MR) {
+                        micronucleo(kb, ap + i * kb, bp + j * kb, c + (i0 + i) * paso_c + j0 + j, paso_c,
+                                    minimo(MR, mb - i), minimo(NR, nb - j));
+                    }
+                }
+            }
+        }
+    }
+
+    free(ap);
+    free(bp);
+
+    return true;
+}
+
+
+static bool producto_filas(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    return producto(hasta - desde, t->n, t->k, desde_elemento(t->a, desde, 0), t->b, t->c + desde * t->paso_c,
+                    t->paso_c);
+}
+
+
+/* C (m x n) -= A (m x k) B (k x n), with the rows of C split among the threads */
+static bool restar_producto(size_t m, size_t n, size_t k, operando_t a, operando_t b, double *c, size_t paso_c,
+                            size_t hilos)
+{
+    trabajo_t t = {.a = a, .b = b, .c = c, .paso_c = paso_c, .n = n, .k = k};
+
+    return repartir(producto_filas, &t, m, n * k, hilos, false);
+}
+
+
+/* T X = C by substitution on columns [desde, hasta) of C; T is k x k, lower or upper, with or without unit diagonal */
+static bool triangular_columnas(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    const size_t m = t->k;
+    double *restrict fila;
+    const double *restrict otra;
+    double factor;
+    size_t ancho;
+    size_t i;
+
+    for (size_t j0 = desde; j0 < hasta; j0 += ancho) {
+        ancho = minimo(COLUMNAS, hasta - j0);
+        for (size_t s = 0; s < m; ++s) {
+            i = t->inferior ? s : m - 1 - s;
+            fila = t->c + i * t->paso_c + j0;
+            for (size_t r = t->inferior ? 0 : i + 1; r < (t->inferior ? i : m); ++r) {
+                factor = elemento(t->a, i, r);
+                otra = t->c + r * t->paso_c + j0;
+                for (size_t j = 0; j < ancho; ++j) {
+                    fila[j] -= factor * otra[j];
+                }
+            }
+            if (!t->unitaria) {
+                factor = elemento(t->a, i, i);
+                for (size_t j = 0; j < ancho; ++j) {
+                    fila[j] /= factor;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/*
+ * T X = B in place, T m x m triangular: SISTEMA_BLOQUE rows of X at a time by substitution (the columns split among
+ * the threads), then the rows still to solve are updated with a matrix product.
+ */
+static bool resolver_triangular(operando_t tri, bool inferior, bool unitaria, size_t m, double *b, size_t columnas,
+                                size_t hilos)
+{
+    trabajo_t t = {.paso_c = columnas, .inferior = inferior, .unitaria = unitaria};
+    size_t i0;
+    size_t ib;
+
+    for (size_t s = 0; s < m; s += ib) {
+        ib = minimo(SISTEMA_BLOQUE, m - s);
+        i0 = inferior ? s : m - s - ib;
+        t.a = desde_elemento(tri, i0, i0);
+        t.c = b + i0 * columnas;
+        t.k = ib;
+        repartir(triangular_columnas, &t, columnas, ib * ib / 2, hilos, false);
+
+        if (inferior && !restar_producto(m - i0 - ib, columnas, ib, desde_elemento(tri, i0 + ib, i0),
+                                         por_filas(t.c, columnas), t.c + ib * columnas, columnas, hilos)) {
+            return false;
+        }
+        if (!inferior && !restar_producto(i0, columnas, ib, desde_elemento(tri, 0, i0), por_filas(t.c, columnas), b,
+                                          columnas, hilos)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void intercambiar_filas(double a[], size_t columnas, size_t i, size_t j)
+{
+    double *restrict x = a + i * columnas;
+    double *restrict y = a + j * columnas;
+    double z;
+
+    for (size_t k = 0; k < columnas; ++k) {
+        z = x[k];
+        x[k] = y[k];
+        y[k] = z;
+    }
+}
+
+
+/*
+ * Column j of the LU: the pivot is the largest in absolute value from row j down, and its row is swapped with row j
+ * across the whole matrix (the L already computed and the columns not reached yet too, as LAPACK does with dlaswp).
+ * The elimination only updates the columns up to `hasta`; the rest is updated later by blocks.
+ */
+static void columna_lu(double a[], size_t n, size_t j, size_t hasta, size_t pivotes[], bool *singular)
+{
+    size_t p = j;
+    double pivote;
+    double factor;
+
+    for (size_t i = j + 1; i < n; ++i) {
+        if (fabs(a[i * n + j]) > fabs(a[p * n + j])) {
+            p = i;
+        }
+    }
+    pivotes[j] = p;
+    if (p != j) {
+        intercambiar_filas(a, n, j, p);
+    }
+
+    pivote = a[j * n + j];
+    if (0 == pivote) {
+        *singular = true;
+        return;
+    }
+    for (size_t i = j + 1; i < n; ++i) {
+        a[i * n + j] /= pivote;
+        factor = a[i * n + j];
+        for (size_t k = j + 1; k < hasta; ++k) {
+            a[i * n + k] -= factor * a[j * n + k];
+        }
+    }
+}
+
+
+/*
+ * Columns [c, c + w) of the LU, rows c to n: the left half is factored, the rows of the right half next to it are
+ * solved with its L, the rest of the right half is updated with a product, and then the right half is factored. All
+ * but the narrowest panels go through the product, which is where the work is.
+ */
+static bool panel_lu(double a[], size_t n, size_t c, size_t w, size_t pivotes[], bool *singular)
+{
+    trabajo_t t = {.paso_c = n, .inferior = true, .unitaria = true};
+    size_t w1 = w / 2;
+    size_t w2 = w - w1;
+
+    if (w <= PANEL_MINIMO) {
+        for (size_t j = c; j < c + w; ++j) {
+            columna_lu(a, n, j, c + w, pivotes, singular);
+        }
+        return true;
+    }
+
+    if (!panel_lu(a, n, c, w1, pivotes, singular)) {
+        return false;
+    }
+    t.a = por_filas(a + c * n + c, n);
+    t.c = a + c * n + c + w1;
+    t.k = w1;
+    triangular_columnas(&t, 0, w2);
+    if (!producto(n - c - w1, w2, w1, por_filas(a + (c + w1) * n + c, n), por_filas(a + c * n + c + w1, n),
+                  a + (c + w1) * n + c + w1, n)) {
+        return false;
+    }
+
+    return panel_lu(a, n, c + w1, w2, pivotes, singular);
+}
+
+
+bool lu_factorizar(double a[], size_t n, size_t pivotes[], size_t hilos)
+{
+    trabajo_t t = {.paso_c = n, .inferior = true, .unitaria = true};
+    bool singular = false;
+    size_t jb;
+    size_t resto;
+
+    if ((NULL == a) || (NULL == pivotes)) {
+        return false;
+    }
+
+    for (size_t j = 0; j < n; j += jb) {
+        jb = minimo(SISTEMA_BLOQUE, n - j);
+        resto = n - j - jb;
+        if (!panel_lu(a, n, j, jb, pivotes, &singular)) {
+            return false;
+        }
+
+        /* U12 = L11^-1 A12, then A22 -= L21 U12 */
+        t.a = por_filas(a + j * n + j, n);
+        t.c = a + j * n + j + jb;
+        t.k = jb;
+        repartir(triangular_columnas, &t, resto, jb * jb / 2, hilos, false);
+        if (!restar_producto(resto, resto, jb, por_filas(a + (j + jb) * n + j, n), por_filas(t.c, n),
+                             a + (j + jb) * n + j + jb, n, hilos)) {
+            return false;
+        }
+    }
+
+    return !singular;
+}
+
+
+bool lu_resolver(const double lu[], size_t n, const size_t pivotes[], double b[], size_t columnas, size_t hilos)
+{
+    if ((NULL == lu) || (NULL == pivotes) || (NULL == b)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (pivotes[i] != i) {
+            intercambiar_filas(b, columnas, i, pivotes[i]);
+        }
+    }
+
+    return resolver_triangular(por_filas(lu, n), true, true, n, b, columnas, hilos) &&
+           resolver_triangular(por_filas(lu, n), false, false, n, b, columnas, hilos);
+}
+
+
+/* the product is kept as mantissa and exponent, so it only overflows (or underflows) at the very end */
+bool lu_determinante(const double lu[], size_t n, const size_t pivotes[], double *det)
+{
+    double mantisa = 1;
+    long exponente = 0;
+    int e;
+
+    if ((NULL == lu) || (NULL == pivotes) || (NULL == det)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        mantisa *= (pivotes[i] != i) ? -lu[i * n + i] : lu[i * n + i];
+        mantisa = frexp(mantisa, &e);
+        exponente += e;
+    }
+    exponente = (exponente > INT_MAX / 2) ? INT_MAX / 2 : (exponente < INT_MIN / 2) ? INT_MIN / 2 : exponente;
+    *det = ldexp(mantisa, (int) exponente);
+
+    return true;
+}
+
+
+bool lu_log_determinante(const double lu[], size_t n, const size_t pivotes[], double *log_det, int *signo)
+{
+    double suma = 0;
+    int s = 1;
+
+    if ((NULL == lu) || (NULL == pivotes) || (NULL == log_det) || (NULL == signo)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        suma += log(fabs(lu[i * n + i]));
+        s *= ((lu[i * n + i] < 0) != (pivotes[i] != i)) ? -1 : 1;
+        if (0 == lu[i * n + i]) {
+            s = 0;
+        }
+    }
+    *log_det = suma;
+    *signo = s;
+
+    return true;
+}
+
+
+static void identidad(double m[], size_t n)
+{
+    memset(m, 0, n * n * sizeof(double));
+    for (size_t i = 0; i < n; ++i) {
+        m[i * n + i] = 1;
+    }
+}
+
+
+bool lu_inversa(double inv[], const double lu[], size_t n, const size_t pivotes[], size_t hilos)
+{
+    if (NULL == inv) {
+        return false;
+    }
+
+    identidad(inv, n);
+
+    return lu_resolver(lu, n, pivotes, inv, n, hilos);
+}
+
+
+/* the diagonal block, column by column, with dot products along rows (which are contiguous) */
+static bool cholesky_bloque(double a[], size_t n, size_t j, size_t jb)
+{
+    double d;
+    double s;
+
+    for (size_t k = j; k < j + jb; ++k) {
+        d = a[k * n + k];
+        for (size_t m = j; m < k; ++m) {
+            d -= a[k * n + m] * a[k * n + m];
+        }
+        /* also false for NaN */
+        if (!(d > 0)) {
+            return false;
+        }
+        d = sqrt(d);
+        a[k * n + k] = d;
+        for (size_t i = k + 1; i < j + jb; ++i) {
+            s = a[i * n + k];
+            for (size_t m = j; m < k; ++m) {
+                s -= a[i * n + m] * a[k * n + m];
+            }
+            a[i * n + k] = s / d;
+        }
+    }
+
+    return true;
+}
+
+
+/*
+ * X L^T = X in place for `filas` rows of X, L w x w lower triangular: the left half of the columns is solved, the right
+ * half is updated with the product (L^T is L read with its steps swapped) and then solved, as in panel_lu.
+ */
+static bool resolver_derecha(double *x, size_t paso, size_t filas, operando_t l, size_t w)
+{
+    double *restrict fila;
+    double s;
+    size_t w1 = w / 2;
+
+    if (w <= PANEL_MINIMO) {
+        for (size_t i = 0; i < filas; ++i) {
+            fila = x + i * paso;
+            for (size_t k = 0; k < w; ++k) {
+                s = fila[k];
+                for (size_t m = 0; m < k; ++m) {
+                    s -= fila[m] * elemento(l, k, m);
+                }
+                fila[k] = s / elemento(l, k, k);
+            }
+        }
+        return true;
+    }
+
+    return resolver_derecha(x, paso, filas, l, w1) &&
+           producto(filas, w - w1, w1, por_filas(x, paso), traspuesto(desde_elemento(l, w1, 0)), x + w1, paso) &&
+           resolver_derecha(x + w1, paso, filas, desde_elemento(l, w1, w1), w - w1);
+}
+
+
+/* rows [desde, hasta) of L21 = A21 L11^-T */
+static bool cholesky_filas(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    return resolver_derecha(t->c + desde * t->paso_c, t->paso_c, hasta - desde, t->a, t->k);
+}
+
+
+/*
+ * Rows [desde, hasta) of the lower triangle of C -= L21 L21^T, DIAGONAL rows at a time: the part left of the diagonal
+ * with the product (L21^T is L21 with its steps swapped), and the tile on the diagonal too, but into a square of its
+ * own, from which only the lower half is copied.
+ */
+static bool simetrica_filas(const trabajo_t *t, size_t desde, size_t hasta)
+{
+    double tile[DIAGONAL * DIAGONAL];
+    size_t e;
+
+    for (size_t i0 = desde; i0 < hasta; i0 = e) {
+        e = minimo(i0 + DIAGONAL, hasta);
+        memset(tile, 0, sizeof(tile));
+        if (!producto(e - i0, i0, t->k, desde_elemento(t->a, i0, 0), traspuesto(t->a), t->c + i0 * t->paso_c,
+                      t->paso_c) ||
+            !producto(e - i0, e - i0, t->k, desde_elemento(t->a, i0, 0), traspuesto(desde_elemento(t->a, i0, 0)),
+                      tile, DIAGONAL)) {
+            return false;
+        }
+        for (size_t i = 0; i < e - i0; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                t->c[(i0 + i) * t->paso_c + i0 + j] += tile[i * DIAGONAL + j];
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool cholesky_factorizar(double a[], size_t n, size_t hilos)
+{
+    trabajo_t t = {.paso_c = n};
+    size_t jb;
+    size_t resto;
+
+    if (NULL == a) {
+        return false;
+    }
+
+    for (size_t j = 0; j < n; j += jb) {
+        jb = minimo(SISTEMA_BLOQUE, n - j);
+        resto = n - j - jb;
+        if (!cholesky_bloque(a, n, j, jb)) {
+            return false;
+        }
+
+        t.a = por_filas(a + j * n + j, n);
+        t.c = a + (j + jb) * n + j;
+        t.k = jb;
+        if (!repartir(cholesky_filas, &t, resto, jb * jb / 2, hilos, false)) {
+            return false;
+        }
+
+        t.a = por_filas(a + (j + jb) * n + j, n);
+        t.c = a + (j + jb) * n + j + jb;
+        if (!repartir(simetrica_filas, &t, resto, resto * jb / 2, hilos, true)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* L Y = B and then L^T X = Y: L^T is L read with its steps swapped */
+bool cholesky_resolver(const double l[], size_t n, double b[], size_t columnas, size_t hilos)
+{
+    if ((NULL == l) || (NULL == b)) {
+        return false;
+    }
+
+    return resolver_triangular(por_filas(l, n), true, false, n, b, columnas, hilos) &&
+           resolver_triangular(traspuesto(por_filas(l, n)), false, false, n, b, columnas, hilos);
+}
+
+
+bool cholesky_log_determinante(const double l[], size_t n, double *log_det)
+{
+    double suma = 0;
+
+    if ((NULL == l) || (NULL == log_det)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        suma += log(l[i * n + i]);
+    }
+    *log_det = 2 * suma;
+
+    return true;
+}
+
+
+bool cholesky_inversa(double inv[], const double l[], size_t n, size_t hilos)
+{
+    if (NULL == inv) {
+        return false;
+    }
+
+    identidad(inv, n);
+
+    return cholesky_resolver(l, n, inv, n, hilos);
+}
+
+
+/* infinity norm: the largest sum of absolute values of a row */
+static double norma(const double m[], size_t filas, size_t columnas)
+{
+    double maxima = 0;
+    double s;
+
+    for (size_t i = 0; i < filas; ++i) {
+        s = 0;
+        for (size_t j = 0; j < columnas; ++j) {
+            s += fabs(m[i * columnas + j]);
+        }
+        maxima = fmax(maxima, s);
+    }
+
+    return maxima;
+}
+
+
+bool sistema_residuo(const double a[], size_t n, const double x[], const double b[], size_t columnas, size_t hilos,
+                     double *residuo)
+{
+    double *r;
+    double escala;
+
+    if ((NULL == a) || (NULL == x) || (NULL == b) || (NULL == residuo)) {
+        return false;
+    }
+    if ((0 == n) || (0 == columnas)) {
+        *residuo = 0;
+        return true;
+    }
+
+    r = (double *) malloc(n * columnas * sizeof(double));
+    if (NULL == r) {
+        return false;
+    }
+    memcpy(r, b, n * columnas * sizeof(double));
+    if (!restar_producto(n, columnas, n, por_filas(a, n), por_filas(x, columnas), r, columnas, hilos)) {
+        free(r);
+        return false;
+    }
+
+    escala = norma(a, n, n) * norma(x, n, columnas) + norma(b, n, columnas);
+    *residuo = (escala > 0) ? norma(r, n, columnas) / escala : norma(r, n, columnas);
+    free(r);
+
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Sistemas de ecuaciones lineales densos A X = B, con las matrices guardadas por filas en arreglos contiguos (como
+ * double a[n][n]; B y X son de n x `columnas`), para n de miles.
+ *
+ * -   lu_factorizar reemplaza A por su factorización P A = L U con pivoteo parcial: U queda en el triángulo superior
+ *     y L (con unos en la diagonal, que no se guardan) debajo. pivotes[i] es la fila que se intercambió con la i en
+ *     el paso i, como en LAPACK. Si algún pivote es exactamente 0 la matriz es singular: la factorización se completa
+ *     igual (el determinante da 0), pero lu_factorizar devuelve false.
+ * -   cholesky_factorizar reemplaza el triángulo inferior de una matriz simétrica definida positiva por L, con
+ *     A = L L^T; sólo lee y escribe ese triángulo. Devuelve false si la matriz no es definida positiva.
+ * -   Las funciones `_resolver` reemplazan B por X usando la factorización, y las `_inversa` calculan A^-1 (resolviendo
+ *     con B = I).
+ * -   El determinante de una matriz grande suele salirse del rango de un double: lu_determinante lo calcula sin
+ *     desbordar en el medio (el resultado puede ser inf o 0); las versiones `_log_` devuelven log |det A| y su signo
+ *     (con Cholesky siempre es positivo).
+ * -   sistema_residuo mide qué tan bien resuelve X el sistema: |A X - B| / (|A| |X| + |B|), con la norma infinito
+ *     (la mayor suma de valores absolutos de una fila). Una solución calculada de forma estable da un número del
+ *     orden del épsilon de la máquina (1e-16), aunque el error de X pueda ser mucho mayor si A está mal condicionada.
+ *
+ * Las factorizaciones van por bloques de SISTEMA_BLOQUE columnas, de izquierda a derecha (right-looking): se factoriza
+ * el bloque de columnas (LU recursivamente, partiéndolo por la mitad), se resuelven las filas del bloque a su derecha,
+ * y se actualiza el resto de la matriz con un producto de matrices, donde está casi todo el cálculo. Ese producto se
+ * hace por bloques que entran en la cache, copiando cada bloque de modo que un micronúcleo de 6 x 8 elementos
+ * (con instrucciones AVX2 y FMA si están disponibles: -march=native) lo recorra en orden, y se reparte por filas entre
+ * `hilos` hilos (0: uno por procesador) si hay trabajo suficiente.
+ *
+ * Devuelven false si algún puntero es NULL o si no hay memoria (para las copias de los bloques).
+ */
+
+#define SISTEMA_BLOQUE 128
+
+
+bool lu_factorizar(double a[], size_t n, size_t pivotes[], size_t hilos);
+bool lu_resolver(const double lu[], size_t n, const size_t pivotes[], double b[], size_t columnas, size_t hilos);
+bool lu_determinante(const double lu[], size_t n, const size_t pivotes[], double *det);
+bool lu_log_determinante(const double lu[], size_t n, const size_t pivotes[], double *log_det, int *signo);
+bool lu_inversa(double inv[], const double lu[], size_t n, const size_t pivotes[], size_t hilos);
+
+bool cholesky_factorizar(double a[], size_t n, size_t hilos);
+bool cholesky_resolver(const double l[], size_t n, double b[], size_t columnas, size_t hilos);
+bool cholesky_log_determinante(const double l[], size_t n, double *log_det);
+bool cholesky_inversa(double inv[], const double l[], size_t n, size_t hilos);
+
+bool sistema_residuo(const double a[], size_t n, const double x[], const double b[], size_t columnas, size_t hilos,
+                     double *residuo);
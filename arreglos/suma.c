@@ -0,0 +1,312 @@
+#include "suma.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DIGIT_BITS 32
+#define DIGIT_MASK 0xffffffffULL
+#define DIGIT 4294967296LL
+/* each add puts less than 2^32 in a limb: normalizing every 2^30 adds keeps every limb far from overflowing */
+#define EXACT_FLUSH (1UL << 30)
+#define MANTISSA_BITS 52
+#define EXPONENT_MASK 0x7ff
+
+
+/* SUM_LANES independent chains: the compiler turns the inner loop into vector additions */
+static double naive(const double v[], size_t n)
+{
+    double lanes[SUM_LANES] = {0};
+    double total = 0;
+    size_t i = 0;
+
+    for (; i + SUM_LANES <= n; i += SUM_LANES) {
+        for (size_t k = 0; k < SUM_LANES; ++k) {
+            lanes[k] += v[i + k];
+        }
+    }
+    for (size_t k = 0; k < SUM_LANES / 2; ++k) {
+        lanes[k] += lanes[k + SUM_LANES / 2];
+    }
+    for (size_t k = 0; k < SUM_LANES / 2; ++k) {
+        total += lanes[k];
+    }
+    for (; i < n; ++i) {
+        total += v[i];
+    }
+
+    return total;
+}
+
+
+/* halves are cut at multiples of SUM_BLOCK, so the blocks (and the result) do not depend on where recursion stops */
+static double pairwise(const double v[], size_t n)
+{
+    size_t half;
+
+    if (n <= SUM_BLOCK) {
+        return naive(v, n);
+    }
+
+    half = (n / 2 + SUM_BLOCK - 1) / SUM_BLOCK * SUM_BLOCK;
+
+    return pairwise(v, half) + pairwise(v + half, n - half);
+}
+
+
+/*
+ * Neumaier's step: the rounding error of s + x is recovered exactly into c. It is computed with Knuth's TwoSum,
+ * which gives the same error without comparing |s| and |x|, so the loop has no branch and vectorizes.
+ */
+static inline void neumaier_add(double *s, double *c, double x)
+{
+    double t = *s + x;
+    double z = t - *s;
+
+    *c += (*s - (t - z)) + (x - z);
+    *s = t;
+}
+
+
+static double neumaier(const double v[], size_t n)
+{
+    double s[SUM_LANES] = {0};
+    double c[SUM_LANES] = {0};
+    double total = 0;
+    double comp = 0;
+    size_t i = 0;
+
+    for (; i + SUM_LANES <= n; i += SUM_LANES) {
+        for (size_t k = 0; k < SUM_LANES; ++k) {
+            neumaier_add(&s[k], &c[k], v[i + k]);
+        }
+    }
+    for (size_t k = 0; k < SUM_LANES; ++k) {
+        neumaier_add(&total, &comp, s[k]);
+        comp += c[k];
+    }
+    for (; i < n; ++i) {
+        neumaier_add(&total, &comp, v[i]);
+    }
+
+    return total + comp;
+}
+
+
+/* carries go up until every limb but the last is in [0, 2^32); the last one keeps the sign */
+static void normalize(int64_t limbs[])
+{
+    int64_t carry = 0;
+    int64_t x;
+    int64_t low;
+
+    for (size_t i = 0; i < SUM_EXACT_LIMBS - 1; ++i) {
+        x = limbs[i] + carry;
+        low = (int64_t) ((uint64_t) x & DIGIT_MASK);
+        carry = (x - low) / DIGIT;
+        limbs[i] = low;
+    }
+    limbs[SUM_EXACT_LIMBS - 1] += carry;
+}
+
+
+/*
+ * A finite double is m * 2^(p - 1074) with m < 2^53 and p >= 0: m shifted p bits is added, as it is, to the integer
+ * held in base 2^32 by the limbs.
+ */
+static inline void exact_add(sum_exact_t *acc, double x)
+{
+    uint64_t bits;
+    uint64_t m;
+    uint64_t lo;
+    uint64_t hi;
+    unsigned e;
+    unsigned p;
+    unsigned s;
+    int64_t *limb;
+
+    memcpy(&bits, &x, sizeof(bits));
+    e = (unsigned) (bits >> MANTISSA_BITS) & EXPONENT_MASK;
+    m = bits & ((1ULL << MANTISSA_BITS) - 1);
+
+    if (EXPONENT_MASK == e) {
+        if (0 != m) {
+            acc->nan = true;
+        } else if (bits >> 63) {
+            acc->neg_inf = true;
+        } else {
+            acc->pos_inf = true;
+        }
+        return;
+    }
+
+    if (0 == e) {
+        p = 0;
+    } else {
+        m |= 1ULL << MANTISSA_BITS;
+        p = e - 1;
+    }
+
+    s = p % DIGIT_BITS;
+    limb = acc->limbs + p / DIGIT_BITS;
+    lo = m << s;
+    hi = (0 != s) ? m >> (64 - s) : 0;
+
+    if (bits >> 63) {
+        limb[0] -= (int64_t) (lo & DIGIT_MASK);
+        limb[1] -= (int64_t) (lo >> DIGIT_BITS);
+        limb[2] -= (int64_t) hi;
+    } else {
+        limb[0] += (int64_t) (lo & DIGIT_MASK);
+        limb[1] += (int64_t) (lo >> DIGIT_BITS);
+        limb[2] += (int64_t) hi;
+    }
+}
+
+
+void sum_exact_init(sum_exact_t *acc)
+{
+    if (NULL != acc) {
+        memset(acc->limbs, 0, sizeof(acc->limbs));
+        acc->pending = 0;
+        acc->nan = false;
+        acc->pos_inf = false;
+        acc->neg_inf = false;
+    }
+}
+
+
+void sum_exact_add(sum_exact_t *acc, const double v[], size_t n)
+{
+    size_t step;
+
+    if ((NULL == acc) || (NULL == v)) {
+        return;
+    }
+
+    while (n > 0) {
+        step = (n < EXACT_FLUSH - acc->pending) ? n : EXACT_FLUSH - acc->pending;
+        for (size_t i = 0; i < step; ++i) {
+            exact_add(acc, v[i]);
+        }
+        v += step;
+        n -= step;
+        acc->pending += step;
+        if (EXACT_FLUSH == acc->pending) {
+            normalize(acc->limbs);
+            acc->pending = 0;
+        }
+    }
+}
+
+
+void sum_exact_merge(sum_exact_t *acc, const sum_exact_t *other)
+{
+    if ((NULL == acc) || (NULL == other)) {
+        return;
+    }
+
+    /* a normalized limb plus one with at most EXACT_FLUSH pending adds still fits in 64 bits */
+    normalize(acc->limbs);
+    for (size_t i = 0; i < SUM_EXACT_LIMBS; ++i) {
+        acc->limbs[i] += other->limbs[i];
+    }
+    normalize(acc->limbs);
+    acc->pending = 0;
+
+    acc->nan = acc->nan || other->nan;
+    acc->pos_inf = acc->pos_inf || other->pos_inf;
+    acc->neg_inf = acc->neg_inf || other->neg_inf;
+}
+
+
+/*
+ * The 64 bits below the most significant one go through a single int -> double conversion, which rounds to nearest
+ * even; any nonzero bit further down is folded into the last of those 64 bits so that ties are broken correctly.
+ */
+double sum_exact_result(sum_exact_t *acc)
+{
+    int64_t d[SUM_EXACT_LIMBS];
+    bool negative;
+    bool sticky;
+    uint64_t w;
+    size_t h;
+    size_t a;
+    size_t top;
+    unsigned o;
+    double r;
+
+    if (NULL == acc) {
+        return NAN;
+    }
+
+    if (acc->nan || (acc->pos_inf && acc->neg_inf)) {
+        return NAN;
+    }
+    if (acc->pos_inf || acc->neg_inf) {
+        return acc->pos_inf ? INFINITY : -INFINITY;
+    }
+
+    normalize(acc->limbs);
+    acc->pending = 0;
+
+    negative = (acc->limbs[SUM_EXACT_LIMBS - 1] < 0);
+    for (size_t i = 0; i < SUM_EXACT_LIMBS; ++i) {
+        d[i] = negative ? -acc->limbs[i] : acc->limbs[i];
+    }
+    normalize(d);
+
+    for (h = SUM_EXACT_LIMBS; (h > 0) && (0 == d[h - 1]); --h) ;
+    if (0 == h) {
+        return 0.0;
+    }
+    h--;
+
+    top = DIGIT_BITS * h + (DIGIT_BITS - 1) - (size_t) __builtin_clz((unsigned) d[h]);
+    if (top < 64) {
+        /* below 2^-1010 the value is at most 64 bits wide and the exponent never goes under the subnormal range */
+        w = (uint64_t) d[0] | ((h > 0) ? (uint64_t) d[1] << DIGIT_BITS : 0);
+        r = ldexp((double) w, -1074);
+    } else {
+        a = (top - 63) / DIGIT_BITS;
+        o = (unsigned) ((top - 63) % DIGIT_BITS);
+        w = (uint64_t) d[a] >> o;
+        w |= (uint64_t) d[a + 1] << (DIGIT_BITS - o);
+        if ((0 != o) && (a + 2 < SUM_EXACT_LIMBS)) {
+            w |= (uint64_t) d[a + 2] << (64 - o);
+        }
+        sticky = (0 != ((uint64_t) d[a] & ((1ULL << o) - 1)));
+        for (size_t i = 0; !sticky && (i < a); ++i) {
+            sticky = (0 != d[i]);
+        }
+        r = ldexp((double) (w | sticky), (int) (top - 63) - 1074);
+    }
+
+    return negative ? -r : r;
+}
+
+
+double sum_mode(const double v[], size_t n, sum_mode_t mode)
+{
+    sum_exact_t acc;
+
+    if (NULL == v) {
+        return NAN;
+    }
+
+    switch (mode) {
+        case SUM_PAIRWISE:
+            return pairwise(v, n);
+        case SUM_NEUMAIER:
+            return neumaier(v, n);
+        case SUM_EXACT:
+            sum_exact_init(&acc);
+            sum_exact_add(&acc, v, n);
+            return sum_exact_result(&acc);
+        case SUM_NAIVE:
+        default:
+            return naive(v, n);
+    }
+}
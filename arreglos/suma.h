@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Suma de un arreglo de doubles con la precisión elegida.
+ *
+ * | modo          | error                      | costo (ver bench_suma.c)                     |
+ * |---------------|----------------------------|----------------------------------------------|
+ * | SUM_NAIVE     | crece con n                | el mínimo: limitado por la memoria           |
+ * | SUM_PAIRWISE  | crece con log n            | prácticamente igual al anterior              |
+ * | SUM_NEUMAIER  | independiente de n         | ~4 operaciones por elemento, vectorizado     |
+ * | SUM_EXACT     | ninguno (redondeo correcto)| varias veces más lento; no vectoriza         |
+ *
+ * SUM_NAIVE suma de izquierda a derecha en SUM_LANES acumuladores independientes (es lo que permite vectorizar sin
+ * -ffast-math); SUM_PAIRWISE suma bloques de SUM_BLOCK elementos y luego combina los resultados de a pares;
+ * SUM_NEUMAIER es la suma compensada de Kahan-Babuška-Neumaier.
+ *
+ * SUM_EXACT acumula cada double, sin redondear, en un entero de más de 2000 bits que cubre todo el rango de los
+ * double (superacumulador), y redondea una única vez al final. Como la suma es exacta el resultado no depende del
+ * orden ni de cómo se divida el arreglo: cada parte puede acumularse por separado con sum_exact_add y combinarse con
+ * sum_exact_merge. Con infinitos o NaN el resultado es el de IEEE 754 (inf, -inf o NaN).
+ *
+ * Los resultados de SUM_NAIVE, SUM_PAIRWISE y SUM_NEUMAIER no dependen de la máquina, pero sí de cómo se parte el
+ * arreglo entre llamadas.
+ */
+
+#define SUM_LANES 8
+#define SUM_BLOCK 256
+#define SUM_EXACT_LIMBS 72
+
+typedef enum {
+    SUM_NAIVE,
+    SUM_PAIRWISE,
+    SUM_NEUMAIER,
+    SUM_EXACT,
+} sum_mode_t;
+
+
+typedef struct {
+    int64_t limbs[SUM_EXACT_LIMBS];
+    size_t pending;
+    bool nan;
+    bool pos_inf;
+    bool neg_inf;
+} sum_exact_t;
+
+
+double sum_mode(const double v[], size_t n, sum_mode_t mode);
+
+void sum_exact_init(sum_exact_t *acc);
+void sum_exact_add(sum_exact_t *acc, const double v[], size_t n);
+void sum_exact_merge(sum_exact_t *acc, const sum_exact_t *other);
+double sum_exact_result(sum_exact_t *acc);
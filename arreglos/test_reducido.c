@@ -0,0 +1,203 @@
+#include "reducido.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Verifica que reducido_guardar redondee cada double al half o bfloat16 más cercano (a par en caso de empate)
+ * comparando los bits guardados con una referencia que redondea directamente desde el double. Prueba los puntos medios
+ * entre cada par de valores consecutivos de cada formato y los double vecinos de cada punto medio (donde redondear dos
+ * veces falla), valores al azar de todo el rango, subnormales, desbordes, ceros, infinitos y NaN. Los arreglos tienen
+ * un largo que no es múltiplo de 8, así que compilando con -mf16c (o -march=native) se prueban las dos versiones de F16.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -o test_reducido test_reducido.c reducido.c sum.c sumar.c \
+ *       ../punteros/src/meand_st.c -lm
+ * $ ./test_reducido
+ */
+
+#define BLOQUE 4099
+#define AL_AZAR 10000000
+#define MAX_ERRORES 10
+
+
+typedef struct {
+    const char *nombre;
+    reducido_formato_t formato;
+    int bits;
+    int emin;
+    uint16_t infinito;
+} formato_t;
+
+
+static const formato_t formatos[] = {
+    {"half (F16)", REDUCIDO_F16, 11, -14, 0x7c00},
+    {"bfloat16", REDUCIDO_BF16, 8, -126, 0x7f80},
+};
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/*
+ * x rounded to `bits` bits of significand and smallest exponent `emin`, from the double itself: with the exponent
+ * fixed, the significand is an integer that rint rounds to even. Below 2^emin the exponent stays at emin (subnormals),
+ * and the carry of the significand goes into the exponent, as in the encoding.
+ */
+static uint16_t referencia(const formato_t *f, double x)
+{
+    uint16_t signo = signbit(x) ? 0x8000 : 0;
+    double a = fabs(x);
+    unsigned long codigo;
+    int e;
+
+    if (isnan(x)) {
+        return signo | f->infinito | 1;
+    }
+    if (isinf(x) || (0 == a)) {
+        return signo | (isinf(x) ? f->infinito : 0);
+    }
+
+    frexp(a, &e);
+    e = (e - 1 < f->emin) ? f->emin : e - 1;
+    codigo = ((unsigned long) (e - f->emin) << (f->bits - 1)) + (unsigned long) rint(ldexp(a, f->bits - 1 - e));
+
+    return signo | (uint16_t) ((codigo < f->infinito) ? codigo : f->infinito);
+}
+
+
+static double decodificar(const formato_t *f, uint16_t h)
+{
+    int e = (h & 0x7fff) >> (f->bits - 1);
+    double m = h & ((1U << (f->bits - 1)) - 1);
+    double x = (0 == e) ? ldexp(m, f->emin - f->bits + 1) : ldexp(m + (1U << (f->bits - 1)), e + f->emin - f->bits);
+
+    return (h & 0x8000) ? -x : x;
+}
+
+
+static bool iguales(const formato_t *f, uint16_t a, uint16_t b)
+{
+    bool nan_a = ((a & 0x7fff) > f->infinito);
+    bool nan_b = ((b & 0x7fff) > f->infinito);
+
+    return (nan_a || nan_b) ? (nan_a == nan_b) : (a == b);
+}
+
+
+/* stores the block and compares it with the reference; returns how many elements differ */
+static size_t verificar(const formato_t *f, reducido_t *r, const double v[], size_t n)
+{
+    const uint16_t *guardado = (const uint16_t *) r->data;
+    static size_t mostrados = 0;
+    size_t errores = 0;
+    uint16_t esperado;
+
+    reducido_guardar(r, 0, v, n);
+    for (size_t i = 0; i < n; ++i) {
+        esperado = referencia(f, v[i]);
+        if (!iguales(f, guardado[i], esperado)) {
+            if (mostrados++ < MAX_ERRORES) {
+                fprintf(stderr, "\t%a se guardó como %a (0x%04x) y debería ser %a (0x%04x)\n", v[i],
+                        decodificar(f, guardado[i]), guardado[i], decodificar(f, esperado), esperado);
+            }
+            ++errores;
+        }
+    }
+
+    return errores;
+}
+
+
+/* adds x to the block, and verifies it once full (or when `fin` is true) */
+static size_t agregar(const formato_t *f, reducido_t *r, double v[], size_t *n, double x, bool fin)
+{
+    size_t errores = 0;
+
+    if (!fin) {
+        v[(*n)++] = x;
+    }
+    if ((BLOQUE == *n) || (fin && (0 != *n))) {
+        errores = verificar(f, r, v, *n);
+        *n = 0;
+    }
+
+    return errores;
+}
+
+
+static size_t probar(const formato_t *f, reducido_t *r, double v[])
+{
+    const double especiales[] = {0.0, -0.0, INFINITY, -INFINITY, NAN, 1e300, -1e300, 1e-300, -1e-300, 65519.99,
+                                 65520, 0x1p-25, 0x1.0000000000001p-25, 0x1p-134, 0x1.0000000000001p-134,
+                                 -0x1.945fff7c8c1cbp-9};
+    unsigned long semilla = 88172645463325252UL;
+    unsigned long u;
+    size_t errores = 0;
+    size_t n = 0;
+    double medio;
+    double x;
+
+    for (size_t i = 0; i < sizeof(especiales) / sizeof(especiales[0]); ++i) {
+        errores += agregar(f, r, v, &n, especiales[i], false);
+    }
+
+    /* the midpoint between each pair of consecutive values (a tie) and the doubles right next to it */
+    for (uint16_t h = 0; h < f->infinito; ++h) {
+        medio = (decodificar(f, h) + decodificar(f, h + 1)) / 2;
+        errores += agregar(f, r, v, &n, medio, false);
+        errores += agregar(f, r, v, &n, -nextafter(medio, 0), false);
+        errores += agregar(f, r, v, &n, nextafter(medio, INFINITY), false);
+    }
+
+    /* any sign and mantissa, exponents from below the smallest subnormal to above the largest value */
+    for (size_t i = 0; i < AL_AZAR; ++i) {
+        u = siguiente(&semilla);
+        x = ldexp(1 + (double) (u >> 12) / (1UL << 52), (int) (u % 300) - 160);
+        errores += agregar(f, r, v, &n, (u & 0x800) ? -x : x, false);
+    }
+
+    return errores + agregar(f, r, v, &n, 0, true);
+}
+
+
+int main(void)
+{
+    double *v = (double *) malloc(BLOQUE * sizeof(double));
+    reducido_t r;
+    size_t errores;
+    bool ok = true;
+
+    if (NULL == v) {
+        fprintf(stderr, "No hay memoria\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < sizeof(formatos) / sizeof(formatos[0]); ++i) {
+        if (!reducido_init(&r, formatos[i].formato, BLOQUE)) {
+            fprintf(stderr, "No hay memoria\n");
+            free(v);
+            return EXIT_FAILURE;
+        }
+        printf("%s:\n", formatos[i].nombre);
+        errores = probar(&formatos[i], &r, v);
+        printf("\t%zu elementos mal redondeados\n", errores);
+        ok = ok && (0 == errores);
+        reducido_destroy(&r);
+    }
+
+    puts(ok ? "Todas las pruebas pasaron" : "Alguna prueba falló");
+    free(v);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
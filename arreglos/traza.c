@@ -1,12 +1,12 @@
 #include <stdlib.h>
 
-double matr_ones(double mat[][200], size_t n)
+double traza(double mat[][200], size_t n)
 {
-    double traza = 0;
+    double t = 0;
 
     for (size_t i = 0; i < n; ++i) {
-        traza += mat[i][i];
+        t += mat[i][i];
     }
 
-    return traza;
+    return t;
 }
@@ -0,0 +1,414 @@
+#include "vista.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MAX_OPERANDOS 3
+
+/* arreglos/zeros.c, sum.c y sumar.c */
+void zeros(double v[], size_t n);
+double sum(const double v[], size_t n);
+void sumar(double lhs[], const double rhs1[], const double rhs2[], size_t n);
+
+
+/* the same shape for every operand; dimension 0 is the innermost one */
+typedef struct {
+    size_t operandos;
+    size_t dims;
+    size_t forma[VISTA_MAX_DIMS];
+    ptrdiff_t pasos[MAX_OPERANDOS][VISTA_MAX_DIMS];
+    double *data[MAX_OPERANDOS];
+} recorrido_t;
+
+
+/* called once per run of the innermost (fused) dimension */
+typedef void (*tramo_fn_t)(double *const p[], const ptrdiff_t paso[], size_t n, void *ctx);
+
+
+bool vista_init(vista_t *v, double *data, size_t dims, const size_t forma[])
+{
+    size_t paso = 1;
+
+    if ((NULL == v) || (NULL == data) || (dims > VISTA_MAX_DIMS) || ((NULL == forma) && (0 != dims))) {
+        return false;
+    }
+
+    v->data = data;
+    v->dims = dims;
+    for (size_t d = dims; d-- > 0;) {
+        v->forma[d] = forma[d];
+        v->pasos[d] = (ptrdiff_t) paso;
+        if ((0 != forma[d]) && (paso > PTRDIFF_MAX / forma[d])) {
+            return false;
+        }
+        paso *= forma[d];
+    }
+
+    return true;
+}
+
+
+bool vista_cortar(const vista_t *v, size_t eje, size_t desde, size_t cantidad, ptrdiff_t paso, vista_t *out)
+{
+    vista_t r;
+    ptrdiff_t ultimo;
+
+    if ((NULL == v) || (NULL == out) || (eje >= v->dims) || (0 == paso)) {
+        return false;
+    }
+
+    r = *v;
+    if (0 != cantidad) {
+        /* the first and the last index taken must both be inside the axis */
+        if ((desde >= v->forma[eje]) || (cantidad - 1 > (size_t) PTRDIFF_MAX / (size_t) ((paso < 0) ? -paso : paso))) {
+            return false;
+        }
+        ultimo = (ptrdiff_t) desde + (ptrdiff_t) (cantidad - 1) * paso;
+        if ((ultimo < 0) || ((size_t) ultimo >= v->forma[eje])) {
+            return false;
+        }
+        r.data += (ptrdiff_t) desde * v->pasos[eje];
+    }
+    r.forma[eje] = cantidad;
+    r.pasos[eje] = v->pasos[eje] * paso;
+    *out = r;
+
+    return true;
+}
+
+
+bool vista_fijar(const vista_t *v, size_t eje, size_t indice, vista_t *out)
+{
+    vista_t r;
+
+    if ((NULL == v) || (NULL == out) || (eje >= v->dims) || (indice >= v->forma[eje])) {
+        return false;
+    }
+
+    r = *v;
+    r.data += (ptrdiff_t) indice * v->pasos[eje];
+    r.dims--;
+    for (size_t d = eje; d < r.dims; ++d) {
+        r.forma[d] = v->forma[d + 1];
+        r.pasos[d] = v->pasos[d + 1];
+    }
+    *out = r;
+
+    return true;
+}
+
+
+bool vista_trasponer(const vista_t *v, const size_t orden[], vista_t *out)
+{
+    vista_t r;
+    bool usado[VISTA_MAX_DIMS] = {false};
+    size_t e;
+
+    if ((NULL == v) || (NULL == out)) {
+        return false;
+    }
+
+    r = *v;
+    for (size_t d = 0; d < v->dims; ++d) {
+        e = (NULL == orden) ? v->dims - 1 - d : orden[d];
+        if ((e >= v->dims) || usado[e]) {
+            return false;
+        }
+        usado[e] = true;
+        r.forma[d] = v->forma[e];
+        r.pasos[d] = v->pasos[e];
+    }
+    *out = r;
+
+    return true;
+}
+
+
+/* axes are matched from the right; a missing axis or one of size 1 is repeated with step 0 */
+bool vista_difundir(const vista_t *v, size_t dims, const size_t forma[], vista_t *out)
+{
+    vista_t r;
+    size_t nuevas;
+    size_t e;
+
+    if ((NULL == v) || (NULL == out) || (dims > VISTA_MAX_DIMS) || (dims < v->dims) ||
+        ((NULL == forma) && (0 != dims))) {
+        return false;
+    }
+
+    r.data = v->data;
+    r.dims = dims;
+    nuevas = dims - v->dims;
+    for (size_t d = 0; d < dims; ++d) {
+        r.forma[d] = forma[d];
+        if (d < nuevas) {
+            r.pasos[d] = 0;
+            continue;
+        }
+        e = d - nuevas;
+        if (v->forma[e] == forma[d]) {
+            r.pasos[d] = v->pasos[e];
+        } else if (1 == v->forma[e]) {
+            r.pasos[d] = 0;
+        } else {
+            return false;
+        }
+    }
+    *out = r;
+
+    return true;
+}
+
+
+size_t vista_elementos(const vista_t *v)
+{
+    size_t n = 1;
+
+    if (NULL == v) {
+        return 0;
+    }
+
+    for (size_t d = 0; d < v->dims; ++d) {
+        n *= v->forma[d];
+    }
+
+    return n;
+}
+
+
+/* laid out as a C array: each axis of size above 1 steps over everything that follows it */
+bool vista_contigua(const vista_t *v)
+{
+    ptrdiff_t esperado = 1;
+
+    if (NULL == v) {
+        return false;
+    }
+
+    if (0 == vista_elementos(v)) {
+        return true;
+    }
+
+    for (size_t d = v->dims; d-- > 0;) {
+        if ((1 != v->forma[d]) && (v->pasos[d] != esperado)) {
+            return false;
+        }
+        esperado *= (ptrdiff_t) v->forma[d];
+    }
+
+    return true;
+}
+
+
+double *vista_elemento(const vista_t *v, const size_t indices[])
+{
+    double *p;
+
+    if ((NULL == v) || ((NULL == indices) && (0 != v->dims))) {
+        return NULL;
+    }
+
+    p = v->data;
+    for (size_t d = 0; d < v->dims; ++d) {
+        if (indices[d] >= v->forma[d]) {
+            return NULL;
+        }
+        p += (ptrdiff_t) indices[d] * v->pasos[d];
+    }
+
+    return p;
+}
+
+
+/*
+ * Axes of size 1 are dropped, and an axis is fused with the one inside it when, in every operand, stepping over it
+ * is the same as stepping over the whole inner one: a contiguous view ends up as a single run.
+ */
+static void fusionar(recorrido_t *r, const vista_t *const vistas[], size_t operandos)
+{
+    const vista_t *v = vistas[0];
+    bool contiguo;
+
+    r->operandos = operandos;
+    r->dims = 0;
+    for (size_t o = 0; o < operandos; ++o) {
+        r->data[o] = vistas[o]->data;
+    }
+
+    for (size_t d = v->dims; d-- > 0;) {
+        if (1 == v->forma[d]) {
+            continue;
+        }
+        contiguo = (r->dims > 0);
+        for (size_t o = 0; contiguo && (o < operandos); ++o) {
+            contiguo = (vistas[o]->pasos[d] == r->pasos[o][r->dims - 1] * (ptrdiff_t) r->forma[r->dims - 1]);
+        }
+        if (contiguo) {
+            r->forma[r->dims - 1] *= v->forma[d];
+            continue;
+        }
+        r->forma[r->dims] = v->forma[d];
+        for (size_t o = 0; o < operandos; ++o) {
+            r->pasos[o][r->dims] = vistas[o]->pasos[d];
+        }
+        r->dims++;
+    }
+
+    /* every axis had size 1: a single element */
+    if (0 == r->dims) {
+        r->dims = 1;
+        r->forma[0] = 1;
+        for (size_t o = 0; o < operandos; ++o) {
+            r->pasos[o][0] = 1;
+        }
+    }
+}
+
+
+static void recorrer(const recorrido_t *r, tramo_fn_t fn, void *ctx)
+{
+    size_t indices[VISTA_MAX_DIMS] = {0};
+    double *p[MAX_OPERANDOS];
+    ptrdiff_t paso[MAX_OPERANDOS];
+    size_t d;
+
+    for (size_t o = 0; o < r->operandos; ++o) {
+        p[o] = r->data[o];
+        paso[o] = r->pasos[o][0];
+    }
+
+    for (d = 0; d < r->dims; ++d) {
+        if (0 == r->forma[d]) {
+            return;
+        }
+    }
+
+    /* an odometer over the outer dimensions */
+    do {
+        fn(p, paso, r->forma[0], ctx);
+        for (d = 1; d < r->dims; ++d) {
+            for (size_t o = 0; o < r->operandos; ++o) {
+                p[o] += r->pasos[o][d];
+            }
+            if (++indices[d] < r->forma[d]) {
+                break;
+            }
+            for (size_t o = 0; o < r->operandos; ++o) {
+                p[o] -= r->pasos[o][d] * (ptrdiff_t) r->forma[d];
+            }
+            indices[d] = 0;
+        }
+    } while (d < r->dims);
+}
+
+
+static bool escribible(const vista_t *v)
+{
+    for (size_t d = 0; d < v->dims; ++d) {
+        if ((0 == v->pasos[d]) && (v->forma[d] > 1)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void tramo_zeros(double *const p[], const ptrdiff_t paso[], size_t n, void *ctx)
+{
+    (void) ctx;
+
+    if (1 == paso[0]) {
+        zeros(p[0], n);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        p[0][(ptrdiff_t) i * paso[0]] = 0;
+    }
+}
+
+
+static void tramo_sum(double *const p[], const ptrdiff_t paso[], size_t n, void *ctx)
+{
+    double s = 0;
+
+    if (1 == paso[0]) {
+        s = sum(p[0], n);
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            s += p[0][(ptrdiff_t) i * paso[0]];
+        }
+    }
+    *(double *) ctx += s;
+}
+
+
+static void tramo_sumar(double *const p[], const ptrdiff_t paso[], size_t n, void *ctx)
+{
+    (void) ctx;
+
+    if ((1 == paso[0]) && (1 == paso[1]) && (1 == paso[2])) {
+        sumar(p[0], p[1], p[2], n);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        p[0][(ptrdiff_t) i * paso[0]] = p[1][(ptrdiff_t) i * paso[1]] + p[2][(ptrdiff_t) i * paso[2]];
+    }
+}
+
+
+bool vista_zeros(const vista_t *v)
+{
+    recorrido_t r;
+
+    if ((NULL == v) || !escribible(v)) {
+        return false;
+    }
+
+    fusionar(&r, &v, 1);
+    recorrer(&r, tramo_zeros, NULL);
+
+    return true;
+}
+
+
+double vista_sum(const vista_t *v)
+{
+    recorrido_t r;
+    double s = 0;
+
+    if (NULL == v) {
+        return 0;
+    }
+
+    fusionar(&r, &v, 1);
+    recorrer(&r, tramo_sum, &s);
+
+    return s;
+}
+
+
+bool vista_sumar(const vista_t *lhs, const vista_t *rhs1, const vista_t *rhs2)
+{
+    const vista_t *vistas[] = {lhs, rhs1, rhs2};
+    recorrido_t r;
+
+    if ((NULL == lhs) || (NULL == rhs1) || (NULL == rhs2) || !escribible(lhs)) {
+        return false;
+    }
+    if ((lhs->dims != rhs1->dims) || (lhs->dims != rhs2->dims)) {
+        return false;
+    }
+    for (size_t d = 0; d < lhs->dims; ++d) {
+        if ((lhs->forma[d] != rhs1->forma[d]) || (lhs->forma[d] != rhs2->forma[d])) {
+            return false;
+        }
+    }
+
+    fusionar(&r, vistas, MAX_OPERANDOS);
+    recorrer(&r, tramo_sumar, NULL);
+
+    return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/*
+ * Vistas N-dimensionales sobre un arreglo de doubles, sin copiar los datos.
+ *
+ * Una vista es un puntero al primer elemento, la forma (cuántos elementos hay en cada dimensión) y el paso de cada
+ * dimensión (cuántos elementos hay que avanzar en memoria para pasar al siguiente índice): el elemento (i0, i1, ...)
+ * está en data[i0 * pasos[0] + i1 * pasos[1] + ...]. Un double cube[2][2][2] (ver memdir_cube.c) es la vista de
+ * forma {2, 2, 2} y pasos {4, 2, 1}.
+ *
+ * Cortar, fijar un índice, trasponer o difundir sólo cambian la forma, los pasos y el puntero:
+ *
+ * -   vista_cortar toma `cantidad` índices de un eje a partir de `desde`, de a `paso` (negativo: hacia atrás).
+ * -   vista_fijar elimina un eje quedándose con un índice: un plano de un cubo, una columna de una matriz.
+ * -   vista_trasponer reordena los ejes (NULL: los invierte, la traspuesta de una matriz).
+ * -   vista_difundir agrega ejes a la izquierda y extiende los de tamaño 1 con paso 0, con las reglas de NumPy, para
+ *     operar una vista más chica contra una más grande (por ejemplo, sumar una fila a todas las filas).
+ *
+ * vista_zeros, vista_sum y vista_sumar son zeros, sum y sumar sobre vistas. Antes de recorrer se fusionan las
+ * dimensiones consecutivas en memoria, y cada tramo contiguo resultante se pasa a la función original (que debe
+ * compilarse junto con vista.c): una vista contigua es una única llamada. El destino de vista_sumar y vista_zeros
+ * no puede tener pasos 0 ni superponerse con los operandos salvo que sea exactamente la misma vista.
+ */
+
+#define VISTA_MAX_DIMS 8
+
+
+typedef struct {
+    double *data;
+    size_t dims;
+    size_t forma[VISTA_MAX_DIMS];
+    ptrdiff_t pasos[VISTA_MAX_DIMS];
+} vista_t;
+
+
+/* vista de un arreglo contiguo de dims dimensiones, como double data[forma[0]][forma[1]]... */
+bool vista_init(vista_t *v, double *data, size_t dims, const size_t forma[]);
+
+bool vista_cortar(const vista_t *v, size_t eje, size_t desde, size_t cantidad, ptrdiff_t paso, vista_t *out);
+bool vista_fijar(const vista_t *v, size_t eje, size_t indice, vista_t *out);
+bool vista_trasponer(const vista_t *v, const size_t orden[], vista_t *out);
+bool vista_difundir(const vista_t *v, size_t dims, const size_t forma[], vista_t *out);
+
+size_t vista_elementos(const vista_t *v);
+bool vista_contigua(const vista_t *v);
+double *vista_elemento(const vista_t *v, const size_t indices[]);
+
+bool vista_zeros(const vista_t *v);
+double vista_sum(const vista_t *v);
+/* las tres vistas deben tener la misma forma (usar vista_difundir si no la tienen) */
+bool vista_sumar(const vista_t *lhs, const vista_t *rhs1, const vista_t *rhs2);
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ordenar.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Compara ordenar_cadenas (radix, multikey, estable y con varios hilos) contra qsort con strcmp, sobre claves con un
+ * prefijo común y palabras al azar, con repetidas. También ordena las mismas claves en un arreglo `char [][ANCHO]`
+ * sin repetidas, y verifica todo contra qsort.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -pthread -o bench_ordenar bench_ordenar.c ordenar.c
+ * $ ./bench_ordenar [cadenas] [hilos]
+ */
+
+#define DEFAULT_LENGTH 2000000UL
+#define ANCHO 20
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+static int comparar(const void *a, const void *b)
+{
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+
+/* mismo contenido que qsort y, si es estable, los iguales en el orden original (las direcciones crecen) */
+static bool verificar(char *const ordenado[], char *const esperado[], size_t n, bool estable)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != strcmp(ordenado[i], esperado[i])) {
+            return false;
+        }
+        if (estable && (i > 0) && (0 == strcmp(ordenado[i - 1], ordenado[i])) && (ordenado[i - 1] > ordenado[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LENGTH;
+    size_t hilos = (argc > 2) ? strtoul(argv[2], NULL, 10) : 0;
+    char (*claves)[ANCHO] = malloc(n * sizeof(*claves));
+    char (*fijas)[ANCHO] = malloc(n * sizeof(*fijas));
+    char **original = (char **) malloc(n * sizeof(char *));
+    char **esperado = (char **) malloc(n * sizeof(char *));
+    char **arr = (char **) malloc(n * sizeof(char *));
+    const struct {
+        const char *nombre;
+        unsigned opciones;
+        size_t hilos;
+    } casos[] = {
+        {"radix", 0, 1},
+        {"radix estable", ORDENAR_ESTABLE, 1},
+        {"multikey", ORDENAR_MULTIKEY, 1},
+        {"radix (hilos)", 0, hilos},
+        {"multikey (hilos)", ORDENAR_MULTIKEY, hilos},
+    };
+    unsigned long semilla = 88172645463325252UL;
+    size_t largo;
+    size_t m;
+    size_t distintas;
+    double t;
+    double t_qsort;
+    bool ok;
+
+    if ((0 == n) || (NULL == claves) || (NULL == fijas) || (NULL == original) || (NULL == esperado) || (NULL == arr)) {
+        fprintf(stderr, "Uso: %s [cadenas > 0] [hilos]\n", argv[0]);
+        free(claves);
+        free(fijas);
+        free(original);
+        free(esperado);
+        free(arr);
+        return EXIT_FAILURE;
+    }
+
+    /* la mitad con un prefijo en común, la otra mitad palabras de 3 a 12 letras; 1 de cada 8 se repite, más o menos */
+    for (size_t i = 0; i < n; ++i) {
+        if (siguiente(&semilla) % 2) {
+            snprintf(claves[i], ANCHO, "cliente-%08u", (unsigned) (siguiente(&semilla) % (n - n / 8 + 1)));
+        } else {
+            largo = 3 + siguiente(&semilla) % 10;
+            for (size_t j = 0; j < largo; ++j) {
+                claves[i][j] = (char) ('a' + siguiente(&semilla) % 26);
+            }
+            claves[i][largo] = '\0';
+        }
+        original[i] = claves[i];
+    }
+
+    memcpy(esperado, original, n * sizeof(char *));
+    t = now();
+    qsort(esperado, n, sizeof(char *), comparar);
+    t_qsort = now() - t;
+    printf("%zu cadenas\n\n%-20s %10.1f ms\n", n, "qsort + strcmp", t_qsort * 1e3);
+
+    for (size_t c = 0; c < sizeof(casos) / sizeof(casos[0]); ++c) {
+        memcpy(arr, original, n * sizeof(char *));
+        m = n;
+        t = now();
+        ok = ordenar_cadenas(arr, &m, casos[c].opciones, casos[c].hilos);
+        t = now() - t;
+        ok = ok && verificar(arr, esperado, n, casos[c].opciones & ORDENAR_ESTABLE);
+        printf("%-20s %10.1f ms %6.1fx   %s\n", casos[c].nombre, t * 1e3, t_qsort / t, ok ? "ok" : "DISTINTO");
+    }
+
+    distintas = (n > 0);
+    for (size_t i = 1; i < n; ++i) {
+        distintas += (0 != strcmp(esperado[i - 1], esperado[i]));
+    }
+
+    memcpy(fijas, claves, n * sizeof(*claves));
+    m = n;
+    t = now();
+    ok = ordenar_cadenas_fijas((char *) fijas, sizeof(fijas[0]), &m, ORDENAR_SIN_REPETIDAS, hilos);
+    t = now() - t;
+    ok = ok && (m == distintas);
+    for (size_t i = 0, j = 0; ok && (i < m); ++i, ++j) {
+        while ((j > 0) && (0 == strcmp(esperado[j], esperado[j - 1]))) {
+            ++j;
+        }
+        ok = (0 == strcmp(fijas[i], esperado[j]));
+    }
+    printf("\n%-20s %10.1f ms           %s (%zu distintas)\n", "char [][20] sin rep.", t * 1e3, ok ? "ok" : "DISTINTO",
+           m);
+
+    free(claves);
+    free(fijas);
+    free(original);
+    free(esperado);
+    free(arr);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,412 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ordenar.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ALFABETO 256
+/* groups this small are finished by insertion: distributing them costs more than comparing */
+#define INSERCION_MAX 32
+#define MAX_HILOS 64
+/* below this many strings per thread, creating the thread costs more than it saves */
+#define MIN_TRABAJO (1UL << 16)
+#define OPCIONES (ORDENAR_ESTABLE | ORDENAR_SIN_REPETIDAS | ORDENAR_MULTIKEY)
+
+
+typedef struct {
+    char **a;
+    char **aux;
+    unsigned char *oraculo;
+    bool multikey;
+    size_t limites[ALFABETO + 1];
+    size_t grupos[ALFABETO];
+    size_t cantidad;
+    atomic_size_t siguiente;
+} trabajo_t;
+
+
+static size_t minimo(size_t a, size_t b)
+{
+    return (a < b) ? a : b;
+}
+
+
+static inline unsigned char letra(const char *s, size_t d)
+{
+    return (unsigned char) s[d];
+}
+
+
+/* the first d characters are already known to be equal; stable */
+static void insercion(char **a, size_t n, size_t d)
+{
+    char *x;
+    size_t j;
+
+    for (size_t i = 1; i < n; ++i) {
+        x = a[i];
+        for (j = i; (j > 0) && (strcmp(a[j - 1] + d, x + d) > 0); --j) {
+            a[j] = a[j - 1];
+        }
+        a[j] = x;
+    }
+}
+
+
+/*
+ * Groups the strings by their character at position d, leaving in limites[c] where group c starts. The characters are
+ * read once into oraculo, so the strings themselves (scattered in memory) are not touched again in this pass. With
+ * aux the distribution goes through it and is stable; without it, each string is swapped straight into its group
+ * (American flag sort). Returns false, without moving anything, if they all have the same character.
+ */
+static bool distribuir(char **a, char **aux, unsigned char *oraculo, size_t n, size_t d, size_t limites[])
+{
+    size_t cuenta[ALFABETO] = {0};
+    size_t siguiente[ALFABETO];
+    unsigned char c;
+    unsigned char t;
+    char *p;
+    char *q;
+    size_t j;
+
+    for (size_t i = 0; i < n; ++i) {
+        oraculo[i] = letra(a[i], d);
+        cuenta[oraculo[i]]++;
+    }
+    if (n == cuenta[oraculo[0]]) {
+        return false;
+    }
+
+    limites[0] = 0;
+    for (size_t b = 0; b < ALFABETO; ++b) {
+        limites[b + 1] = limites[b] + cuenta[b];
+    }
+    memcpy(siguiente, limites, sizeof(siguiente));
+
+    if (NULL != aux) {
+        for (size_t i = 0; i < n; ++i) {
+            aux[siguiente[oraculo[i]]++] = a[i];
+        }
+        memcpy(a, aux, n * sizeof(char *));
+        return true;
+    }
+
+    for (size_t b = 0; b < ALFABETO; ++b) {
+        while (siguiente[b] < limites[b + 1]) {
+            p = a[siguiente[b]];
+            c = oraculo[siguiente[b]];
+            while (c != b) {
+                j = siguiente[c]++;
+                q = a[j];
+                t = oraculo[j];
+                a[j] = p;
+                oraculo[j] = c;
+                p = q;
+                c = t;
+            }
+            a[siguiente[b]] = p;
+            oraculo[siguiente[b]++] = c;
+        }
+    }
+
+    return true;
+}
+
+
+static void radix(char **a, char **aux, unsigned char *oraculo, size_t n, size_t d)
+{
+    size_t limites[ALFABETO + 1];
+
+    for (;;) {
+        if (n <= INSERCION_MAX) {
+            insercion(a, n, d);
+            return;
+        }
+        if (distribuir(a, aux, oraculo, n, d, limites)) {
+            break;
+        }
+        /* a single group: either all of them ended here (they are equal) or the next character decides */
+        if ('\0' == a[0][d]) {
+            return;
+        }
+        ++d;
+    }
+
+    /* group 0 holds the strings that ended at d, already equal and in order */
+    for (size_t b = 1; b < ALFABETO; ++b) {
+        if (limites[b + 1] - limites[b] > 1) {
+            radix(a + limites[b], (NULL == aux) ? NULL : aux + limites[b], oraculo + limites[b],
+                  limites[b + 1] - limites[b], d + 1);
+        }
+    }
+}
+
+
+static unsigned char mediana(unsigned char x, unsigned char y, unsigned char z)
+{
+    if (x < y) {
+        return (y < z) ? y : ((x < z) ? z : x);
+    }
+
+    return (x < z) ? x : ((y < z) ? z : y);
+}
+
+
+static inline void intercambiar(char **a, size_t i, size_t j)
+{
+    char *t = a[i];
+
+    a[i] = a[j];
+    a[j] = t;
+}
+
+
+/* Bentley and Sedgewick: three-way partition on the character at d; only the middle part advances to d + 1 */
+static void multikey(char **a, size_t n, size_t d)
+{
+    unsigned char pivote;
+    unsigned char c;
+    size_t menores;
+    size_t mayores;
+    size_t i;
+
+    while (n > INSERCION_MAX) {
+        pivote = mediana(letra(a[0], d), letra(a[n / 2], d), letra(a[n - 1], d));
+        menores = 0;
+        mayores = n;
+        i = 0;
+        while (i < mayores) {
+            c = letra(a[i], d);
+            if (c < pivote) {
+                intercambiar(a, menores++, i++);
+            } else if (c > pivote) {
+                intercambiar(a, i, --mayores);
+            } else {
+                ++i;
+            }
+        }
+        multikey(a, menores, d);
+        multikey(a + mayores, n - mayores, d);
+        if ('\0' == pivote) {
+            return;
+        }
+        a += menores;
+        n = mayores - menores;
+        ++d;
+    }
+
+    insercion(a, n, d);
+}
+
+
+static void ordenar_grupo(const trabajo_t *t, size_t desde, size_t hasta, size_t d)
+{
+    if (t->multikey) {
+        multikey(t->a + desde, hasta - desde, d);
+    } else {
+        radix(t->a + desde, (NULL == t->aux) ? NULL : t->aux + desde, t->oraculo + desde, hasta - desde, d);
+    }
+}
+
+
+/* each thread takes the next group not yet taken: the largest ones go first, so the work evens out at the end */
+static void *trabajar(void *arg)
+{
+    trabajo_t *t = (trabajo_t *) arg;
+    size_t k;
+    size_t b;
+
+    while ((k = atomic_fetch_add(&t->siguiente, 1)) < t->cantidad) {
+        b = t->grupos[k];
+        ordenar_grupo(t, t->limites[b], t->limites[b + 1], 1);
+    }
+
+    return NULL;
+}
+
+
+static void paralelo(trabajo_t *t, size_t n, size_t hilos)
+{
+    pthread_t ids[MAX_HILOS];
+    bool lanzado[MAX_HILOS];
+    size_t b;
+    size_t j;
+
+    if (!distribuir(t->a, t->aux, t->oraculo, n, 0, t->limites)) {
+        /* a single first character: nothing to split, sort everything here */
+        ordenar_grupo(t, 0, n, 0);
+        return;
+    }
+
+    t->cantidad = 0;
+    for (b = 1; b < ALFABETO; ++b) {
+        if (t->limites[b + 1] - t->limites[b] > 1) {
+            /* insertion by size, largest first; at most 255 groups */
+            for (j = t->cantidad++; (j > 0) && (t->limites[t->grupos[j - 1] + 1] - t->limites[t->grupos[j - 1]] <
+                                                t->limites[b + 1] - t->limites[b]); --j) {
+                t->grupos[j] = t->grupos[j - 1];
+            }
+            t->grupos[j] = b;
+        }
+    }
+    atomic_init(&t->siguiente, 0);
+
+    for (size_t h = 1; h < hilos; ++h) {
+        lanzado[h] = (0 == pthread_create(&ids[h], NULL, trabajar, t));
+    }
+    /* the calling thread works too, and takes whatever a thread that could not be created would have done */
+    trabajar(t);
+    for (size_t h = 1; h < hilos; ++h) {
+        if (lanzado[h]) {
+            pthread_join(ids[h], NULL);
+        }
+    }
+}
+
+
+/* keeps the first of each run of equal strings; returns how many are left */
+static size_t sin_repetidas(char *arr[], size_t n)
+{
+    size_t m = (n > 0);
+
+    for (size_t i = 1; i < n; ++i) {
+        if (0 != strcmp(arr[i], arr[m - 1])) {
+            arr[m++] = arr[i];
+        }
+    }
+
+    return m;
+}
+
+
+bool ordenar_cadenas(char *arr[], size_t *n, unsigned opciones, size_t hilos)
+{
+    trabajo_t t;
+    long cpus;
+
+    if ((NULL == arr) || (NULL == n) || (0 != (opciones & ~OPCIONES))) {
+        return false;
+    }
+    if ((opciones & ORDENAR_ESTABLE) && (opciones & ORDENAR_MULTIKEY)) {
+        return false;
+    }
+
+    if (0 == hilos) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        hilos = (cpus > 0) ? (size_t) cpus : 1;
+    }
+    hilos = minimo(minimo(hilos, MAX_HILOS), *n / MIN_TRABAJO + 1);
+
+    t.a = arr;
+    t.aux = NULL;
+    t.oraculo = NULL;
+    t.multikey = (opciones & ORDENAR_MULTIKEY);
+    if ((*n > INSERCION_MAX) && (!t.multikey || (hilos > 1))) {
+        t.oraculo = (unsigned char *) malloc(*n);
+        if (NULL == t.oraculo) {
+            return false;
+        }
+    }
+    if ((*n > INSERCION_MAX) && (opciones & ORDENAR_ESTABLE)) {
+        t.aux = (char **) malloc(*n * sizeof(char *));
+        if (NULL == t.aux) {
+            free(t.oraculo);
+            return false;
+        }
+    }
+
+    if (hilos > 1) {
+        paralelo(&t, *n, hilos);
+    } else {
+        ordenar_grupo(&t, 0, *n, 0);
+    }
+    free(t.oraculo);
+    free(t.aux);
+
+    if (opciones & ORDENAR_SIN_REPETIDAS) {
+        *n = sin_repetidas(arr, *n);
+    }
+
+    return true;
+}
+
+
+/* row i gets the row p[i] points to; each cycle of the permutation is followed once, through one spare row */
+static void permutar(char *arr, size_t ancho, char *p[], size_t n, char *fila)
+{
+    char *destino;
+    size_t j;
+    size_t k;
+
+    for (size_t i = 0; i < n; ++i) {
+        destino = arr + i * ancho;
+        if (NULL == p[i]) {
+            continue;
+        }
+        if (p[i] == destino) {
+            p[i] = NULL;
+            continue;
+        }
+        memcpy(fila, destino, ancho);
+        for (j = i; p[j] != destino; j = k) {
+            k = (size_t) (p[j] - arr) / ancho;
+            memcpy(arr + j * ancho, p[j], ancho);
+            p[j] = NULL;
+        }
+        memcpy(arr + j * ancho, fila, ancho);
+        p[j] = NULL;
+    }
+}
+
+
+bool ordenar_cadenas_fijas(char *arr, size_t ancho, size_t *n, unsigned opciones, size_t hilos)
+{
+    char **p;
+    char *fila;
+    size_t m;
+    bool ok;
+
+    if ((NULL == arr) || (NULL == n) || (0 == ancho)) {
+        return false;
+    }
+
+    p = (char **) malloc(*n * sizeof(char *));
+    fila = (char *) malloc(ancho);
+    if ((NULL == p) || (NULL == fila)) {
+        free(p);
+        free(fila);
+        return false;
+    }
+
+    for (size_t i = 0; i < *n; ++i) {
+        p[i] = arr + i * ancho;
+    }
+    /* duplicates are dropped after the rows are in place, so the permutation stays complete */
+    m = *n;
+    ok = ordenar_cadenas(p, &m, opciones & ~ORDENAR_SIN_REPETIDAS, hilos);
+    if (ok) {
+        permutar(arr, ancho, p, *n, fila);
+    }
+    free(p);
+    free(fila);
+
+    if (ok && (opciones & ORDENAR_SIN_REPETIDAS) && (*n > 0)) {
+        m = 1;
+        for (size_t i = 1; i < *n; ++i) {
+            if (0 != strcmp(arr + i * ancho, arr + (m - 1) * ancho)) {
+                if (i != m) {
+                    memcpy(arr + m * ancho, arr + i * ancho, ancho);
+                }
+                ++m;
+            }
+        }
+        *n = m;
+    }
+
+    return ok;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Ordenamiento de muchas cadenas, más rápido que qsort con strcmp.
+ *
+ * qsort compara cadenas completas una y otra vez desde el primer caracter. Estos algoritmos miran cada caracter de cada
+ * cadena pocas veces:
+ *
+ * -   radix sort MSD (por defecto): reparte las cadenas en 256 grupos según el primer caracter, y cada grupo según el
+ *     segundo, y así. Los grupos de pocas cadenas se terminan con inserción.
+ * -   multikey quicksort (ORDENAR_MULTIKEY): un quicksort de tres vías sobre un caracter a la vez; no necesita memoria
+ *     adicional y anda mejor cuando hay muchos prefijos compartidos y pocas cadenas por grupo.
+ *
+ * Con `hilos` distinto de 1 (0: uno por procesador), si hay cadenas suficientes, el primer reparto se hace una vez y
+ * los grupos se ordenan en paralelo, los más grandes primero.
+ *
+ * Opciones (se combinan con |):
+ *
+ * -   ORDENAR_ESTABLE: las cadenas iguales quedan en el mismo orden relativo que tenían (importa en los arreglos de
+ *     punteros, donde cadenas iguales pueden ser registros distintos). Usa un arreglo auxiliar de punteros; no se
+ *     puede combinar con ORDENAR_MULTIKEY.
+ * -   ORDENAR_SIN_REPETIDAS: deja una sola de cada cadena (la primera, si además es estable) y actualiza *n.
+ *
+ * ordenar_cadenas recibe un arreglo de punteros como `char *arr[]` (ninguno NULL) y reordena los punteros.
+ * ordenar_cadenas_fijas recibe un arreglo bidimensional como `char arr[][20]`, pasando (char *) arr y el ancho de cada
+ * fila (sizeof(arr[0])); cada fila debe tener su '\0'. Ordena los punteros a las filas y después mueve cada fila una
+ * sola vez.
+ *
+ * El orden es el de strcmp (por bytes sin signo). Devuelven false si algún parámetro es inválido o si no hay memoria.
+ */
+
+#define ORDENAR_ESTABLE 0x1u
+#define ORDENAR_SIN_REPETIDAS 0x2u
+#define ORDENAR_MULTIKEY 0x4u
+
+
+bool ordenar_cadenas(char *arr[], size_t *n, unsigned opciones, size_t hilos);
+bool ordenar_cadenas_fijas(char *arr, size_t ancho, size_t *n, unsigned opciones, size_t hilos);
@@ -0,0 +1,72 @@
+#include "status.h"
+#include "arg_parser.h"
+#include "opt_parser.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * The table of names is built the first time each thread calls parse_arguments and reused afterwards (the server
+ * calls it once per request). It is per thread because opt_parse writes the values and the "seen" counters; it is
+ * never freed.
+ */
+static _Thread_local double numerador;
+static _Thread_local double denominador;
+static _Thread_local opt_t options[2];
+static _Thread_local opt_parser_t parser;
+static _Thread_local bool ready;
+
+
+static status_t build_parser(void)
+{
+    status_t st;
+
+    options[0] = (opt_t) {
+        .short_name = "-n",
+        .long_name = "--numerador",
+        .type = OPT_DOUBLE,
+        .required = true,
+        .dest = &numerador,
+        .invalid = ST_ERR_INVALID_NUMERATOR,
+    };
+    options[1] = (opt_t) {
+        .short_name = "-d",
+        .long_name = "--denominador",
+        .type = OPT_DOUBLE,
+        .required = true,
+        .dest = &denominador,
+        .invalid = ST_ERR_INVALID_DENOMINATOR,
+    };
+
+    st = opt_parser_init(&parser, options, sizeof(options) / sizeof(options[0]));
+    ready = (ST_OK == st);
+
+    return st;
+}
+
+
+status_t parse_arguments(int argc, char *argv[], double *num, double *den)
+{
+    status_t st;
+
+    if ((NULL == argv) || (NULL == num) || (NULL == den)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (!ready) {
+        st = build_parser();
+        if (ST_OK != st) {
+            return st;
+        }
+    }
+
+    st = opt_parse(&parser, argc, argv);
+    if (ST_OK != st) {
+        return st;
+    }
+
+    *num = numerador;
+    *den = denominador;
+
+    return ST_OK;
+}
@@ -0,0 +1,396 @@
+#include "status.h"
+#include "batch.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IN_BUFFER (1 << 20)
+#define OUT_BUFFER (1 << 20)
+#define MAX_TOKEN 512
+#define MAX_FORMATTED 32
+#define FAST_MAX_DIGITS 19
+#define FAST_MAX_MANTISSA (1ULL << 53)
+#define FAST_MAX_EXPONENT 22
+
+
+static const double powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+
+typedef struct {
+    FILE *out;
+    size_t used;
+    char data[OUT_BUFFER];
+} writer_t;
+
+
+/* everything a call needs, on the heap: too big for the stack, and static buffers would not be reentrant */
+typedef struct {
+    writer_t writer;
+    size_t block;
+    size_t pairs;
+    size_t zeros;
+    double num[BATCH_BLOCK];
+    double den[BATCH_BLOCK];
+    double quotients[BATCH_BLOCK];
+    char buffer[IN_BUFFER + 1];
+} batch_t;
+
+
+static bool is_blank(char c)
+{
+    return (' ' == c) || ('\n' == c) || ('\t' == c) || ('\r' == c) || ('\v' == c) || ('\f' == c);
+}
+
+
+/*
+ * Decimal numbers with at most 19 significant digits whose mantissa fits in 53 bits and whose exponent is at most
+ * 22 in absolute value are exactly m * 10^e or m / 10^-e: a single correctly rounded operation, same as strtod.
+ */
+static bool parse_fast(const char *s, const char *end, double *value)
+{
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int exp_value = 0;
+    int digits = 0;
+    bool negative = false;
+    bool exp_negative = false;
+    bool any = false;
+
+    if ((s < end) && (('-' == *s) || ('+' == *s))) {
+        negative = ('-' == *s++);
+    }
+
+    for (; (s < end) && (*s >= '0') && (*s <= '9'); ++s, any = true) {
+        if ((0 != mantissa) || ('0' != *s)) {
+            if (++digits > FAST_MAX_DIGITS) {
+                return false;
+            }
+            mantissa = mantissa * 10 + (uint64_t) (*s - '0');
+        }
+    }
+
+    if ((s < end) && ('.' == *s)) {
+        for (++s; (s < end) && (*s >= '0') && (*s <= '9'); ++s, any = true) {
+            if ((0 != mantissa) || ('0' != *s)) {
+                if (++digits > FAST_MAX_DIGITS) {
+                    return false;
+                }
+                mantissa = mantissa * 10 + (uint64_t) (*s - '0');
+            }
+            exponent--;
+        }
+    }
+
+    if (!any) {
+        return false;
+    }
+
+    if ((s < end) && (('e' == *s) || ('E' == *s))) {
+        ++s;
+        if ((s < end) && (('-' == *s) || ('+' == *s))) {
+            exp_negative = ('-' == *s++);
+        }
+        if ((s == end) || (*s < '0') || (*s > '9')) {
+            return false;
+        }
+        for (; (s < end) && (*s >= '0') && (*s <= '9'); ++s) {
+            if (exp_value < 10000) {
+                exp_value = exp_value * 10 + (*s - '0');
+            }
+        }
+        exponent += exp_negative ? -exp_value : exp_value;
+    }
+
+    if ((s != end) || (mantissa > FAST_MAX_MANTISSA)) {
+        return false;
+    }
+
+    if (0 == mantissa) {
+        *value = negative ? -0.0 : 0.0;
+        return true;
+    }
+
+    if ((exponent < -FAST_MAX_EXPONENT) || (exponent > FAST_MAX_EXPONENT)) {
+        return false;
+    }
+
+    *value = (exponent < 0) ? (double) mantissa / powers[-exponent] : (double) mantissa * powers[exponent];
+    if (negative) {
+        *value = -*value;
+    }
+
+    return true;
+}
+
+
+static bool parse_token(const char *s, const char *end, double *value)
+{
+    char token[MAX_TOKEN];
+    char *pend = NULL;
+    size_t length = (size_t) (end - s);
+
+    if (parse_fast(s, end, value)) {
+        return true;
+    }
+
+    /* anything else (hex, inf, nan, many digits, big exponents) goes through strtod, as in the single pair mode */
+    if (length >= MAX_TOKEN) {
+        return false;
+    }
+    memcpy(token, s, length);
+    token[length] = '\0';
+    *value = strtod(token, &pend);
+
+    return '\0' == *pend;
+}
+
+
+/* same output as printf("%g", v): 6 significant digits, trailing zeros removed */
+static size_t format_g(double v, char *out)
+{
+    char digits[8];
+    double a = fabs(v);
+    double scaled;
+    double frac;
+    long long m;
+    int e;
+    int decimals;
+    size_t n = 0;
+
+    if (!isfinite(v) || (a < 1e-300) || (a > 1e300)) {
+        return (size_t) snprintf(out, MAX_FORMATTED, "%g", v);
+    }
+
+    e = (int) floor(log10(a));
+    for (int tries = 0; ; ++tries) {
+        if ((tries > 2) || (5 - e > FAST_MAX_EXPONENT) || (e - 5 > FAST_MAX_EXPONENT)) {
+            return (size_t) snprintf(out, MAX_FORMATTED, "%g", v);
+        }
+        scaled = (5 - e >= 0) ? a * powers[5 - e] : a / powers[e - 5];
+        frac = scaled - floor(scaled);
+        if (fabs(frac - 0.5) < 1e-6) {
+            /* too close to a tie to trust the scaled value: let printf round it exactly */
+            return (size_t) snprintf(out, MAX_FORMATTED, "%g", v);
+        }
+        m = llround(scaled);
+        if (m >= 1000000) {
+            e++;
+        } else if (m < 100000) {
+            e--;
+        } else {
+            break;
+        }
+    }
+
+    for (int i = 5; i >= 0; --i, m /= 10) {
+        digits[i] = (char) ('0' + m % 10);
+    }
+
+    if (signbit(v)) {
+        out[n++] = '-';
+    }
+
+    if ((e >= -4) && (e < 6)) {
+        decimals = 5 - e;
+        while ((decimals > 0) && ('0' == digits[e + decimals])) {
+            decimals--;
+        }
+        if (e >= 0) {
+            memcpy(out + n, digits, (size_t) e + 1);
+            n += (size_t) e + 1;
+            if (decimals > 0) {
+                out[n++] = '.';
+                memcpy(out + n, digits + e + 1, (size_t) decimals);
+                n += (size_t) decimals;
+            }
+        } else {
+            out[n++] = '0';
+            out[n++] = '.';
+            for (int i = -1; i > e; --i) {
+                out[n++] = '0';
+            }
+            memcpy(out + n, digits, (size_t) (decimals + e + 1));
+            n += (size_t) (decimals + e + 1);
+        }
+    } else {
+        decimals = 5;
+        while ((decimals > 0) && ('0' == digits[decimals])) {
+            decimals--;
+        }
+        out[n++] = digits[0];
+        if (decimals > 0) {
+            out[n++] = '.';
+            memcpy(out + n, digits + 1, (size_t) decimals);
+            n += (size_t) decimals;
+        }
+        out[n++] = 'e';
+        out[n++] = (e < 0) ? '-' : '+';
+        e = abs(e);
+        if (e >= 100) {
+            out[n++] = (char) ('0' + e / 100);
+        }
+        out[n++] = (char) ('0' + e / 10 % 10);
+        out[n++] = (char) ('0' + e % 10);
+    }
+
+    return n;
+}
+
+
+static bool writer_flush(writer_t *w)
+{
+    bool ok = (fwrite(w->data, 1, w->used, w->out) == w->used);
+
+    w->used = 0;
+
+    return ok;
+}
+
+
+static bool write_block(writer_t *w, const double *quotients, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if ((OUT_BUFFER - w->used < MAX_FORMATTED + 1) && !writer_flush(w)) {
+            return false;
+        }
+        w->used += format_g(quotients[i], w->data + w->used);
+        w->data[w->used++] = '\n';
+    }
+
+    return true;
+}
+
+
+/* plain loop over contiguous arrays: the compiler turns it into packed divisions */
+static size_t divide_block(double *restrict quotients, const double *restrict num, const double *restrict den,
+                           size_t n)
+{
+    size_t zeros = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        quotients[i] = num[i] / den[i];
+        zeros += (0.0 == den[i]);
+    }
+
+    return zeros;
+}
+
+
+/* divides and writes the pairs of the current block */
+static bool flush_block(batch_t *b)
+{
+    b->zeros += divide_block(b->quotients, b->num, b->den, b->block);
+    if (!write_block(&b->writer, b->quotients, b->block)) {
+        return false;
+    }
+    b->pairs += b->block;
+    b->block = 0;
+
+    return true;
+}
+
+
+static status_t read_pairs(batch_t *b, FILE *in)
+{
+    char *buffer = b->buffer;
+    size_t carry = 0;
+    size_t length;
+    size_t read;
+    bool expecting_den = false;
+    bool eof = false;
+    const char *p;
+    const char *end;
+    const char *token;
+    const char *limit;
+    double value;
+
+    while (!eof) {
+        read = fread(buffer + carry, 1, IN_BUFFER - carry, in);
+        if (ferror(in)) {
+            return ST_ERR_IO;
+        }
+        length = carry + read;
+        eof = (0 == read) || feof(in);
+
+        /* without EOF the last token may continue in the next read: stop before it */
+        limit = buffer + length;
+        if (!eof) {
+            while ((limit > buffer) && !is_blank(limit[-1])) {
+                limit--;
+            }
+            if (limit == buffer) {
+                return expecting_den ? ST_ERR_INVALID_DENOMINATOR : ST_ERR_INVALID_NUMERATOR;
+            }
+        }
+
+        for (p = buffer; ; ) {
+            while ((p < limit) && is_blank(*p)) {
+                p++;
+            }
+            if (p == limit) {
+                break;
+            }
+            for (token = p; (p < limit) && !is_blank(*p); ++p) ;
+            end = p;
+
+            if (!parse_token(token, end, &value)) {
+                return expecting_den ? ST_ERR_INVALID_DENOMINATOR : ST_ERR_INVALID_NUMERATOR;
+            }
+
+            if (expecting_den) {
+                b->den[b->block++] = value;
+                if ((BATCH_BLOCK == b->block) && !flush_block(b)) {
+                    return ST_ERR_IO;
+                }
+            } else {
+                b->num[b->block] = value;
+            }
+            expecting_den = !expecting_den;
+        }
+
+        carry = (size_t) (buffer + length - limit);
+        memmove(buffer, limit, carry);
+    }
+
+    return expecting_den ? ST_ERR_INSUFFICIENT_ARGUMENTS : ST_OK;
+}
+
+
+status_t divide_batch(FILE *in, FILE *out, size_t *pairs, size_t *zeros)
+{
+    batch_t *b;
+    status_t st;
+
+    if ((NULL == in) || (NULL == out) || (NULL == pairs) || (NULL == zeros)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    b = (batch_t *) malloc(sizeof(batch_t));
+    if (NULL == b) {
+        return ST_ERR_NO_MEMORY;
+    }
+    b->writer.out = out;
+    b->writer.used = 0;
+    b->block = 0;
+    b->pairs = 0;
+    b->zeros = 0;
+
+    st = read_pairs(b, in);
+
+    /* the pairs before an invalid one are answered too, so `pairs` is the index of the one that failed */
+    if ((ST_ERR_IO != st) && (!flush_block(b) || !writer_flush(&b->writer) || (0 != fflush(out)))) {
+        st = ST_ERR_IO;
+    }
+    *pairs = b->pairs;
+    *zeros = b->zeros;
+    free(b);
+
+    return st;
+}
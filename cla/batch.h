@@ -0,0 +1,25 @@
+#pragma once
+#include "status.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Modo por lotes del divisor.
+ *
+ * Lee de `in` pares "numerador denominador" separados por blancos (típicamente uno por línea) y escribe en `out` un
+ * cociente por línea, con el mismo formato que printf("%g\n"). La entrada se lee en bloques grandes, los números se
+ * convierten sin copiarlos (strtod sólo se usa para los casos que el camino rápido no puede resolver con exactitud),
+ * los cocientes se calculan de a BATCH_BLOCK en un ciclo vectorizable y la salida se arma en un buffer propio.
+ *
+ * Las divisiones por cero dan inf, -inf o nan (como en el modo de un par) y se cuentan en `zeros`.
+ *
+ * Si un número no es válido, o si el último par no tiene denominador, igual se escriben los cocientes de los pares
+ * anteriores y `pairs` queda con el índice (desde 0) del par con el error. Cada llamada usa su propia memoria, así que
+ * puede usarse desde varios hilos a la vez (con distintos archivos).
+ */
+
+#define BATCH_BLOCK 4096
+
+
+status_t divide_batch(FILE *in, FILE *out, size_t *pairs, size_t *zeros);
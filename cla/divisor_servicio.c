@@ -0,0 +1,142 @@
+#include "status.h"
+#include "arg_parser.h"
+#include "batch.h"
+#include "server.h"
+#include "response_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * divisor para muchas divisiones. Los `@archivo` se reemplazan por su contenido antes que nada; sin opciones de modo
+ * divide un único par con el mismo parse_arguments que divisor.c, y además:
+ *
+ * -   `--batch [archivo]` divide todos los pares del archivo (o de stdin).
+ * -   `--serve socket [hilos]` atiende pedidos por un socket Unix hasta recibir SIGINT o SIGTERM.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -pthread -o divisor_servicio divisor_servicio.c arg_tabla.c opt_parser.c \
+ *       batch.c server.c response_file.c status.c -lm
+ */
+
+#define BATCH_OPTION "--batch"
+#define SERVE_OPTION "--serve"
+
+
+/* divisor_servicio --batch [archivo]: divide todos los pares del archivo (o de stdin) */
+static int main_batch(int argc, char *argv[])
+{
+    status_t st;
+    FILE *in = stdin;
+    size_t pairs;
+    size_t zeros;
+
+    if (argc > 3) {
+        fprintf(stderr, "Failed to parse arguments (%s)\n", err_to_str(ST_ERR_TOO_MANY_ARGUMENTS));
+        return EXIT_FAILURE;
+    }
+
+    if ((3 == argc) && strcmp(argv[2], "-")) {
+        in = fopen(argv[2], "r");
+        if (NULL == in) {
+            fprintf(stderr, "Failed to open %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    st = divide_batch(in, stdout, &pairs, &zeros);
+    if (stdin != in) {
+        fclose(in);
+    }
+    if (ST_OK != st) {
+        fprintf(stderr, "Failed to process batch at pair %zu (%s)\n", pairs + 1, err_to_str(st));
+        return EXIT_FAILURE;
+    }
+
+    if (0 != zeros) {
+        fprintf(stderr, "%zu of %zu divisions by zero\n", zeros, pairs);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/* divisor_servicio --serve socket [workers]: atiende pedidos por un socket Unix hasta recibir SIGINT o SIGTERM */
+static int main_serve(int argc, char *argv[])
+{
+    status_t st;
+    size_t workers = SERVER_DEFAULT_WORKERS;
+    char *pend = NULL;
+
+    if (argc < 3) {
+        fprintf(stderr, "Failed to parse arguments (%s)\n", err_to_str(ST_ERR_INSUFFICIENT_ARGUMENTS));
+        return EXIT_FAILURE;
+    }
+
+    if (argc > 4) {
+        fprintf(stderr, "Failed to parse arguments (%s)\n", err_to_str(ST_ERR_TOO_MANY_ARGUMENTS));
+        return EXIT_FAILURE;
+    }
+
+    if (4 == argc) {
+        workers = strtoul(argv[3], &pend, 10);
+        if ('\0' != *pend) {
+            fprintf(stderr, "Failed to parse arguments (%s)\n", err_to_str(ST_ERR_INVALID_ARG));
+            return EXIT_FAILURE;
+        }
+    }
+
+    st = serve(argv[2], workers);
+    if (ST_OK != st) {
+        fprintf(stderr, "Server failed (%s)\n", err_to_str(st));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+static int run(int argc, char *argv[])
+{
+    status_t st;
+    double num;
+    double den;
+
+    if ((argc > 1) && !strcmp(argv[1], BATCH_OPTION)) {
+        return main_batch(argc, argv);
+    }
+
+    if ((argc > 1) && !strcmp(argv[1], SERVE_OPTION)) {
+        return main_serve(argc, argv);
+    }
+
+    st = parse_arguments(argc, argv, &num, &den);
+    if (ST_OK != st) {
+        fprintf(stderr, "Failed to parse arguments (%s)\n", err_to_str(st));
+        return EXIT_FAILURE;
+    }
+
+    printf("%g\n", num / den);
+
+    return EXIT_SUCCESS;
+}
+
+
+/* los `@archivo` se expanden antes de cualquier otro procesamiento */
+int main (int argc, char *argv[])
+{
+    response_args_t args;
+    status_t st;
+    int status;
+
+    st = response_expand(argc, argv, &args);
+    if (ST_OK != st) {
+        fprintf(stderr, "Failed to read response file (%s)\n", err_to_str(st));
+        return EXIT_FAILURE;
+    }
+
+    status = run(args.argc, args.argv);
+    response_free(&args);
+
+    return status;
+}
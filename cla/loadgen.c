@@ -0,0 +1,289 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Generador de carga para `divisor_servicio --serve`.
+ *
+ * Abre `conexiones` conexiones (un hilo cada una); por cada una envía `pedidos` pedidos con los argumentos dados,
+ * manteniendo hasta `profundidad` pedidos en vuelo. Informa el throughput y los percentiles de latencia.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -pthread -o loadgen loadgen.c
+ * $ ./loadgen /tmp/divisor.sock 4 100000 16 -n 10 -d 4
+ */
+
+#define MAX_CONNECTIONS 256
+#define RESPONSES_PER_READ 256
+
+
+typedef struct {
+    const char *path;
+    const char *frame;
+    size_t frame_length;
+    size_t requests;
+    size_t depth;
+    uint64_t *latencies;
+    size_t measured;
+    size_t failed;
+    size_t errors;
+} client_t;
+
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+
+static bool write_full(int fd, const char *buf, size_t length)
+{
+    ssize_t w;
+
+    while (length > 0) {
+        w = write(fd, buf, length);
+        if (w < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        buf += w;
+        length -= (size_t) w;
+    }
+
+    return true;
+}
+
+
+static int connect_to(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (0 != connect(fd, (struct sockaddr *) &addr, sizeof(addr))) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+static bool send_request(int fd, client_t *c, uint32_t id, char *frame, uint64_t *sent_at)
+{
+    request_header_t header;
+
+    memcpy(&header, frame, sizeof(header));
+    header.id = id;
+    memcpy(frame, &header, sizeof(header));
+    sent_at[id] = now_ns();
+
+    return write_full(fd, frame, c->frame_length);
+}
+
+
+static void *client_loop(void *arg)
+{
+    client_t *c = (client_t *) arg;
+    response_t responses[RESPONSES_PER_READ];
+    uint64_t *sent_at;
+    char *frame;
+    size_t sent = 0;
+    size_t received = 0;
+    size_t measured = 0;
+    size_t buffered = 0;
+    ssize_t r;
+    int fd;
+
+    sent_at = (uint64_t *) malloc(c->requests * sizeof(uint64_t));
+    frame = (char *) malloc(c->frame_length);
+    fd = connect_to(c->path);
+    if ((NULL == sent_at) || (NULL == frame) || (fd < 0)) {
+        c->errors = c->requests;
+        free(sent_at);
+        free(frame);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    memcpy(frame, c->frame, c->frame_length);
+
+    while ((sent < c->requests) && (sent < c->depth)) {
+        if (!send_request(fd, c, (uint32_t) sent, frame, sent_at)) {
+            break;
+        }
+        sent++;
+    }
+
+    while (received < sent) {
+        r = read(fd, (char *) responses + buffered, sizeof(responses) - buffered);
+        if (r <= 0) {
+            if ((r < 0) && (EINTR == errno)) {
+                continue;
+            }
+            break;
+        }
+        buffered += (size_t) r;
+
+        for (size_t i = 0; i < buffered / sizeof(response_t); ++i) {
+            received++;
+            /* not one of the requests sent: an error, with no latency to record */
+            if (responses[i].id >= sent) {
+                c->errors++;
+                continue;
+            }
+            c->latencies[measured++] = now_ns() - sent_at[responses[i].id];
+            if (ST_OK != responses[i].status) {
+                c->failed++;
+            }
+            /* one answer out, one request in: the pipeline stays `depth` deep */
+            if ((sent < c->requests) && send_request(fd, c, (uint32_t) sent, frame, sent_at)) {
+                sent++;
+            }
+        }
+        memmove(responses, (char *) responses + buffered / sizeof(response_t) * sizeof(response_t),
+                buffered % sizeof(response_t));
+        buffered %= sizeof(response_t);
+    }
+
+    c->errors += c->requests - received;
+    c->measured = measured;
+    close(fd);
+    free(frame);
+    free(sent_at);
+
+    return NULL;
+}
+
+
+static int compare_u64(const void *lhs, const void *rhs)
+{
+    uint64_t l = *(const uint64_t *) lhs;
+    uint64_t r = *(const uint64_t *) rhs;
+
+    return (l > r) - (l < r);
+}
+
+
+static double percentile(const uint64_t *sorted, size_t n, double p)
+{
+    return (0 == n) ? 0 : sorted[(size_t) (p * (n - 1))] / 1e3;
+}
+
+
+int main(int argc, char *argv[])
+{
+    static client_t clients[MAX_CONNECTIONS];
+    pthread_t threads[MAX_CONNECTIONS];
+    request_header_t header = {0};
+    uint64_t *latencies;
+    char *frame;
+    size_t connections;
+    size_t requests;
+    size_t depth;
+    size_t payload = 0;
+    size_t total = 0;
+    size_t failed = 0;
+    size_t errors = 0;
+    uint64_t t0;
+    double seconds;
+
+    if (argc < 5) {
+        fprintf(stderr, "Uso: %s socket conexiones pedidos profundidad [argumentos...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    connections = strtoul(argv[2], NULL, 10);
+    requests = strtoul(argv[3], NULL, 10);
+    depth = strtoul(argv[4], NULL, 10);
+    if ((0 == connections) || (connections > MAX_CONNECTIONS) || (0 == requests) || (requests > UINT32_MAX)
+        || (0 == depth) || (argc - 5 > SERVER_MAX_ARGS)) {
+        fprintf(stderr, "Parámetros inválidos\n");
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 5; i < argc; ++i) {
+        payload += strlen(argv[i]) + 1;
+    }
+    if (payload > SERVER_MAX_PAYLOAD) {
+        fprintf(stderr, "Argumentos demasiado largos\n");
+        return EXIT_FAILURE;
+    }
+
+    frame = (char *) malloc(sizeof(header) + payload);
+    latencies = (uint64_t *) malloc(connections * requests * sizeof(uint64_t));
+    if ((NULL == frame) || (NULL == latencies)) {
+        fprintf(stderr, "Not enough memory\n");
+        free(frame);
+        free(latencies);
+        return EXIT_FAILURE;
+    }
+
+    header.argc = (uint16_t) (argc - 5);
+    header.length = (uint16_t) payload;
+    memcpy(frame, &header, sizeof(header));
+    payload = sizeof(header);
+    for (int i = 5; i < argc; ++i) {
+        memcpy(frame + payload, argv[i], strlen(argv[i]) + 1);
+        payload += strlen(argv[i]) + 1;
+    }
+
+    t0 = now_ns();
+    for (size_t i = 0; i < connections; ++i) {
+        clients[i].path = argv[1];
+        clients[i].frame = frame;
+        clients[i].frame_length = payload;
+        clients[i].requests = requests;
+        clients[i].depth = depth;
+        clients[i].latencies = latencies + i * requests;
+        pthread_create(&threads[i], NULL, client_loop, &clients[i]);
+    }
+
+    for (size_t i = 0; i < connections; ++i) {
+        pthread_join(threads[i], NULL);
+        /* compact the answered latencies of every client at the start of the array */
+        memmove(latencies + total, clients[i].latencies, clients[i].measured * sizeof(uint64_t));
+        total += clients[i].measured;
+        failed += clients[i].failed;
+        errors += clients[i].errors;
+    }
+    seconds = (now_ns() - t0) * 1e-9;
+
+    qsort(latencies, total, sizeof(uint64_t), compare_u64);
+
+    printf("%zu respuestas en %.3f s (%.0f pedidos/s), %zu con error de parseo, %zu sin respuesta o inválidas\n",
+           total, seconds, total / seconds, failed, errors);
+    printf("latencia [us]: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+           percentile(latencies, total, 0.5), percentile(latencies, total, 0.9), percentile(latencies, total, 0.99),
+           percentile(latencies, total, 0.999), percentile(latencies, total, 1));
+
+    free(frame);
+    free(latencies);
+
+    return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,380 @@
+#include "status.h"
+#include "opt_parser.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_TABLE_SIZE 8
+#define MAX_TABLE_SIZE (1UL << 20)
+#define KEYS_PER_BUCKET 4
+#define MAX_DISPLACEMENT 65536
+#define BUCKET_SEED 0x9e3779b9u
+#define EMPTY_SLOT -1
+
+
+typedef struct {
+    int key;
+    const char *name;
+    size_t bucket;
+    size_t bucket_size;
+} entry_t;
+
+
+static uint32_t hash(uint32_t seed, const char *s, size_t length)
+{
+    uint32_t h = 2166136261u ^ seed;
+
+    for (size_t i = 0; i < length; ++i) {
+        h ^= (unsigned char) s[i];
+        h *= 16777619u;
+    }
+
+    /* final mix so that the low bits (the ones used as index) depend on every character */
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+
+    return h;
+}
+
+
+static const char *key_name(const opt_t *options, int key)
+{
+    const opt_t *opt = &options[key / 2];
+
+    return (0 == key % 2) ? opt->short_name : opt->long_name;
+}
+
+
+/* biggest buckets first: they are the hardest to place */
+static int compare_entries(const void *lhs, const void *rhs)
+{
+    const entry_t *l = (const entry_t *) lhs;
+    const entry_t *r = (const entry_t *) rhs;
+
+    if (l->bucket_size != r->bucket_size) {
+        return (l->bucket_size < r->bucket_size) ? 1 : -1;
+    }
+
+    return (l->bucket < r->bucket) ? -1 : (l->bucket > r->bucket);
+}
+
+
+/* finds, bucket by bucket, a displacement that sends all its names to free slots */
+static bool place(opt_parser_t *parser, const entry_t *entries, size_t n_entries)
+{
+    size_t placed[KEYS_PER_BUCKET * 8];
+    size_t end;
+    size_t slot;
+    size_t k;
+    uint32_t d;
+
+    for (size_t i = 0; i <= parser->mask; ++i) {
+        parser->slots[i] = EMPTY_SLOT;
+    }
+    for (size_t i = 0; i < parser->n_buckets; ++i) {
+        parser->displacement[i] = 0;
+    }
+
+    for (size_t i = 0; i < n_entries; i = end) {
+        for (end = i; (end < n_entries) && (entries[end].bucket == entries[i].bucket); ++end) ;
+        if (end - i > sizeof(placed) / sizeof(placed[0])) {
+            return false;
+        }
+
+        for (d = 1; d <= MAX_DISPLACEMENT; ++d) {
+            for (k = i; k < end; ++k) {
+                slot = hash(d, entries[k].name, strlen(entries[k].name)) & parser->mask;
+                if (EMPTY_SLOT != parser->slots[slot]) {
+                    break;
+                }
+                parser->slots[slot] = entries[k].key;
+                placed[k - i] = slot;
+            }
+            if (k == end) {
+                break;
+            }
+            while (k-- > i) {
+                parser->slots[placed[k - i]] = EMPTY_SLOT;
+            }
+        }
+        if (d > MAX_DISPLACEMENT) {
+            return false;
+        }
+        parser->displacement[entries[i].bucket] = d;
+    }
+
+    return true;
+}
+
+
+static status_t build_table(opt_parser_t *parser)
+{
+    entry_t *entries;
+    size_t *sizes;
+    size_t n_entries = 0;
+    size_t size = MIN_TABLE_SIZE;
+    const char *name;
+    status_t st = ST_ERR_UNKNOWN;
+
+    entries = (entry_t *) malloc((2 * parser->n_options + 1) * sizeof(entry_t));
+    parser->n_buckets = 2 * parser->n_options / KEYS_PER_BUCKET + 1;
+    sizes = (size_t *) calloc(parser->n_buckets, sizeof(size_t));
+    parser->displacement = (uint32_t *) malloc(parser->n_buckets * sizeof(uint32_t));
+    if ((NULL == entries) || (NULL == sizes) || (NULL == parser->displacement)) {
+        free(entries);
+        free(sizes);
+        return ST_ERR_NO_MEMORY;
+    }
+
+    for (int key = 0; (size_t) key < 2 * parser->n_options; ++key) {
+        name = key_name(parser->options, key);
+        if (NULL != name) {
+            entries[n_entries].key = key;
+            entries[n_entries].name = name;
+            entries[n_entries].bucket = hash(BUCKET_SEED, name, strlen(name)) % parser->n_buckets;
+            sizes[entries[n_entries].bucket]++;
+            n_entries++;
+        }
+    }
+    for (size_t i = 0; i < n_entries; ++i) {
+        entries[i].bucket_size = sizes[entries[i].bucket];
+    }
+    qsort(entries, n_entries, sizeof(entry_t), compare_entries);
+
+    /* equal names land in the same bucket and could never be told apart */
+    for (size_t i = 0; i < n_entries; ++i) {
+        for (size_t j = i + 1; (j < n_entries) && (entries[j].bucket == entries[i].bucket); ++j) {
+            if (!strcmp(entries[i].name, entries[j].name)) {
+                free(entries);
+                free(sizes);
+                return ST_ERR_INVALID_ARG;
+            }
+        }
+    }
+
+    /* at most half full */
+    while (size < 2 * n_entries) {
+        size *= 2;
+    }
+
+    for (; size <= MAX_TABLE_SIZE; size *= 2) {
+        free(parser->slots);
+        parser->slots = (int *) malloc(size * sizeof(int));
+        if (NULL == parser->slots) {
+            st = ST_ERR_NO_MEMORY;
+            break;
+        }
+        parser->mask = size - 1;
+        if (place(parser, entries, n_entries)) {
+            st = ST_OK;
+            break;
+        }
+    }
+
+    free(entries);
+    free(sizes);
+
+    return st;
+}
+
+
+status_t opt_parser_init(opt_parser_t *parser, const opt_t *options, size_t n_options)
+{
+    status_t st;
+
+    if ((NULL == parser) || (NULL == options)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    parser->options = options;
+    parser->n_options = n_options;
+    parser->generation = 0;
+    parser->n_required = 0;
+    parser->slots = NULL;
+    parser->displacement = NULL;
+    parser->seen = (size_t *) calloc(n_options + 1, sizeof(size_t));
+    parser->seen_generation = (unsigned long *) calloc(n_options + 1, sizeof(unsigned long));
+    if ((NULL == parser->seen) || (NULL == parser->seen_generation)) {
+        opt_parser_free(parser);
+        return ST_ERR_NO_MEMORY;
+    }
+
+    for (size_t i = 0; i < n_options; ++i) {
+        if (((NULL == options[i].short_name) && (NULL == options[i].long_name)) || (NULL == options[i].dest)
+            || (options[i].repeated && (0 == options[i].capacity) && (OPT_FLAG != options[i].type))) {
+            opt_parser_free(parser);
+            return ST_ERR_INVALID_ARG;
+        }
+        if (options[i].required) {
+            parser->n_required++;
+        }
+    }
+
+    st = build_table(parser);
+    if (ST_OK != st) {
+        opt_parser_free(parser);
+    }
+
+    return st;
+}
+
+
+const opt_t *opt_lookup(const opt_parser_t *parser, const char *name, size_t length)
+{
+    const char *candidate;
+    uint32_t d;
+    int key;
+
+    if ((NULL == parser) || (NULL == parser->slots) || (NULL == name)) {
+        return NULL;
+    }
+
+    d = parser->displacement[hash(BUCKET_SEED, name, length) % parser->n_buckets];
+    if (0 == d) {
+        return NULL;
+    }
+
+    key = parser->slots[hash(d, name, length) & parser->mask];
+    if (EMPTY_SLOT == key) {
+        return NULL;
+    }
+
+    /* the hash is perfect for the known names only: an unknown one still has to be rejected */
+    candidate = key_name(parser->options, key);
+    if ((0 != strncmp(candidate, name, length)) || ('\0' != candidate[length])) {
+        return NULL;
+    }
+
+    return &parser->options[key / 2];
+}
+
+
+static status_t store_value(const opt_t *opt, const char *value, size_t index)
+{
+    status_t invalid = (ST_OK == opt->invalid) ? ST_ERR_INVALID_ARG : opt->invalid;
+    char *pend = NULL;
+    double d;
+    long l;
+
+    switch (opt->type) {
+        case OPT_DOUBLE:
+            d = strtod(value, &pend);
+            if (('\0' == *value) || ('\0' != *pend)) {
+                return invalid;
+            }
+            ((double *) opt->dest)[index] = d;
+            break;
+        case OPT_LONG:
+            errno = 0;
+            l = strtol(value, &pend, 10);
+            if (('\0' == *value) || ('\0' != *pend) || (ERANGE == errno)) {
+                return invalid;
+            }
+            ((long *) opt->dest)[index] = l;
+            break;
+        case OPT_STRING:
+            ((const char **) opt->dest)[index] = value;
+            break;
+        default:
+            return ST_ERR_INVALID_ARG;
+    }
+
+    return ST_OK;
+}
+
+
+status_t opt_parse(opt_parser_t *parser, int argc, char *argv[])
+{
+    const opt_t *opt;
+    const char *value;
+    const char *eq;
+    size_t length;
+    size_t idx;
+    size_t required_seen = 0;
+    status_t st;
+
+    if ((NULL == parser) || (NULL == parser->slots) || (NULL == argv)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    /* a new generation resets every "seen" counter without touching them */
+    parser->generation++;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((NULL == argv[i]) || ('-' != argv[i][0])) {
+            return ST_ERR_UNKNOWN_ARGUMENT;
+        }
+
+        eq = strchr(argv[i], '=');
+        length = (NULL != eq) ? (size_t) (eq - argv[i]) : strlen(argv[i]);
+        opt = opt_lookup(parser, argv[i], length);
+        if (NULL == opt) {
+            return ST_ERR_UNKNOWN_ARGUMENT;
+        }
+
+        idx = (size_t) (opt - parser->options);
+        if (parser->seen_generation[idx] != parser->generation) {
+            parser->seen_generation[idx] = parser->generation;
+            parser->seen[idx] = 0;
+        }
+        if ((0 != parser->seen[idx]) && !opt->repeated) {
+            return ST_ERR_DUPLICATED_ARGUMENT;
+        }
+        if ((0 == parser->seen[idx]) && opt->required) {
+            required_seen++;
+        }
+
+        if (OPT_FLAG == opt->type) {
+            if (NULL != eq) {
+                return (ST_OK == opt->invalid) ? ST_ERR_INVALID_ARG : opt->invalid;
+            }
+            *(bool *) opt->dest = true;
+        } else {
+            if (NULL != eq) {
+                value = eq + 1;
+            } else if (i + 1 < argc) {
+                value = argv[++i];
+            } else {
+                return ST_ERR_MISSING_VALUE;
+            }
+
+            if (opt->repeated && (parser->seen[idx] >= opt->capacity)) {
+                return ST_ERR_TOO_MANY_ARGUMENTS;
+            }
+
+            st = store_value(opt, value, opt->repeated ? parser->seen[idx] : 0);
+            if (ST_OK != st) {
+                return st;
+            }
+        }
+
+        parser->seen[idx]++;
+        if (NULL != opt->count) {
+            *opt->count = parser->seen[idx];
+        }
+    }
+
+    if (required_seen != parser->n_required) {
+        return ST_ERR_INSUFFICIENT_ARGUMENTS;
+    }
+
+    return ST_OK;
+}
+
+
+void opt_parser_free(opt_parser_t *parser)
+{
+    if (NULL != parser) {
+        free(parser->slots);
+        parser->slots = NULL;
+        free(parser->displacement);
+        parser->displacement = NULL;
+        free(parser->seen);
+        parser->seen = NULL;
+        free(parser->seen_generation);
+        parser->seen_generation = NULL;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "status.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Procesamiento de argumentos a partir de una tabla de opciones.
+ *
+ * Cada opción se declara una única vez (nombre corto y/o largo, tipo, si es obligatoria y si puede repetirse) junto
+ * con el destino donde se guarda su valor. opt_parser_init arma, una sola vez, una tabla de hash perfecta (sin
+ * colisiones) con todos los nombres: un primer hash elige un grupo y el desplazamiento guardado para ese grupo elige
+ * la posición final. Así cada argumento se resuelve con dos hashes y una única comparación, y el procesamiento es
+ * O(argc) sin importar cuántas opciones haya.
+ *
+ * Los valores se aceptan como `--opcion valor`, `--opcion=valor`, `-o valor` o `-o=valor`. Las opciones OPT_FLAG no
+ * llevan valor.
+ *
+ * Las opciones no obligatorias conservan el valor que tenga su destino (el valor por omisión). Si ocurre un error,
+ * algunos destinos pueden haber sido modificados.
+ */
+
+typedef enum {
+    OPT_FLAG,
+    OPT_DOUBLE,
+    OPT_LONG,
+    OPT_STRING,
+} opt_type_t;
+
+
+typedef struct {
+    const char *short_name;
+    const char *long_name;
+    opt_type_t type;
+    bool required;
+    bool repeated;
+    /* bool *, double *, long * o const char **; si `repeated`, un arreglo de `capacity` elementos */
+    void *dest;
+    size_t capacity;
+    size_t *count;
+    /* estado a devolver si el valor no se puede convertir (ST_OK: ST_ERR_INVALID_ARG) */
+    status_t invalid;
+} opt_t;
+
+
+typedef struct {
+    const opt_t *options;
+    size_t n_options;
+    size_t n_buckets;
+    uint32_t *displacement;
+    size_t mask;
+    int *slots;
+    unsigned long *seen_generation;
+    size_t *seen;
+    unsigned long generation;
+    size_t n_required;
+} opt_parser_t;
+
+
+status_t opt_parser_init(opt_parser_t *parser, const opt_t *options, size_t n_options);
+status_t opt_parse(opt_parser_t *parser, int argc, char *argv[]);
+const opt_t *opt_lookup(const opt_parser_t *parser, const char *name, size_t length);
+void opt_parser_free(opt_parser_t *parser);
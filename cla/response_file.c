@@ -0,0 +1,263 @@
+#define _DEFAULT_SOURCE
+
+#include "status.h"
+#include "response_file.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RESPONSE_PREFIX '@'
+
+
+static bool is_blank(char c)
+{
+    return (' ' == c) || ('\n' == c) || ('\t' == c) || ('\r' == c) || ('\v' == c) || ('\f' == c);
+}
+
+
+/*
+ * Rewrites the `length` bytes at `data` as consecutive NUL-terminated arguments, starting at `data`. Quotes and
+ * escapes only ever remove characters, so the write position never passes the read position; the last terminator
+ * goes at data[length], which the caller guarantees to be writable.
+ */
+static status_t tokenize(char *data, size_t length, size_t *count)
+{
+    size_t r = 0;
+    size_t w = 0;
+    size_t n = 0;
+    bool line_start = true;
+    bool in_token = false;
+    char quote = '\0';
+    char c;
+
+    while (r < length) {
+        c = data[r++];
+
+        if ('\0' != quote) {
+            if (quote == c) {
+                quote = '\0';
+            } else if (('\\' == c) && ('"' == quote) && (r < length)) {
+                data[w++] = data[r++];
+            } else {
+                data[w++] = c;
+            }
+            continue;
+        }
+
+        if (is_blank(c)) {
+            if (in_token) {
+                data[w++] = '\0';
+                n++;
+                in_token = false;
+            }
+            line_start = line_start || ('\n' == c);
+            continue;
+        }
+
+        if (line_start && !in_token && ('#' == c)) {
+            while ((r < length) && ('\n' != data[r])) {
+                r++;
+            }
+            continue;
+        }
+
+        line_start = false;
+        in_token = true;
+        if (('"' == c) || ('\'' == c)) {
+            quote = c;
+        } else if (('\\' == c) && (r < length)) {
+            data[w++] = data[r++];
+        } else {
+            data[w++] = c;
+        }
+    }
+
+    if ('\0' != quote) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    if (in_token) {
+        data[w] = '\0';
+        n++;
+    }
+
+    *count = n;
+
+    return ST_OK;
+}
+
+
+/* private writable mapping with at least one extra zeroed byte after the contents */
+static status_t map_file(const char *path, response_map_t *map, size_t *size)
+{
+    struct stat st;
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    void *data;
+    int fd;
+
+    map->data = NULL;
+    map->length = 0;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return ST_ERR_IO;
+    }
+
+    if ((0 != fstat(fd, &st)) || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return ST_ERR_IO;
+    }
+
+    *size = (size_t) st.st_size;
+    if (0 == *size) {
+        close(fd);
+        return ST_OK;
+    }
+
+    /*
+     * An anonymous reservation covering size + 1 bytes, with the file mapped over its beginning: the byte after the
+     * contents is either the zero tail of the last file page or the first byte of an anonymous page.
+     */
+    map->length = (*size + 1 + page - 1) / page * page;
+    map->data = mmap(NULL, map->length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == map->data) {
+        map->data = NULL;
+        close(fd);
+        return ST_ERR_NO_MEMORY;
+    }
+
+    data = mmap(map->data, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data) {
+        munmap(map->data, map->length);
+        map->data = NULL;
+        return ST_ERR_IO;
+    }
+    madvise(map->data, *size, MADV_SEQUENTIAL);
+
+    return ST_OK;
+}
+
+
+status_t response_expand(int argc, char *argv[], response_args_t *args)
+{
+    size_t *counts;
+    size_t total = 0;
+    size_t size;
+    size_t m = 0;
+    size_t k = 0;
+    char *token;
+    status_t st = ST_OK;
+
+    if ((NULL == argv) || (NULL == args)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    args->argc = 0;
+    args->argv = NULL;
+    args->maps = NULL;
+    args->n_maps = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (RESPONSE_PREFIX == argv[i][0]) {
+            args->n_maps++;
+        }
+    }
+
+    /* nothing to expand: the original argv is used as is */
+    if (0 == args->n_maps) {
+        args->argc = argc;
+        args->argv = argv;
+        return ST_OK;
+    }
+
+    args->maps = (response_map_t *) calloc(args->n_maps, sizeof(response_map_t));
+    counts = (size_t *) calloc(args->n_maps, sizeof(size_t));
+    if ((NULL == args->maps) || (NULL == counts)) {
+        free(counts);
+        response_free(args);
+        return ST_ERR_NO_MEMORY;
+    }
+
+    /* first pass: map and tokenize every file, to know the final argc */
+    for (int i = 0; i < argc; ++i) {
+        if ((0 != i) && (RESPONSE_PREFIX == argv[i][0])) {
+            st = map_file(argv[i] + 1, &args->maps[m], &size);
+            if ((ST_OK == st) && (0 != size)) {
+                st = tokenize(args->maps[m].data, size, &counts[m]);
+            }
+            if (ST_OK != st) {
+                break;
+            }
+            total += counts[m++];
+        } else {
+            total++;
+        }
+    }
+
+    if ((ST_OK == st) && (total >= INT_MAX)) {
+        st = ST_ERR_TOO_MANY_ARGUMENTS;
+    }
+
+    if (ST_OK == st) {
+        args->argv = (char **) malloc((total + 1) * sizeof(char *));
+        if (NULL == args->argv) {
+            st = ST_ERR_NO_MEMORY;
+        }
+    }
+
+    if (ST_OK != st) {
+        free(counts);
+        response_free(args);
+        return st;
+    }
+
+    /* second pass: the arguments of each file are consecutive strings at the start of its mapping */
+    m = 0;
+    for (int i = 0; i < argc; ++i) {
+        if ((0 != i) && (RESPONSE_PREFIX == argv[i][0])) {
+            token = (char *) args->maps[m].data;
+            for (size_t j = 0; j < counts[m]; ++j) {
+                args->argv[k++] = token;
+                while ('\0' != *token++) ;
+            }
+            m++;
+        } else {
+            args->argv[k++] = argv[i];
+        }
+    }
+    args->argv[k] = NULL;
+    args->argc = (int) k;
+
+    free(counts);
+
+    return ST_OK;
+}
+
+
+void response_free(response_args_t *args)
+{
+    if (NULL == args) {
+        return;
+    }
+
+    if (NULL != args->maps) {
+        for (size_t i = 0; i < args->n_maps; ++i) {
+            if (NULL != args->maps[i].data) {
+                munmap(args->maps[i].data, args->maps[i].length);
+            }
+        }
+        free(args->maps);
+        free(args->argv);
+    }
+
+    args->argc = 0;
+    args->argv = NULL;
+    args->maps = NULL;
+    args->n_maps = 0;
+}
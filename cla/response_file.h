@@ -0,0 +1,36 @@
+#pragma once
+#include "status.h"
+
+#include <stdlib.h>
+
+/*
+ * Archivos de respuesta (`@archivo`).
+ *
+ * Cuando la lista de opciones es demasiado larga para la línea de comandos (ARG_MAX), los argumentos pueden
+ * escribirse en un archivo y pasarse como `@archivo`. response_expand devuelve un nuevo argv en el que cada `@archivo`
+ * se reemplaza, en el mismo lugar, por los argumentos que contiene; el resto de argv se conserva tal cual. Así el
+ * procesamiento posterior (y sus diagnósticos de argumentos repetidos o desconocidos) ve una única lista.
+ *
+ * Los argumentos se separan con blancos. Las comillas simples o dobles agrupan un argumento con blancos, '\' escapa
+ * el carácter siguiente y las líneas que empiezan con '#' se ignoran. Un `@` dentro de un archivo no se expande.
+ *
+ * El archivo se proyecta en memoria (copia privada) y se separa en el mismo lugar: los argumentos apuntan a la
+ * proyección, que debe mantenerse hasta llamar a response_free. Sólo se pide memoria para el nuevo argv.
+ */
+
+typedef struct {
+    void *data;
+    size_t length;
+} response_map_t;
+
+
+typedef struct {
+    int argc;
+    char **argv;
+    response_map_t *maps;
+    size_t n_maps;
+} response_args_t;
+
+
+status_t response_expand(int argc, char *argv[], response_args_t *args);
+void response_free(response_args_t *args);
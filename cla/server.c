@@ -0,0 +1,435 @@
+#define _GNU_SOURCE
+
+#include "status.h"
+#include "arg_parser.h"
+#include "server.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define MAX_WORKERS 64
+#define MAX_EVENTS 64
+#define IN_CAPACITY (64 * 1024)
+#define OUT_CAPACITY (64 * 1024)
+#define PROGRAM_NAME "divisor"
+
+
+typedef struct {
+    int fd;
+    size_t in_used;
+    size_t out_used;
+    size_t out_sent;
+    bool waiting_out;
+    char in[IN_CAPACITY];
+    char out[OUT_CAPACITY];
+} conn_t;
+
+
+typedef struct {
+    int epfd;
+    pthread_t thread;
+} worker_t;
+
+
+static void conn_close(int epfd, conn_t *conn)
+{
+    epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn);
+}
+
+
+static void answer(conn_t *conn, const request_header_t *header, char *payload)
+{
+    char *argv[SERVER_MAX_ARGS + 2];
+    response_t response = {.id = header->id, .status = ST_OK, .quotient = 0};
+    int argc = 1;
+    size_t i = 0;
+    double num;
+    double den;
+
+    argv[0] = PROGRAM_NAME;
+    /* the last string must be terminated inside the payload, so strlen never reads past it */
+    if ((0 != header->length) && ('\0' != payload[header->length - 1])) {
+        i = SIZE_MAX;
+    }
+    while ((i < header->length) && (argc <= SERVER_MAX_ARGS)) {
+        argv[argc++] = payload + i;
+        i += strlen(payload + i) + 1;
+    }
+    argv[argc] = NULL;
+
+    if ((argc - 1 != header->argc) || (i != header->length)) {
+        response.status = ST_ERR_INVALID_ARG;
+    } else {
+        response.status = parse_arguments(argc, argv, &num, &den);
+        if (ST_OK == response.status) {
+            response.quotient = num / den;
+        }
+    }
+
+    memcpy(conn->out + conn->out_used, &response, sizeof(response));
+    conn->out_used += sizeof(response);
+}
+
+
+/* answers every complete request in the input buffer, as long as there is room for the responses */
+static bool process(conn_t *conn)
+{
+    request_header_t header;
+    size_t offset = 0;
+    size_t frame;
+
+    while (conn->in_used - offset >= sizeof(header)) {
+        memcpy(&header, conn->in + offset, sizeof(header));
+        if ((header.argc > SERVER_MAX_ARGS) || (header.length > SERVER_MAX_PAYLOAD)) {
+            return false;
+        }
+
+        frame = sizeof(header) + header.length;
+        if ((conn->in_used - offset < frame) || (OUT_CAPACITY - conn->out_used < sizeof(response_t))) {
+            break;
+        }
+
+        answer(conn, &header, conn->in + offset + sizeof(header));
+        offset += frame;
+    }
+
+    memmove(conn->in, conn->in + offset, conn->in_used - offset);
+    conn->in_used -= offset;
+
+    return true;
+}
+
+
+static bool watch(int epfd, conn_t *conn, bool out)
+{
+    struct epoll_event ev = {.events = out ? EPOLLOUT : EPOLLIN, .data.ptr = conn};
+
+    if (conn->waiting_out == out) {
+        return true;
+    }
+    conn->waiting_out = out;
+
+    return 0 == epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev);
+}
+
+
+/* returns false if the connection must be closed */
+static bool flush(int epfd, conn_t *conn)
+{
+    ssize_t w;
+
+    while (conn->out_sent < conn->out_used) {
+        w = write(conn->fd, conn->out + conn->out_sent, conn->out_used - conn->out_sent);
+        if (w < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+                /* the client is not reading: stop reading from it until it drains its responses */
+                return watch(epfd, conn, true);
+            }
+            return false;
+        }
+        conn->out_sent += (size_t) w;
+    }
+
+    conn->out_used = 0;
+    conn->out_sent = 0;
+
+    return watch(epfd, conn, false);
+}
+
+
+static bool handle(int epfd, conn_t *conn, uint32_t events)
+{
+    size_t pending;
+    ssize_t r;
+
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        if (!(events & EPOLLIN)) {
+            return false;
+        }
+    }
+
+    if (events & EPOLLOUT) {
+        if (!flush(epfd, conn)) {
+            return false;
+        }
+        if (0 != conn->out_used) {
+            return true;
+        }
+    }
+
+    /* with the input buffer full a read would return 0, as if the client had closed: its requests go first */
+    if ((events & EPOLLIN) && (conn->in_used < IN_CAPACITY)) {
+        r = read(conn->fd, conn->in + conn->in_used, IN_CAPACITY - conn->in_used);
+        if (0 == r) {
+            return false;
+        }
+        if (r < 0) {
+            return (EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno);
+        }
+        conn->in_used += (size_t) r;
+    }
+
+    /*
+     * Everything answered in this round goes out in a single write. process stops when the output is full, so while
+     * the write drains it completely the requests left in the input are answered too: epoll will not report them again.
+     */
+    do {
+        pending = conn->in_used;
+        if (!process(conn) || !flush(epfd, conn)) {
+            return false;
+        }
+    } while ((0 == conn->out_used) && (0 != conn->in_used) && (conn->in_used != pending));
+
+    return true;
+}
+
+
+static void *worker_loop(void *arg)
+{
+    worker_t *worker = (worker_t *) arg;
+    struct epoll_event events[MAX_EVENTS];
+    int n;
+
+    for (;;) {
+        n = epoll_wait(worker->epfd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            /* the only event without a connection is the one that stops the workers */
+            if (NULL == events[i].data.ptr) {
+                return NULL;
+            }
+            if (!handle(worker->epfd, events[i].data.ptr, events[i].events)) {
+                conn_close(worker->epfd, events[i].data.ptr);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+
+static int listen_on(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    if ((0 != bind(fd, (struct sockaddr *) &addr, sizeof(addr))) || (0 != listen(fd, SOMAXCONN))) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+/* starts the workers, all of them stopping once `stop_fd` becomes readable; returns how many were started */
+static size_t start_workers(worker_t *pool, size_t workers, int stop_fd)
+{
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+
+    for (size_t i = 0; i < workers; ++i) {
+        pool[i].epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (pool[i].epfd < 0) {
+            return i;
+        }
+        if ((0 != epoll_ctl(pool[i].epfd, EPOLL_CTL_ADD, stop_fd, &ev))
+            || (0 != pthread_create(&pool[i].thread, NULL, worker_loop, &pool[i]))) {
+            close(pool[i].epfd);
+            return i;
+        }
+    }
+
+    return workers;
+}
+
+
+static void stop_workers(worker_t *pool, size_t started, int stop_fd)
+{
+    uint64_t one = 1;
+
+    /* nobody reads the eventfd, so it stays readable until every worker has seen it */
+    while ((write(stop_fd, &one, sizeof(one)) < 0) && (EINTR == errno)) ;
+
+    for (size_t i = 0; i < started; ++i) {
+        pthread_join(pool[i].thread, NULL);
+        close(pool[i].epfd);
+    }
+}
+
+
+/* hands every pending connection to the workers, round-robin; from there on only that worker touches it */
+static bool accept_all(int listen_fd, worker_t *pool, size_t workers, size_t *next)
+{
+    struct epoll_event ev;
+    conn_t *conn;
+    int fd;
+
+    for (;;) {
+        fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return (EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno) || (ECONNABORTED == errno);
+        }
+
+        conn = (conn_t *) malloc(sizeof(conn_t));
+        if (NULL == conn) {
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->in_used = 0;
+        conn->out_used = 0;
+        conn->out_sent = 0;
+        conn->waiting_out = false;
+
+        ev.events = EPOLLIN;
+        ev.data.ptr = conn;
+        if (0 != epoll_ctl(pool[*next].epfd, EPOLL_CTL_ADD, fd, &ev)) {
+            close(fd);
+            free(conn);
+            continue;
+        }
+        *next = (*next + 1) % workers;
+    }
+}
+
+
+/*
+ * SIGINT and SIGTERM arrive through `signal_fd`, in the same epoll_wait as the connections: unlike a flag set by a
+ * handler, a signal that arrives while a connection is being accepted is not lost, it just wakes the next wait.
+ */
+static status_t accept_loop(int listen_fd, int signal_fd, worker_t *pool, size_t workers)
+{
+    struct epoll_event events[2];
+    struct epoll_event ev = {.events = EPOLLIN};
+    struct signalfd_siginfo info;
+    size_t next = 0;
+    int epfd;
+    int n;
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        return ST_ERR_UNKNOWN;
+    }
+    ev.data.fd = listen_fd;
+    if (0 != epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &ev)) {
+        close(epfd);
+        return ST_ERR_UNKNOWN;
+    }
+    ev.data.fd = signal_fd;
+    if (0 != epoll_ctl(epfd, EPOLL_CTL_ADD, signal_fd, &ev)) {
+        close(epfd);
+        return ST_ERR_UNKNOWN;
+    }
+
+    for (;;) {
+        n = epoll_wait(epfd, events, 2, -1);
+        if ((n < 0) && (EINTR != errno)) {
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (signal_fd == events[i].data.fd) {
+                /* consumed here, so it is not delivered again once the mask is restored */
+                while ((read(signal_fd, &info, sizeof(info)) < 0) && (EINTR == errno)) ;
+                close(epfd);
+                return ST_OK;
+            }
+        }
+        if ((n > 0) && !accept_all(listen_fd, pool, workers, &next)) {
+            break;
+        }
+    }
+
+    close(epfd);
+
+    return ST_ERR_IO;
+}
+
+
+status_t serve(const char *path, size_t workers)
+{
+    static worker_t pool[MAX_WORKERS];
+    sigset_t mask;
+    sigset_t old_mask;
+    size_t started;
+    status_t st;
+    int listen_fd;
+    int signal_fd;
+    int stop_fd;
+
+    if (NULL == path) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if ((0 == workers) || (workers > MAX_WORKERS)) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    /* blocked before starting the workers, so they inherit the mask and only signal_fd sees SIGINT/SIGTERM */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+
+    signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    stop_fd = eventfd(0, EFD_CLOEXEC);
+    listen_fd = listen_on(path);
+    if ((signal_fd < 0) || (stop_fd < 0) || (listen_fd < 0)) {
+        st = (listen_fd < 0) ? ST_ERR_IO : ST_ERR_UNKNOWN;
+    } else {
+        started = start_workers(pool, workers, stop_fd);
+        st = (started == workers) ? accept_loop(listen_fd, signal_fd, pool, workers) : ST_ERR_UNKNOWN;
+        stop_workers(pool, started, stop_fd);
+    }
+
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(path);
+    }
+    if (stop_fd >= 0) {
+        close(stop_fd);
+    }
+    if (signal_fd >= 0) {
+        close(signal_fd);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    return st;
+}
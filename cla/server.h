@@ -0,0 +1,39 @@
+#pragma once
+#include "status.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Divisor como servicio sobre un socket Unix.
+ *
+ * Cada pedido es un request_header_t seguido de `length` bytes con `argc` cadenas terminadas en '\0': los mismos
+ * argumentos que recibiría `divisor` por línea de comandos (sin argv[0]). El servidor los valida con
+ * parse_arguments y responde un response_t con el estado y, si es ST_OK, el cociente. Los enteros viajan en el orden
+ * de bytes de la máquina (el socket es local).
+ *
+ * Un cliente puede enviar varios pedidos seguidos sin esperar las respuestas; éstas vuelven en el mismo orden y
+ * llevan el `id` del pedido. Un hilo acepta conexiones y las reparte entre `workers` hilos, cada uno con su propia
+ * instancia de epoll.
+ */
+
+#define SERVER_MAX_ARGS 16
+#define SERVER_MAX_PAYLOAD 1024
+#define SERVER_DEFAULT_WORKERS 4
+
+
+typedef struct {
+    uint32_t id;
+    uint16_t argc;
+    uint16_t length;
+} request_header_t;
+
+
+typedef struct {
+    uint32_t id;
+    int32_t status;
+    double quotient;
+} response_t;
+
+
+status_t serve(const char *path, size_t workers);
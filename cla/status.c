@@ -11,6 +11,10 @@ static const char *err[] = {
     [ST_ERR_UNKNOWN_ARGUMENT] = "ST_ERR_UNKNOWN_ARGUMENT",
     [ST_ERR_LZERO_ARRAY] = "ST_ERR_LZERO_ARRAY",
     [ST_ERR_INVALID_ARG] = "ST_ERR_INVALID_ARG",
+    [ST_ERR_MISSING_VALUE] = "ST_ERR_MISSING_VALUE",
+    [ST_ERR_DUPLICATED_ARGUMENT] = "ST_ERR_DUPLICATED_ARGUMENT",
+    [ST_ERR_NO_MEMORY] = "ST_ERR_NO_MEMORY",
+    [ST_ERR_IO] = "ST_ERR_IO",
     [ST_ERR_UNKNOWN] = "ST_ERR_UNKNOWN",
 };
 
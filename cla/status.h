@@ -10,6 +10,10 @@ typedef enum {
     ST_ERR_UNKNOWN_ARGUMENT,
     ST_ERR_LZERO_ARRAY,
     ST_ERR_INVALID_ARG,
+    ST_ERR_MISSING_VALUE,
+    ST_ERR_DUPLICATED_ARGUMENT,
+    ST_ERR_NO_MEMORY,
+    ST_ERR_IO,
     ST_ERR_UNKNOWN,
 } status_t;
 
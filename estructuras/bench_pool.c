@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "estudiante.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Compara estudiante_crear/estudiante_free (pool) contra el mismo patrón hecho con malloc/free de glibc.
+ * Cada hilo mantiene VIVOS estudiantes y en cada iteración libera uno al azar y crea otro en su lugar.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -pthread -o bench_pool bench_pool.c estudiante.c pool.c
+ * $ ./bench_pool [hilos] [iteraciones por hilo]
+ */
+
+#define MAX_THREADS 64
+#define VIVOS 4096
+#define DEFAULT_THREADS 4
+#define DEFAULT_ITERATIONS 2000000
+
+static const char *nombres[] = {"Ana", "Juan", "María José", "Pedro", "Lucía", "Ezequiel", "Sol", "Bartolomé"};
+static const char *apellidos[] = {"Pérez", "Gómez", "Fernández", "Li", "Rodríguez", "Di Santo", "Iglesias", "Ruiz"};
+
+#define N_NOMBRES (sizeof(nombres) / sizeof(nombres[0]))
+#define N_APELLIDOS (sizeof(apellidos) / sizeof(apellidos[0]))
+
+
+typedef struct {
+    size_t iteraciones;
+    unsigned int semilla;
+} trabajo_t;
+
+
+static estudiante_t *malloc_crear(const char *nombre, const char *apellido)
+{
+    estudiante_t *e = (estudiante_t *) malloc(sizeof(estudiante_t));
+    size_t ln = strlen(nombre) + 1;
+    size_t la = strlen(apellido) + 1;
+
+    if (NULL == e) {
+        return NULL;
+    }
+    e->nombre = (char *) malloc(ln);
+    e->apellido = (char *) malloc(la);
+    if ((NULL == e->nombre) || (NULL == e->apellido)) {
+        free(e->nombre);
+        free(e->apellido);
+        free(e);
+        return NULL;
+    }
+    memcpy(e->nombre, nombre, ln);
+    memcpy(e->apellido, apellido, la);
+
+    return e;
+}
+
+
+static void malloc_free(estudiante_t **e)
+{
+    free((*e)->nombre);
+    free((*e)->apellido);
+    free(*e);
+    *e = NULL;
+}
+
+
+static unsigned int siguiente(unsigned int *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+
+    return *x;
+}
+
+
+#define DEFINIR_CHURN(nombre_fn, crear, liberar)                                                                    \
+static void *nombre_fn(void *arg)                                                                                   \
+{                                                                                                                   \
+    trabajo_t *t = (trabajo_t *) arg;                                                                               \
+    estudiante_t **vivos = (estudiante_t **) calloc(VIVOS, sizeof(estudiante_t *));                                 \
+    unsigned int r;                                                                                                 \
+    size_t k;                                                                                                       \
+                                                                                                                    \
+    if (NULL == vivos) {                                                                                            \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    for (size_t i = 0; i < t->iteraciones; ++i) {                                                                   \
+        r = siguiente(&t->semilla);                                                                                 \
+        k = r % VIVOS;                                                                                              \
+        if (NULL != vivos[k]) {                                                                                     \
+            liberar(&vivos[k]);                                                                                     \
+        }                                                                                                           \
+        vivos[k] = crear(nombres[(r >> 12) % N_NOMBRES], apellidos[(r >> 20) % N_APELLIDOS]);                       \
+    }                                                                                                               \
+                                                                                                                    \
+    for (k = 0; k < VIVOS; ++k) {                                                                                   \
+        if (NULL != vivos[k]) {                                                                                     \
+            liberar(&vivos[k]);                                                                                     \
+        }                                                                                                           \
+    }                                                                                                               \
+    free(vivos);                                                                                                    \
+                                                                                                                    \
+    return NULL;                                                                                                    \
+}
+
+DEFINIR_CHURN(churn_pool, estudiante_crear, estudiante_free)
+DEFINIR_CHURN(churn_malloc, malloc_crear, malloc_free)
+
+
+static double correr(void *(*churn)(void *), size_t hilos, size_t iteraciones)
+{
+    pthread_t th[MAX_THREADS];
+    trabajo_t trabajos[MAX_THREADS];
+    struct timespec t0;
+    struct timespec t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t i = 0; i < hilos; ++i) {
+        trabajos[i].iteraciones = iteraciones;
+        trabajos[i].semilla = 2463534242u + (unsigned int) i;
+        pthread_create(&th[i], NULL, churn, &trabajos[i]);
+    }
+    for (size_t i = 0; i < hilos; ++i) {
+        pthread_join(th[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t hilos = DEFAULT_THREADS;
+    size_t iteraciones = DEFAULT_ITERATIONS;
+    double t_pool;
+    double t_malloc;
+
+    if (argc > 1) {
+        hilos = strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        iteraciones = strtoul(argv[2], NULL, 10);
+    }
+    if ((0 == hilos) || (hilos > MAX_THREADS)) {
+        fprintf(stderr, "La cantidad de hilos debe estar entre 1 y %i\n", MAX_THREADS);
+        return EXIT_FAILURE;
+    }
+
+    t_malloc = correr(churn_malloc, hilos, iteraciones);
+    t_pool = correr(churn_pool, hilos, iteraciones);
+
+    printf("%zu hilos x %zu iteraciones (crear + liberar)\n", hilos, iteraciones);
+    printf("  malloc: %8.3f s  %8.2f Mops/s\n", t_malloc, hilos * iteraciones / t_malloc * 1e-6);
+    printf("    pool: %8.3f s  %8.2f Mops/s\n", t_pool, hilos * iteraciones / t_pool * 1e-6);
+
+    return EXIT_SUCCESS;
+}
@@ -1,10 +1,49 @@
 #include "estudiante.h"
+#include "pool.h"
+#include "../memdin/alloc_hook.h"
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 
+/* sólo los estudiantes salen del pool: los nombres son de largo variable y quien llama puede reemplazarlos */
+#define OBJETOS_POR_SLAB 1024
+
+
+static pool_t *estudiantes_pool = NULL;
+static pthread_once_t pools_once = PTHREAD_ONCE_INIT;
+
+
+static void crear_pools(void)
+{
+    estudiantes_pool = pool_create(sizeof(estudiante_t), OBJETOS_POR_SLAB);
+}
+
+
+static estudiante_t *estudiante_alloc(void)
+{
+    pthread_once(&pools_once, crear_pools);
+
+    if (NULL == estudiantes_pool) {
+        return (estudiante_t *) HOOK_MALLOC(sizeof(estudiante_t));
+    }
+
+    return (estudiante_t *) pool_alloc(estudiantes_pool);
+}
+
+
+static void estudiante_dealloc(estudiante_t *estudiante)
+{
+    if (NULL == estudiantes_pool) {
+        HOOK_FREE(estudiante);
+    } else {
+        pool_free(estudiantes_pool, estudiante);
+    }
+}
+
+
 static char *mi_strdup(const char *s)
 {
     char *copia;
@@ -16,12 +55,12 @@ static char *mi_strdup(const char *s)
 
     l = strlen(s);
 
-    copia = (char *) malloc(l + 1);
+    copia = (char *) HOOK_MALLOC(l + 1);
     if (NULL == copia) {
         return NULL;
     }
 
-    copia[l] = '\0';
+    memcpy(copia, s, l + 1);
 
     return copia;
 }
@@ -35,21 +74,21 @@ estudiante_t * estudiante_crear(const char  *nombre, const char *apellido)
         return NULL;
     }
 
-    estudiante = (estudiante_t *) calloc(1, sizeof(estudiante_t));
+    estudiante = estudiante_alloc();
     if (NULL == estudiante) {
         return NULL;
     }
 
     estudiante->nombre = mi_strdup(nombre);
     if (NULL == estudiante->nombre) {
-        free(estudiante);
+        estudiante_dealloc(estudiante);
         return NULL;
     }
 
     estudiante->apellido = mi_strdup(apellido);
     if (NULL == estudiante->apellido) {
-        free(estudiante->nombre);
-        free(estudiante);
+        HOOK_FREE(estudiante->nombre);
+        estudiante_dealloc(estudiante);
         return NULL;
     }
 
@@ -60,11 +99,11 @@ estudiante_t * estudiante_crear(const char  *nombre, const char *apellido)
 void estudiante_free(estudiante_t **estudiante)
 {
     if (NULL != estudiante) {
-        free((*estudiante)->nombre);
+        HOOK_FREE((*estudiante)->nombre);
         (*estudiante)->nombre = NULL;
-        free((*estudiante)->apellido);
+        HOOK_FREE((*estudiante)->apellido);
         (*estudiante)->apellido = NULL;
-        free(*estudiante);
+        estudiante_dealloc(*estudiante);
         *estudiante = NULL;
     }
 }
@@ -0,0 +1,289 @@
+#include "pool.h"
+#include "../memdin/alloc_hook.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+typedef struct node {
+    struct node *next;
+} node_t;
+
+
+/* the slab header keeps the objects that follow it aligned like malloc's result */
+typedef union slab {
+    union slab *next;
+    max_align_t align;
+} slab_t;
+
+
+typedef struct {
+    node_t *head;
+    size_t count;
+    unsigned long epoch;
+} cache_t;
+
+
+struct pool {
+    size_t id;
+    size_t object_size;
+    size_t objects_per_slab;
+    /* written under lock by pool_release_all, read without it by every pool_alloc and pool_free */
+    _Atomic unsigned long epoch;
+    pthread_mutex_t lock;
+    node_t *free_list;
+    slab_t *slabs;
+    slab_t *current;
+    char *next;
+    char *end;
+};
+
+
+static _Thread_local cache_t caches[POOL_MAX_POOLS];
+static pool_t *pools[POOL_MAX_POOLS];
+static unsigned long last_epoch;
+static pthread_mutex_t pools_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static unsigned long new_epoch(void)
+{
+    unsigned long epoch;
+
+    pthread_mutex_lock(&pools_lock);
+    epoch = ++last_epoch;
+    pthread_mutex_unlock(&pools_lock);
+
+    return epoch;
+}
+
+
+pool_t *pool_create(size_t object_size, size_t objects_per_slab)
+{
+    pool_t *pool;
+    size_t size;
+
+    if ((0 == object_size) || (0 == objects_per_slab)) {
+        return NULL;
+    }
+
+    /* a free object stores the link to the next one, so it must fit a pointer */
+    size = (object_size < sizeof(node_t)) ? sizeof(node_t) : object_size;
+    if (size > SIZE_MAX - sizeof(void *)) {
+        return NULL;
+    }
+    size = (size + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+    if (objects_per_slab > (SIZE_MAX - sizeof(slab_t)) / size) {
+        return NULL;
+    }
+
+    pool = (pool_t *) HOOK_CALLOC(1, sizeof(pool_t));
+    if (NULL == pool) {
+        return NULL;
+    }
+
+    pool->object_size = size;
+    pool->objects_per_slab = objects_per_slab;
+    atomic_init(&pool->epoch, new_epoch());
+    if (0 != pthread_mutex_init(&pool->lock, NULL)) {
+        HOOK_FREE(pool);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pools_lock);
+    for (pool->id = 0; (pool->id < POOL_MAX_POOLS) && (NULL != pools[pool->id]); ++pool->id) ;
+    if (POOL_MAX_POOLS != pool->id) {
+        pools[pool->id] = pool;
+    }
+    pthread_mutex_unlock(&pools_lock);
+
+    if (POOL_MAX_POOLS == pool->id) {
+        pthread_mutex_destroy(&pool->lock);
+        HOOK_FREE(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+
+/* must be called with pool->lock held */
+static char *carve(pool_t *pool)
+{
+    slab_t *slab;
+    char *object;
+
+    if (pool->next == pool->end) {
+        if ((NULL != pool->current) && (NULL != pool->current->next)) {
+            /* slabs kept by pool_release_all are reused before asking for new ones */
+            slab = pool->current->next;
+        } else {
+            slab = (slab_t *) HOOK_MALLOC(sizeof(slab_t) + pool->objects_per_slab * pool->object_size);
+            if (NULL == slab) {
+                return NULL;
+            }
+            slab->next = NULL;
+            if (NULL == pool->current) {
+                pool->slabs = slab;
+            } else {
+                pool->current->next = slab;
+            }
+        }
+        pool->current = slab;
+        pool->next = (char *) (slab + 1);
+        pool->end = pool->next + pool->objects_per_slab * pool->object_size;
+    }
+
+    object = pool->next;
+    pool->next += pool->object_size;
+
+    return object;
+}
+
+
+static void refill(pool_t *pool, cache_t *cache)
+{
+    node_t *node;
+
+    pthread_mutex_lock(&pool->lock);
+    while ((cache->count < POOL_BATCH) && (NULL != pool->free_list)) {
+        node = pool->free_list;
+        pool->free_list = node->next;
+        node->next = cache->head;
+        cache->head = node;
+        cache->count++;
+    }
+    while (cache->count < POOL_BATCH) {
+        node = (node_t *) carve(pool);
+        if (NULL == node) {
+            break;
+        }
+        node->next = cache->head;
+        cache->head = node;
+        cache->count++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+
+static void flush(pool_t *pool, cache_t *cache)
+{
+    node_t *first = cache->head;
+    node_t *last = first;
+
+    for (size_t i = 1; i < POOL_BATCH; ++i) {
+        last = last->next;
+    }
+    cache->head = last->next;
+    cache->count -= POOL_BATCH;
+
+    pthread_mutex_lock(&pool->lock);
+    last->next = pool->free_list;
+    pool->free_list = first;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+
+static cache_t *thread_cache(pool_t *pool)
+{
+    cache_t *cache = &caches[pool->id];
+    unsigned long epoch = atomic_load_explicit(&pool->epoch, memory_order_acquire);
+
+    /* a different epoch means the pool was released (or the slot reused) since this thread last used it */
+    if (cache->epoch != epoch) {
+        cache->head = NULL;
+        cache->count = 0;
+        cache->epoch = epoch;
+    }
+
+    return cache;
+}
+
+
+void *pool_alloc(pool_t *pool)
+{
+    cache_t *cache;
+    node_t *node;
+
+    if (NULL == pool) {
+        return NULL;
+    }
+
+    cache = thread_cache(pool);
+    if (NULL == cache->head) {
+        refill(pool, cache);
+        if (NULL == cache->head) {
+            return NULL;
+        }
+    }
+
+    node = cache->head;
+    cache->head = node->next;
+    cache->count--;
+
+    return node;
+}
+
+
+void pool_free(pool_t *pool, void *object)
+{
+    cache_t *cache;
+    node_t *node = (node_t *) object;
+
+    if ((NULL == pool) || (NULL == object)) {
+        return;
+    }
+
+    cache = thread_cache(pool);
+    node->next = cache->head;
+    cache->head = node;
+    cache->count++;
+
+    if (cache->count >= 2 * POOL_BATCH) {
+        flush(pool, cache);
+    }
+}
+
+
+void pool_release_all(pool_t *pool)
+{
+    if (NULL == pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->free_list = NULL;
+    pool->current = pool->slabs;
+    if (NULL != pool->slabs) {
+        pool->next = (char *) (pool->slabs + 1);
+        pool->end = pool->next + pool->objects_per_slab * pool->object_size;
+    }
+    atomic_store_explicit(&pool->epoch, new_epoch(), memory_order_release);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+
+void pool_destroy(pool_t **pool)
+{
+    slab_t *slab;
+
+    if ((NULL == pool) || (NULL == *pool)) {
+        return;
+    }
+
+    pthread_mutex_lock(&pools_lock);
+    pools[(*pool)->id] = NULL;
+    pthread_mutex_unlock(&pools_lock);
+
+    while (NULL != (*pool)->slabs) {
+        slab = (*pool)->slabs;
+        (*pool)->slabs = slab->next;
+        HOOK_FREE(slab);
+    }
+
+    pthread_mutex_destroy(&(*pool)->lock);
+    HOOK_FREE(*pool);
+    *pool = NULL;
+}
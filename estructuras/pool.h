@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdlib.h>
+
+/*
+ * Pool de objetos de tamaño fijo.
+ *
+ * La memoria se pide en bloques grandes (slabs) y se reparte en objetos de `object_size` bytes. Los objetos libres se
+ * encadenan usando su propia memoria, por lo que no hay encabezado por objeto y tanto pool_alloc como pool_free son
+ * O(1). Cada hilo mantiene un caché propio de objetos libres y sólo toma el mutex del pool para intercambiar lotes
+ * de POOL_BATCH objetos.
+ *
+ * pool_release_all libera en bloque todos los objetos (los slabs se conservan para reutilizarlos) y pool_destroy
+ * devuelve toda la memoria. Los objetos que quedan en el caché de un hilo que termina se recuperan recién en alguna
+ * de esas dos operaciones. Ninguna de las dos puede llamarse mientras otro hilo usa el pool: cada hilo descarta su
+ * caché la próxima vez que lo usa, pero un pool_alloc en curso podría devolver un objeto ya liberado.
+ */
+
+#define POOL_MAX_POOLS 16
+#define POOL_BATCH 64
+
+
+typedef struct pool pool_t;
+
+
+pool_t *pool_create(size_t object_size, size_t objects_per_slab);
+void *pool_alloc(pool_t *pool);
+void pool_free(pool_t *pool, void *object);
+void pool_release_all(pool_t *pool);
+void pool_destroy(pool_t **pool);
@@ -1,60 +1,51 @@
+#include "vector.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 
+#define INITIAL_LENGTH 3
+#define TOTAL_LENGTH 4
+
 int main (void)
 {
     char input[256];
     char *pend = NULL;
-    double *data = NULL;
-    double *aux = NULL;
+    double value;
+    vector_double_t data;
 
-    data = (double *) malloc(3 * sizeof(double));
-    if (NULL == data) {
+    if (!vector_double_init(&data, INITIAL_LENGTH, VECTOR_DEFAULT_GROWTH)) {
         fprintf(stderr, "Not enough memory\n");
         return EXIT_FAILURE;
     }
-    
-    for (size_t i = 0; i < 3; ++i) {
+
+    /* el cuarto número no entra en los 3 iniciales: push se encarga del realloc */
+    for (size_t i = 0; i < TOTAL_LENGTH; ++i) {
         printf("Ingrese un número: ");
         if (NULL == fgets(input, 256, stdin)) {
             fprintf(stderr, "Failed to read from stdin\n");
-            free(data);
+            vector_double_free(&data);
             return EXIT_FAILURE;
         }
-        data[i] = strtod(input, &pend);
+        value = strtod(input, &pend);
         if (('\0' != *pend) && ('\n' != *pend)) {
             fprintf(stderr, "Character %li ('%c') could not be converted as part of a double\n", pend - input, *pend);
-            free(data);
+            vector_double_free(&data);
+            return EXIT_FAILURE;
+        }
+        if (!vector_double_push(&data, value)) {
+            vector_double_free(&data);
+            fprintf(stderr, "Falló realloc\n");
             return EXIT_FAILURE;
         }
-    }
-    
-    aux = realloc(data, 4 * sizeof(double));
-    if (NULL == aux) {
-        free(data);
-        fprintf(stderr, "Falló realloc\n");
-        return EXIT_FAILURE;
-    }
-    data = aux;
-
-    printf("Ingrese un número: ");
-    if (NULL == fgets(input, 256, stdin)) {
-        fprintf(stderr, "Failed to read from stdin\n");
-        free(data);
-        return EXIT_FAILURE;
-    }
-    data[3] = strtod(input, &pend);
-    if (('\0' != *pend) && ('\n' != *pend)) {
-        fprintf(stderr, "Character %li ('%c') could not be converted as part of a double\n", pend - input, *pend);
-        free(data);
-        return EXIT_FAILURE;
     }
 
-    printf("{%g", data[0]);
-    for (size_t i = 1; i < 4; ++i) {
-        printf(", %g", data[i]);
+    printf("{%g", data.data[0]);
+    for (size_t i = 1; i < data.length; ++i) {
+        printf(", %g", data.data[i]);
     }
     puts("}");
 
+    vector_double_free(&data);
+
     return EXIT_SUCCESS;
 }
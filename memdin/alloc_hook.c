@@ -0,0 +1,385 @@
+#define _POSIX_C_SOURCE 200809L
+
+#ifndef ALLOC_HOOK
+#define ALLOC_HOOK
+#endif
+
+#include "alloc_hook.h"
+
+#include <signal.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_SITES 256
+/* one slot past the hash table, for the sites that find it full */
+#define OVERFLOW_SITE MAX_SITES
+#define OVERFLOW_NAME "(otros)"
+#define SIZE_CLASSES 48
+#define REPORT_BUFFER 512
+
+
+typedef enum {
+    OP_MALLOC,
+    OP_CALLOC,
+    OP_REALLOC,
+    OP_FREE,
+    OP_COUNT,
+} op_t;
+
+
+typedef struct {
+    _Atomic(const char *) name;
+    atomic_size_t calls[OP_COUNT];
+    atomic_size_t bytes;
+    atomic_size_t live;
+    atomic_size_t peak;
+    atomic_size_t nanoseconds;
+    atomic_size_t histogram[SIZE_CLASSES];
+} site_t;
+
+
+/* the header keeps the size and the owner site so `free` needs no lookup; it is as aligned as malloc's result */
+typedef union {
+    struct {
+        size_t size;
+        size_t site;
+    } info;
+    max_align_t align;
+} header_t;
+
+
+static site_t sites[MAX_SITES + 1];
+static atomic_size_t total_live;
+static atomic_size_t total_peak;
+static atomic_flag installed = ATOMIC_FLAG_INIT;
+
+static const char *op_names[] = {
+    [OP_MALLOC] = "malloc",
+    [OP_CALLOC] = "calloc",
+    [OP_REALLOC] = "realloc",
+    [OP_FREE] = "free",
+};
+
+
+static void report_at_exit(void)
+{
+    alloc_hook_report(STDERR_FILENO);
+}
+
+
+static void report_on_signal(int signum)
+{
+    (void) signum;
+    alloc_hook_report(STDERR_FILENO);
+}
+
+
+static void install(void)
+{
+    struct sigaction sa;
+
+    if (atomic_flag_test_and_set(&installed)) {
+        return;
+    }
+
+    atexit(report_at_exit);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = report_on_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, NULL);
+}
+
+
+static size_t site_index(const char *name)
+{
+    size_t i = ((uintptr_t) name >> 3) % MAX_SITES;
+    const char *expected;
+
+    for (size_t probe = 0; probe < MAX_SITES; ++probe, i = (i + 1) % MAX_SITES) {
+        expected = atomic_load_explicit(&sites[i].name, memory_order_acquire);
+        if (expected == name) {
+            return i;
+        }
+        if (NULL == expected) {
+            if (atomic_compare_exchange_strong(&sites[i].name, &expected, name) || (expected == name)) {
+                return i;
+            }
+        }
+    }
+
+    /* table full: everything else is accounted together, apart from the sites that did get a slot */
+    atomic_store_explicit(&sites[OVERFLOW_SITE].name, OVERFLOW_NAME, memory_order_release);
+
+    return OVERFLOW_SITE;
+}
+
+
+static size_t size_class(size_t size)
+{
+    size_t c = 0;
+
+    while ((size > 0) && (c < SIZE_CLASSES - 1)) {
+        size >>= 1;
+        c++;
+    }
+
+    return c;
+}
+
+
+static void update_peak(atomic_size_t *peak, size_t value)
+{
+    size_t current = atomic_load_explicit(peak, memory_order_relaxed);
+
+    while ((value > current) && !atomic_compare_exchange_weak(peak, &current, value)) ;
+}
+
+
+static void account_alloc(size_t site, size_t size)
+{
+    size_t live;
+
+    atomic_fetch_add_explicit(&sites[site].bytes, size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&sites[site].histogram[size_class(size)], 1, memory_order_relaxed);
+
+    live = atomic_fetch_add_explicit(&sites[site].live, size, memory_order_relaxed) + size;
+    update_peak(&sites[site].peak, live);
+
+    live = atomic_fetch_add_explicit(&total_live, size, memory_order_relaxed) + size;
+    update_peak(&total_peak, live);
+}
+
+
+static void account_release(size_t site, size_t size)
+{
+    atomic_fetch_sub_explicit(&sites[site].live, size, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&total_live, size, memory_order_relaxed);
+}
+
+
+static size_t start_clock(size_t site, op_t op)
+{
+    struct timespec ts;
+
+    install();
+    atomic_fetch_add_explicit(&sites[site].calls[op], 1, memory_order_relaxed);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (size_t) ts.tv_sec * 1000000000u + (size_t) ts.tv_nsec;
+}
+
+
+static void stop_clock(size_t site, size_t start)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    atomic_fetch_add_explicit(&sites[site].nanoseconds,
+                              (size_t) ts.tv_sec * 1000000000u + (size_t) ts.tv_nsec - start,
+                              memory_order_relaxed);
+}
+
+
+void *alloc_hook_malloc(size_t size, const char *site)
+{
+    size_t s = site_index(site);
+    size_t t0 = start_clock(s, OP_MALLOC);
+    header_t *h;
+
+    h = (size <= SIZE_MAX - sizeof(header_t)) ? malloc(sizeof(header_t) + size) : NULL;
+    stop_clock(s, t0);
+    if (NULL == h) {
+        return NULL;
+    }
+
+    h->info.size = size;
+    h->info.site = s;
+    account_alloc(s, size);
+
+    return h + 1;
+}
+
+
+void *alloc_hook_calloc(size_t n, size_t size, const char *site)
+{
+    size_t s = site_index(site);
+    size_t t0 = start_clock(s, OP_CALLOC);
+    size_t total;
+    header_t *h = NULL;
+
+    if ((0 == size) || (n <= (SIZE_MAX - sizeof(header_t)) / size)) {
+        total = n * size;
+        /* calloc of whole headers keeps the zeroing (and its fast path for fresh pages) inside libc */
+        h = calloc(1 + (total + sizeof(header_t) - 1) / sizeof(header_t), sizeof(header_t));
+    }
+    stop_clock(s, t0);
+    if (NULL == h) {
+        return NULL;
+    }
+
+    h->info.size = total;
+    h->info.site = s;
+    account_alloc(s, total);
+
+    return h + 1;
+}
+
+
+void *alloc_hook_realloc(void *ptr, size_t size, const char *site)
+{
+    size_t s = site_index(site);
+    size_t t0 = start_clock(s, OP_REALLOC);
+    header_t *old = NULL;
+    header_t *h;
+    size_t old_size = 0;
+    size_t old_site = 0;
+
+    if (NULL != ptr) {
+        old = (header_t *) ptr - 1;
+        old_size = old->info.size;
+        old_site = old->info.site;
+    }
+
+    h = (size <= SIZE_MAX - sizeof(header_t)) ? realloc(old, sizeof(header_t) + size) : NULL;
+    stop_clock(s, t0);
+    if (NULL == h) {
+        return NULL;
+    }
+
+    if (NULL != old) {
+        account_release(old_site, old_size);
+    }
+
+    /* the block now belongs to the site that grew it */
+    h->info.size = size;
+    h->info.site = s;
+    account_alloc(s, size);
+
+    return h + 1;
+}
+
+
+void alloc_hook_free(void *ptr, const char *site)
+{
+    size_t s = site_index(site);
+    size_t t0;
+    header_t *h;
+
+    if (NULL == ptr) {
+        return;
+    }
+
+    h = (header_t *) ptr - 1;
+    account_release(h->info.site, h->info.size);
+
+    t0 = start_clock(s, OP_FREE);
+    free(h);
+    stop_clock(s, t0);
+}
+
+
+/* the report may run inside a signal handler, so it formats by hand and only uses write(2) */
+typedef struct {
+    int fd;
+    size_t used;
+    char data[REPORT_BUFFER];
+} out_t;
+
+
+static void out_flush(out_t *out)
+{
+    size_t done = 0;
+    ssize_t w;
+
+    while (done < out->used) {
+        w = write(out->fd, out->data + done, out->used - done);
+        if (w <= 0) {
+            break;
+        }
+        done += (size_t) w;
+    }
+    out->used = 0;
+}
+
+
+static void out_str(out_t *out, const char *s)
+{
+    while ('\0' != *s) {
+        if (out->used == REPORT_BUFFER) {
+            out_flush(out);
+        }
+        out->data[out->used++] = *s++;
+    }
+}
+
+
+static void out_num(out_t *out, size_t n)
+{
+    char digits[24];
+    size_t i = sizeof(digits) - 1;
+
+    digits[i] = '\0';
+    do {
+        digits[--i] = (char) ('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+
+    out_str(out, digits + i);
+}
+
+
+void alloc_hook_report(int fd)
+{
+    out_t out = {.fd = fd, .used = 0};
+    const char *name;
+    size_t count;
+
+    out_str(&out, "== alloc_hook: live ");
+    out_num(&out, atomic_load(&total_live));
+    out_str(&out, " B, peak ");
+    out_num(&out, atomic_load(&total_peak));
+    out_str(&out, " B\n");
+
+    for (size_t i = 0; i <= OVERFLOW_SITE; ++i) {
+        name = atomic_load(&sites[i].name);
+        if (NULL == name) {
+            continue;
+        }
+
+        out_str(&out, name);
+        out_str(&out, "\n   ");
+        for (op_t op = 0; op < OP_COUNT; ++op) {
+            out_str(&out, " ");
+            out_str(&out, op_names[op]);
+            out_str(&out, "=");
+            out_num(&out, atomic_load(&sites[i].calls[op]));
+        }
+        out_str(&out, "\n    bytes=");
+        out_num(&out, atomic_load(&sites[i].bytes));
+        out_str(&out, " live=");
+        out_num(&out, atomic_load(&sites[i].live));
+        out_str(&out, " peak=");
+        out_num(&out, atomic_load(&sites[i].peak));
+        out_str(&out, " ns=");
+        out_num(&out, atomic_load(&sites[i].nanoseconds));
+        out_str(&out, "\n    size classes:");
+        for (size_t c = 0; c < SIZE_CLASSES; ++c) {
+            count = atomic_load(&sites[i].histogram[c]);
+            if (0 != count) {
+                out_str(&out, " <=");
+                out_num(&out, (0 == c) ? 0 : ((size_t) 1 << c) - 1);
+                out_str(&out, ":");
+                out_num(&out, count);
+            }
+        }
+        out_str(&out, "\n");
+    }
+
+    out_flush(&out);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdlib.h>
+
+/*
+ * Capa de instrumentación de memoria dinámica.
+ *
+ * Los módulos piden y liberan memoria con HOOK_MALLOC, HOOK_CALLOC, HOOK_REALLOC y HOOK_FREE.
+ * Si se compila sin ALLOC_HOOK las macros son exactamente malloc, calloc, realloc y free.
+ * Compilando con -DALLOC_HOOK (y agregando alloc_hook.c) cada llamada se registra por sitio (archivo:línea): cantidad
+ * de llamadas, bytes pedidos, bytes vivos y su pico, tiempo consumido e histograma por clase de tamaño (potencias de
+ * 2). Si hay más sitios de los que entran en la tabla, los que no consiguen lugar se suman juntos como «(otros)». El
+ * reporte se imprime en stderr al terminar el programa o al recibir SIGUSR1.
+ */
+
+#ifdef ALLOC_HOOK
+
+#define ALLOC_HOOK_STR_(x) #x
+#define ALLOC_HOOK_STR(x) ALLOC_HOOK_STR_(x)
+#define ALLOC_HOOK_SITE __FILE__ ":" ALLOC_HOOK_STR(__LINE__)
+
+#define HOOK_MALLOC(size) alloc_hook_malloc((size), ALLOC_HOOK_SITE)
+#define HOOK_CALLOC(n, size) alloc_hook_calloc((n), (size), ALLOC_HOOK_SITE)
+#define HOOK_REALLOC(ptr, size) alloc_hook_realloc((ptr), (size), ALLOC_HOOK_SITE)
+#define HOOK_FREE(ptr) alloc_hook_free((ptr), ALLOC_HOOK_SITE)
+
+void *alloc_hook_malloc(size_t size, const char *site);
+void *alloc_hook_calloc(size_t n, size_t size, const char *site);
+void *alloc_hook_realloc(void *ptr, size_t size, const char *site);
+void alloc_hook_free(void *ptr, const char *site);
+void alloc_hook_report(int fd);
+
+#else
+
+#define HOOK_MALLOC(size) malloc(size)
+#define HOOK_CALLOC(n, size) calloc((n), (size))
+#define HOOK_REALLOC(ptr, size) realloc((ptr), (size))
+#define HOOK_FREE(ptr) free(ptr)
+
+#define alloc_hook_report(fd) ((void) 0)
+
+#endif
@@ -0,0 +1,279 @@
+#define _GNU_SOURCE
+
+#include "big_array.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+
+static size_t granule(const big_array_t *a)
+{
+    long page;
+
+    if (a->huge_pages) {
+        return BIG_ARRAY_HUGE_PAGE_SIZE;
+    }
+
+    page = sysconf(_SC_PAGESIZE);
+
+    return (page > 0) ? (size_t) page : 4096;
+}
+
+
+static bool round_up(size_t bytes, size_t step, size_t *rounded)
+{
+    if (bytes > SIZE_MAX - (step - 1)) {
+        return false;
+    }
+
+    *rounded = (bytes + step - 1) / step * step;
+
+    return true;
+}
+
+
+static void advise_huge(big_array_t *a, void *addr, size_t bytes)
+{
+#ifdef MADV_HUGEPAGE
+    if (a->huge_pages && (BIG_PAGES_EXPLICIT != a->pages)) {
+        a->pages = (0 == madvise(addr, bytes, MADV_HUGEPAGE)) ? BIG_PAGES_TRANSPARENT : BIG_PAGES_NORMAL;
+    }
+#else
+    (void) a;
+    (void) addr;
+    (void) bytes;
+#endif
+}
+
+
+/* maps `bytes` read/write, preferring explicit 2 MB pages, then THP, then normal pages */
+static void *map_fresh(big_array_t *a, size_t bytes)
+{
+    void *p = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    /* once a mapping has fallen back to normal pages, later growths do not retry hugetlb */
+    if (a->huge_pages && ((NULL == a->data) || (BIG_PAGES_EXPLICIT == a->pages))) {
+        p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (MAP_FAILED != p) {
+            a->pages = BIG_PAGES_EXPLICIT;
+            return p;
+        }
+    }
+#endif
+
+    p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == p) {
+        return NULL;
+    }
+
+    if (BIG_PAGES_EXPLICIT == a->pages) {
+        a->pages = BIG_PAGES_NORMAL;
+    }
+    advise_huge(a, p, bytes);
+
+    return p;
+}
+
+
+static bool init_reserve(big_array_t *a, size_t max_length)
+{
+    size_t bytes;
+    size_t align = BIG_ARRAY_HUGE_PAGE_SIZE;
+    uintptr_t base;
+    uintptr_t aligned;
+    void *p;
+
+    if ((0 == max_length) || (max_length > SIZE_MAX / sizeof(double))
+        || !round_up(max_length * sizeof(double), align, &bytes) || (bytes > SIZE_MAX - align)) {
+        return false;
+    }
+
+    /* reserve one extra huge page so the start can be aligned to 2 MB, then give back the slack */
+    p = mmap(NULL, bytes + align, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (MAP_FAILED == p) {
+        return false;
+    }
+
+    base = (uintptr_t) p;
+    aligned = (base + align - 1) / align * align;
+    if (aligned > base) {
+        munmap(p, aligned - base);
+    }
+    if (aligned + bytes < base + bytes + align) {
+        munmap((void *) (aligned + bytes), base + bytes + align - (aligned + bytes));
+    }
+
+    a->data = (double *) aligned;
+    a->reserved = bytes;
+    advise_huge(a, a->data, bytes);
+
+    return true;
+}
+
+
+bool big_array_init(big_array_t *a, big_array_mode_t mode, size_t max_length, bool huge_pages)
+{
+    if (NULL == a) {
+        return false;
+    }
+
+    a->data = NULL;
+    a->length = 0;
+    a->capacity = 0;
+    a->mapped = 0;
+    a->reserved = 0;
+    a->mode = mode;
+    a->huge_pages = huge_pages;
+    a->pages = BIG_PAGES_NORMAL;
+    a->copies = 0;
+
+    switch (mode) {
+        case BIG_ARRAY_RESERVE:
+            return init_reserve(a, max_length);
+        case BIG_ARRAY_REMAP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+static bool grow_reserve(big_array_t *a, size_t bytes)
+{
+    if (bytes > a->reserved) {
+        bytes = a->reserved;
+    }
+
+    if (0 != mprotect((char *) a->data + a->mapped, bytes - a->mapped, PROT_READ | PROT_WRITE)) {
+        return false;
+    }
+
+    a->mapped = bytes;
+
+    return true;
+}
+
+
+static bool grow_remap(big_array_t *a, size_t bytes)
+{
+    void *p;
+
+    if (NULL == a->data) {
+        p = map_fresh(a, bytes);
+        if (NULL == p) {
+            return false;
+        }
+        a->data = p;
+        a->mapped = bytes;
+        return true;
+    }
+
+#ifdef MREMAP_MAYMOVE
+    p = mremap(a->data, a->mapped, bytes, MREMAP_MAYMOVE);
+    if (MAP_FAILED != p) {
+        advise_huge(a, p, bytes);
+        a->data = p;
+        a->mapped = bytes;
+        return true;
+    }
+#endif
+
+    /* no mremap (or it refused, e.g. hugetlb on old kernels): map, copy and unmap */
+    p = map_fresh(a, bytes);
+    if (NULL == p) {
+        return false;
+    }
+    memcpy(p, a->data, a->length * sizeof(double));
+    a->copies += a->length;
+    munmap(a->data, a->mapped);
+    a->data = p;
+    a->mapped = bytes;
+
+    return true;
+}
+
+
+bool big_array_reserve(big_array_t *a, size_t capacity)
+{
+    size_t bytes;
+    size_t wanted;
+    bool ok;
+
+    if (NULL == a) {
+        return false;
+    }
+
+    if (capacity <= a->capacity) {
+        return true;
+    }
+
+    if (capacity > SIZE_MAX / sizeof(double)) {
+        return false;
+    }
+
+    /* grow geometrically, but never less than what was asked for */
+    wanted = capacity * sizeof(double);
+    bytes = (a->mapped <= SIZE_MAX / 2) ? 2 * a->mapped : a->mapped;
+    if (bytes < wanted) {
+        bytes = wanted;
+    }
+    if (!round_up(bytes, granule(a), &bytes)) {
+        return false;
+    }
+
+    if (BIG_ARRAY_RESERVE == a->mode) {
+        if (wanted > a->reserved) {
+            return false;
+        }
+        ok = grow_reserve(a, bytes);
+    } else {
+        ok = grow_remap(a, bytes);
+    }
+
+    if (ok) {
+        a->capacity = a->mapped / sizeof(double);
+    }
+
+    return ok;
+}
+
+
+bool big_array_append(big_array_t *a, const double *src, size_t n)
+{
+    if ((NULL == a) || ((NULL == src) && (0 != n))) {
+        return false;
+    }
+
+    if ((n > SIZE_MAX - a->length) || !big_array_reserve(a, a->length + n)) {
+        return false;
+    }
+
+    if (0 != n) {
+        memcpy(a->data + a->length, src, n * sizeof(double));
+        a->length += n;
+    }
+
+    return true;
+}
+
+
+void big_array_free(big_array_t *a)
+{
+    if ((NULL == a) || (NULL == a->data)) {
+        return;
+    }
+
+    munmap(a->data, (BIG_ARRAY_RESERVE == a->mode) ? a->reserved : a->mapped);
+    a->data = NULL;
+    a->length = 0;
+    a->capacity = 0;
+    a->mapped = 0;
+    a->reserved = 0;
+}
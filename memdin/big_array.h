@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Arreglo de doubles para tamaños muy grandes (decenas de GB).
+ *
+ * Pasado cierto tamaño, malloc atiende los pedidos con mmap y cada realloc termina copiando todo el bloque. Este
+ * módulo pide la memoria directamente al sistema operativo y crece sin copiar:
+ *
+ * -   BIG_ARRAY_RESERVE reserva de entrada el espacio de direcciones para `max_length` elementos (sin consumir
+ *     memoria física) y a medida que crece sólo habilita las páginas necesarias. `data` nunca cambia.
+ * -   BIG_ARRAY_REMAP mapea sólo lo necesario y crece con mremap, que mueve las tablas de páginas en lugar de los
+ *     datos. `data` puede cambiar al crecer.
+ *
+ * Si se pide `huge_pages`, se intenta primero con páginas de 2 MB explícitas (MAP_HUGETLB, sólo en modo remap) y luego
+ * con transparent huge pages (MADV_HUGEPAGE). Si ninguna está disponible se usan páginas normales; `pages` indica lo
+ * que efectivamente se obtuvo.
+ */
+
+#define BIG_ARRAY_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+
+typedef enum {
+    BIG_ARRAY_RESERVE,
+    BIG_ARRAY_REMAP,
+} big_array_mode_t;
+
+
+typedef enum {
+    BIG_PAGES_NORMAL,
+    BIG_PAGES_TRANSPARENT,
+    BIG_PAGES_EXPLICIT,
+} big_pages_t;
+
+
+typedef struct {
+    double *data;
+    size_t length;
+    size_t capacity;
+    size_t mapped;
+    size_t reserved;
+    big_array_mode_t mode;
+    bool huge_pages;
+    big_pages_t pages;
+    size_t copies;
+} big_array_t;
+
+
+bool big_array_init(big_array_t *a, big_array_mode_t mode, size_t max_length, bool huge_pages);
+bool big_array_reserve(big_array_t *a, size_t capacity);
+bool big_array_append(big_array_t *a, const double *src, size_t n);
+void big_array_free(big_array_t *a);
+
+
+static inline bool big_array_push(big_array_t *a, double value)
+{
+    if ((a->length == a->capacity) && !big_array_reserve(a, a->length + 1)) {
+        return false;
+    }
+    a->data[a->length++] = value;
+    return true;
+}
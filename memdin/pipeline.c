@@ -0,0 +1,653 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pipeline.h"
+#include "trace.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CACHE_LINE 64
+/* failed attempts before giving the processor away: a stage that waits should not slow down the one it waits for */
+#define SPINS 64
+/* then attempts after sched_yield, before sleeping until some queue changes */
+#define YIELDS 16
+
+
+typedef struct {
+    size_t seq;
+    size_t length;
+    size_t count;
+    size_t invalid;
+    bool overlong;
+    char text[PIPELINE_BLOCK + 1];
+    double values[PIPELINE_BLOCK / 2 + 1];
+} block_t;
+
+
+/* one producer, one consumer: each index is written by a single thread, on its own cache line */
+typedef struct {
+    atomic_size_t head;
+    char pad[CACHE_LINE - sizeof(atomic_size_t)];
+    atomic_size_t tail;
+    size_t mask;
+    block_t **slots;
+} spsc_t;
+
+
+typedef struct {
+    atomic_size_t seq;
+    block_t *item;
+} cell_t;
+
+
+/* many producers, one consumer (Vyukov's bounded queue): a cell's seq says whose turn it is */
+typedef struct {
+    atomic_size_t tail;
+    char pad[CACHE_LINE - sizeof(atomic_size_t)];
+    size_t head;
+    size_t mask;
+    cell_t *cells;
+} mpsc_t;
+
+
+typedef struct {
+    unsigned spins;
+    double since;
+    bool sleeping;
+    unsigned long event;
+} waiter_t;
+
+
+typedef struct pipeline pipeline_t;
+
+
+typedef struct {
+    pipeline_t *p;
+    pthread_t thread;
+    spsc_t in;
+    pipeline_stage_t stage;
+} parser_t;
+
+
+struct pipeline {
+    int fd;
+    size_t n_parsers;
+    size_t n_blocks;
+    block_t *blocks;
+    block_t **window;
+    parser_t *parsers;
+    mpsc_t parsed;
+    spsc_t free;
+    /* a stage out of spins and yields counts itself in sleepers and waits for event to change */
+    atomic_uint sleepers;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    unsigned long event;
+    bool read_error;
+    size_t sent;
+    pipeline_result_t result;
+    pipeline_stage_t reader;
+    pipeline_stage_t compute;
+};
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static size_t round_pow2(size_t n)
+{
+    size_t p = 1;
+
+    while (p < n) {
+        p <<= 1;
+    }
+
+    return p;
+}
+
+
+static bool spsc_init(spsc_t *q, size_t capacity)
+{
+    capacity = round_pow2(capacity);
+    q->slots = (block_t **) malloc(capacity * sizeof(block_t *));
+    if (NULL == q->slots) {
+        return false;
+    }
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->mask = capacity - 1;
+
+    return true;
+}
+
+
+static bool spsc_push(spsc_t *q, block_t *b)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if (tail - atomic_load_explicit(&q->head, memory_order_acquire) > q->mask) {
+        return false;
+    }
+    q->slots[tail & q->mask] = b;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+
+static bool spsc_pop(spsc_t *q, block_t **b)
+{
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    if (head == atomic_load_explicit(&q->tail, memory_order_acquire)) {
+        return false;
+    }
+    *b = q->slots[head & q->mask];
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+
+static bool mpsc_init(mpsc_t *q, size_t capacity)
+{
+    capacity = round_pow2(capacity);
+    q->cells = (cell_t *) malloc(capacity * sizeof(cell_t));
+    if (NULL == q->cells) {
+        return false;
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        atomic_init(&q->cells[i].seq, i);
+    }
+    atomic_init(&q->tail, 0);
+    q->head = 0;
+    q->mask = capacity - 1;
+
+    return true;
+}
+
+
+static bool mpsc_push(mpsc_t *q, block_t *b)
+{
+    size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    cell_t *cell;
+    size_t seq;
+
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        if (seq == pos) {
+            /* the cell is free: claim position pos (on failure pos is reloaded) */
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if ((ptrdiff_t) (seq - pos) < 0) {
+            /* still holds the item of the previous lap: full */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+    cell->item = b;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+
+    return true;
+}
+
+
+static bool mpsc_pop(mpsc_t *q, block_t **b)
+{
+    cell_t *cell = &q->cells[q->head & q->mask];
+
+    if (atomic_load_explicit(&cell->seq, memory_order_acquire) != q->head + 1) {
+        return false;
+    }
+    *b = cell->item;
+    /* hands the cell to the producers of the next lap */
+    atomic_store_explicit(&cell->seq, q->head + q->mask + 1, memory_order_release);
+    q->head++;
+
+    return true;
+}
+
+
+static void wait_step(pipeline_t *p, waiter_t *w)
+{
+    if (0 == w->spins++) {
+        w->since = now();
+    }
+    if (w->spins <= SPINS) {
+        return;
+    }
+    if (w->spins <= SPINS + YIELDS) {
+        sched_yield();
+        return;
+    }
+
+    /*
+     * Counted before reading the event and trying once more: a queue operation after that attempt sees the sleeper
+     * and changes the event, so the wakeup cannot be lost.
+     */
+    if (!w->sleeping) {
+        atomic_fetch_add(&p->sleepers, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        pthread_mutex_lock(&p->lock);
+        w->event = p->event;
+        pthread_mutex_unlock(&p->lock);
+        w->sleeping = true;
+        return;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    while (p->event == w->event) {
+        pthread_cond_wait(&p->changed, &p->lock);
+    }
+    w->event = p->event;
+    pthread_mutex_unlock(&p->lock);
+}
+
+
+/* after any push or pop: someone may be sleeping until there is an item or room in that queue */
+static void notify(pipeline_t *p)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (0 != atomic_load_explicit(&p->sleepers, memory_order_relaxed)) {
+        pthread_mutex_lock(&p->lock);
+        p->event++;
+        pthread_cond_broadcast(&p->changed);
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+
+/* every queue operation ends here, whether it had to wait or not */
+static void wait_done(pipeline_t *p, waiter_t *w, double *total)
+{
+    if (0 != w->spins) {
+        *total += now() - w->since;
+        w->spins = 0;
+    }
+    if (w->sleeping) {
+        atomic_fetch_sub(&p->sleepers, 1);
+        w->sleeping = false;
+    }
+    notify(p);
+}
+
+
+static bool is_blank(char c)
+{
+    return (' ' == c) || ('\t' == c) || ('\r' == c) || ('\v' == c) || ('\f' == c);
+}
+
+
+static const char *last_newline(const char *s, size_t n)
+{
+    while (n > 0) {
+        if ('\n' == s[--n]) {
+            return s + n;
+        }
+    }
+
+    return NULL;
+}
+
+
+static void parse_block(block_t *b)
+{
+    char *s = b->text;
+    char *end = b->text + b->length;
+    char *eol;
+    char *pend;
+    double value;
+    TRACE_SCOPE("parse");
+
+    b->count = 0;
+    b->invalid = b->overlong ? 1 : 0;
+    *end = '\0';
+    for (; s < end; s = eol + 1) {
+        eol = (char *) memchr(s, '\n', (size_t) (end - s));
+        if (NULL == eol) {
+            eol = end;
+        }
+
+        while ((s < eol) && is_blank(*s)) {
+            ++s;
+        }
+        if (s == eol) {
+            continue;
+        }
+
+        /* strtod cannot go past eol: a newline ends any number */
+        value = strtod(s, &pend);
+        while ((pend < eol) && is_blank(*pend)) {
+            ++pend;
+        }
+        if ((pend == s) || (pend != eol)) {
+            b->invalid++;
+            continue;
+        }
+        b->values[b->count++] = value;
+    }
+}
+
+
+/* same accumulation as meand and maximo, in input order */
+static void accumulate(pipeline_result_t *r, const block_t *b)
+{
+    double sum = r->sum;
+    double max = r->max;
+    double min = r->min;
+    TRACE_SCOPE("compute");
+
+    for (size_t i = 0; i < b->count; ++i) {
+        sum += b->values[i];
+        if (b->values[i] > max) {
+            max = b->values[i];
+        }
+        if (b->values[i] < min) {
+            min = b->values[i];
+        }
+    }
+    r->sum = sum;
+    r->max = max;
+    r->min = min;
+    r->count += b->count;
+    r->invalid += b->invalid;
+}
+
+
+static void *parser_main(void *arg)
+{
+    parser_t *self = (parser_t *) arg;
+    waiter_t w = {0};
+    double start = now();
+    block_t *b;
+
+    for (;;) {
+        while (!spsc_pop(&self->in, &b)) {
+            wait_step(self->p, &w);
+        }
+        wait_done(self->p, &w, &self->stage.waiting_in);
+
+        if (NULL != b) {
+            parse_block(b);
+        }
+
+        /* NULL (end of input) is passed on too: the compute stage counts one per parser */
+        while (!mpsc_push(&self->p->parsed, b)) {
+            wait_step(self->p, &w);
+        }
+        wait_done(self->p, &w, &self->stage.waiting_out);
+
+        if (NULL == b) {
+            break;
+        }
+    }
+    self->stage.busy = now() - start - self->stage.waiting_in - self->stage.waiting_out;
+
+    return NULL;
+}
+
+
+/* blocks arrive in any order from the parsers; a window indexed by seq puts them back in input order */
+static void *compute_main(void *arg)
+{
+    pipeline_t *p = (pipeline_t *) arg;
+    waiter_t w = {0};
+    double start = now();
+    size_t ended = 0;
+    size_t next = 0;
+    block_t *b;
+
+    while (ended < p->n_parsers) {
+        while (!mpsc_pop(&p->parsed, &b)) {
+            wait_step(p, &w);
+        }
+        wait_done(p, &w, &p->compute.waiting_in);
+
+        if (NULL == b) {
+            ended++;
+            continue;
+        }
+
+        /* at most n_blocks sequence numbers are in flight, so they never collide in the window */
+        p->window[b->seq % p->n_blocks] = b;
+        while (NULL != (b = p->window[next % p->n_blocks])) {
+            p->window[next % p->n_blocks] = NULL;
+            accumulate(&p->result, b);
+            while (!spsc_push(&p->free, b)) {
+                wait_step(p, &w);
+            }
+            wait_done(p, &w, &p->compute.waiting_out);
+            next++;
+        }
+    }
+    p->compute.busy = now() - start - p->compute.waiting_in - p->compute.waiting_out;
+
+    return NULL;
+}
+
+
+static block_t *take_free(pipeline_t *p, waiter_t *w)
+{
+    block_t *b;
+
+    while (!spsc_pop(&p->free, &b)) {
+        wait_step(p, w);
+    }
+    wait_done(p, w, &p->reader.waiting_out);
+    b->length = 0;
+    b->overlong = false;
+
+    return b;
+}
+
+
+static void send(pipeline_t *p, block_t *b, size_t to, waiter_t *w)
+{
+    if (NULL != b) {
+        b->seq = p->sent++;
+    }
+    while (!spsc_push(&p->parsers[to].in, b)) {
+        wait_step(p, w);
+    }
+    wait_done(p, w, &p->reader.waiting_out);
+}
+
+
+/* runs on the calling thread; blocks are dealt to the parsers in turns */
+static void read_all(pipeline_t *p)
+{
+    waiter_t w = {0};
+    double start = now();
+    size_t to = 0;
+    bool skipping = false;
+    block_t *b = take_free(p, &w);
+    block_t *next;
+    const char *last;
+    const char *nl;
+    ssize_t n;
+
+    for (;;) {
+        {
+            TRACE_SCOPE("read");
+            n = read(p->fd, b->text + b->length, PIPELINE_BLOCK - b->length);
+        }
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            p->read_error = true;
+            break;
+        }
+        if (0 == n) {
+            break;
+        }
+
+        /* the rest of a line longer than a block is dropped (b is empty meanwhile) */
+        if (skipping) {
+            nl = (const char *) memchr(b->text, '\n', (size_t) n);
+            if (NULL == nl) {
+                continue;
+            }
+            skipping = false;
+            n -= nl + 1 - b->text;
+            memmove(b->text, nl + 1, (size_t) n);
+        }
+
+        b->length += (size_t) n;
+        if (b->length < PIPELINE_BLOCK) {
+            continue;
+        }
+
+        /* the incomplete last line moves to the next block */
+        next = take_free(p, &w);
+        last = last_newline(b->text, b->length);
+        if (NULL == last) {
+            b->length = 0;
+            b->overlong = true;
+            skipping = true;
+        } else {
+            next->length = (size_t) (b->text + b->length - (last + 1));
+            memcpy(next->text, last + 1, next->length);
+            b->length = (size_t) (last + 1 - b->text);
+        }
+        send(p, b, to, &w);
+        to = (to + 1) % p->n_parsers;
+        b = next;
+    }
+
+    send(p, b, to, &w);
+    for (size_t i = 0; i < p->n_parsers; ++i) {
+        send(p, NULL, i, &w);
+    }
+    p->reader.busy = now() - start - p->reader.waiting_out;
+}
+
+
+static void destroy(pipeline_t *p)
+{
+    if (NULL != p->parsers) {
+        for (size_t i = 0; i < p->n_parsers; ++i) {
+            free(p->parsers[i].in.slots);
+        }
+    }
+    free(p->parsers);
+    free(p->parsed.cells);
+    free(p->free.slots);
+    free(p->window);
+    free(p->blocks);
+    pthread_cond_destroy(&p->changed);
+    pthread_mutex_destroy(&p->lock);
+}
+
+
+static void fill_stage(pipeline_stage_t *s, double elapsed, size_t threads)
+{
+    s->utilization = (elapsed > 0) ? s->busy / (elapsed * threads) : 0;
+}
+
+
+bool pipeline_run(int fd, size_t parsers, pipeline_result_t *result, pipeline_stats_t *stats)
+{
+    pipeline_t p = {.lock = PTHREAD_MUTEX_INITIALIZER, .changed = PTHREAD_COND_INITIALIZER};
+    pthread_t compute;
+    size_t launched;
+    double start = now();
+    bool ok;
+
+    if ((NULL == result) || (0 == parsers) || (parsers > PIPELINE_MAX_PARSERS)) {
+        return false;
+    }
+
+    p.fd = fd;
+    p.n_parsers = parsers;
+    /* PIPELINE_DEPTH queued per parser, one being parsed and one being read or accumulated */
+    p.n_blocks = parsers * (PIPELINE_DEPTH + 2);
+    p.result.max = -INFINITY;
+    p.result.min = INFINITY;
+    atomic_init(&p.sleepers, 0);
+
+    p.blocks = (block_t *) malloc(p.n_blocks * sizeof(block_t));
+    p.window = (block_t **) calloc(p.n_blocks, sizeof(block_t *));
+    p.parsers = (parser_t *) calloc(parsers, sizeof(parser_t));
+    ok = (NULL != p.blocks) && (NULL != p.window) && (NULL != p.parsers);
+    ok = ok && spsc_init(&p.free, p.n_blocks) && mpsc_init(&p.parsed, p.n_blocks + parsers);
+    for (size_t i = 0; ok && (i < parsers); ++i) {
+        p.parsers[i].p = &p;
+        ok = spsc_init(&p.parsers[i].in, PIPELINE_DEPTH);
+    }
+    if (!ok) {
+        destroy(&p);
+        return false;
+    }
+    for (size_t i = 0; i < p.n_blocks; ++i) {
+        spsc_push(&p.free, &p.blocks[i]);
+    }
+
+    /* the compute stage waits for as many parsers as could be launched */
+    for (launched = 0; launched < parsers; ++launched) {
+        if (0 != pthread_create(&p.parsers[launched].thread, NULL, parser_main, &p.parsers[launched])) {
+            break;
+        }
+    }
+    p.n_parsers = launched;
+    if ((0 == launched) || (0 != pthread_create(&compute, NULL, compute_main, &p))) {
+        for (size_t i = 0; i < launched; ++i) {
+            spsc_push(&p.parsers[i].in, NULL);
+            notify(&p);
+            pthread_join(p.parsers[i].thread, NULL);
+        }
+        p.n_parsers = parsers;
+        destroy(&p);
+        return false;
+    }
+
+    read_all(&p);
+
+    for (size_t i = 0; i < launched; ++i) {
+        pthread_join(p.parsers[i].thread, NULL);
+    }
+    pthread_join(compute, NULL);
+
+    *result = p.result;
+    if (NULL != stats) {
+        memset(stats, 0, sizeof(*stats));
+        stats->elapsed = now() - start;
+        stats->blocks = p.sent;
+        stats->reader = p.reader;
+        stats->compute = p.compute;
+        for (size_t i = 0; i < launched; ++i) {
+            stats->parse.busy += p.parsers[i].stage.busy;
+            stats->parse.waiting_in += p.parsers[i].stage.waiting_in;
+            stats->parse.waiting_out += p.parsers[i].stage.waiting_out;
+        }
+        fill_stage(&stats->reader, stats->elapsed, 1);
+        fill_stage(&stats->parse, stats->elapsed, launched);
+        fill_stage(&stats->compute, stats->elapsed, 1);
+    }
+
+    ok = !p.read_error;
+    p.n_parsers = parsers;
+    destroy(&p);
+
+    return ok;
+}
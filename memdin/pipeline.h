@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * Lectura, conversión y cómputo solapados sobre un flujo de números (uno por línea).
+ *
+ * En lugar de leer una línea, convertirla y acumularla una tras otra, pipeline_run reparte el trabajo en tres etapas
+ * que corren a la vez:
+ *
+ * -   un hilo lector, que llena bloques de PIPELINE_BLOCK bytes con read() y los corta en el último '\n';
+ * -   `parsers` hilos que convierten las líneas de cada bloque con strtod;
+ * -   un hilo de cómputo, que acumula cantidad, suma, máximo y mínimo (como meand y maximo) en el orden de la entrada,
+ *     de modo que el resultado es idéntico al de recorrer el flujo secuencialmente.
+ *
+ * El lector le pasa los bloques a cada conversor por una cola SPSC propia de PIPELINE_DEPTH lugares (doble buffer),
+ * los conversores al cómputo por una única cola MPSC y el cómputo los devuelve al lector por otra SPSC. Las colas
+ * son acotadas y sin locks; sólo existen PIPELINE_DEPTH + 2 bloques por conversor, así que si una etapa se atrasa
+ * las anteriores esperan (backpressure) y la memoria usada no depende del tamaño de la entrada. Una etapa que espera
+ * primero reintenta, después cede el procesador y finalmente duerme en una variable de condición hasta que alguna
+ * cola cambie, así una entrada lenta (un pipe o un socket) no ocupa los procesadores.
+ *
+ * Las líneas en blanco se ignoran; las que no son un número (o son más largas que un bloque) se cuentan en
+ * `invalid`. Para cada etapa se informa cuánto tiempo trabajó y cuánto esperó: la de mayor utilización es el cuello
+ * de botella.
+ */
+
+#define PIPELINE_BLOCK (64 * 1024)
+#define PIPELINE_DEPTH 2
+#define PIPELINE_MAX_PARSERS 64
+
+
+typedef struct {
+    size_t count;
+    size_t invalid;
+    double sum;
+    double max;
+    double min;
+} pipeline_result_t;
+
+
+/* segundos; en la etapa de conversión se suman los de todos los hilos */
+typedef struct {
+    double busy;
+    double waiting_in;
+    double waiting_out;
+    double utilization;
+} pipeline_stage_t;
+
+
+typedef struct {
+    double elapsed;
+    size_t blocks;
+    pipeline_stage_t reader;
+    pipeline_stage_t parse;
+    pipeline_stage_t compute;
+} pipeline_stats_t;
+
+
+/* `stats` puede ser NULL; devuelve false si no pudo leer `fd` o lanzar los hilos */
+bool pipeline_run(int fd, size_t parsers, pipeline_result_t *result, pipeline_stats_t *stats);
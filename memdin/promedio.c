@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pipeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Cantidad, promedio, máximo y mínimo de los números leídos de stdin, uno por línea.
+ *
+ * Con 0 conversores se usa un ciclo de lectura y strtod como el de 3_4_array.c, en el que lectura, conversión y
+ * cómputo se hacen uno tras otro (con getline en lugar de fgets, para que una línea larga se lea entera, como en el
+ * pipeline); con 1 o más, pipeline_run, que las solapa e informa la utilización de cada etapa.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O2 -pthread -o promedio promedio.c pipeline.c -lm
+ * $ ./promedio [conversores] < datos.txt
+ */
+
+#define DEFAULT_PARSERS 2
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* the same rules as the pipeline: blank lines are skipped, anything but a number is counted as invalid */
+static void serial(pipeline_result_t *r)
+{
+    char *input = NULL;
+    size_t size = 0;
+    char *s;
+    char *pend;
+    double value;
+
+    while (-1 != getline(&input, &size, stdin)) {
+        for (s = input; (' ' == *s) || ('\t' == *s) || ('\r' == *s); ++s) ;
+        if (('\n' == *s) || ('\0' == *s)) {
+            continue;
+        }
+        value = strtod(s, &pend);
+        pend += strspn(pend, " \t\r\n");
+        if ((pend == s) || ('\0' != *pend)) {
+            r->invalid++;
+            continue;
+        }
+
+        r->count++;
+        r->sum += value;
+        if (value > r->max) {
+            r->max = value;
+        }
+        if (value < r->min) {
+            r->min = value;
+        }
+    }
+
+    free(input);
+}
+
+
+static void print_stage(const char *name, const pipeline_stage_t *s)
+{
+    printf("%-10s %10.3f %10.3f %10.3f %9.1f%%\n", name, s->busy, s->waiting_in, s->waiting_out,
+           100 * s->utilization);
+}
+
+
+int main(int argc, char *argv[])
+{
+    pipeline_result_t r = {0, 0, 0, -INFINITY, INFINITY};
+    pipeline_stats_t stats;
+    long parsers = (argc > 1) ? strtol(argv[1], NULL, 10) : DEFAULT_PARSERS;
+    double t;
+
+    if ((parsers < 0) || (parsers > PIPELINE_MAX_PARSERS)) {
+        fprintf(stderr, "Uso: %s [conversores (0 a %d)] < datos\n", argv[0], PIPELINE_MAX_PARSERS);
+        return EXIT_FAILURE;
+    }
+
+    t = now();
+    if (0 == parsers) {
+        serial(&r);
+        if (ferror(stdin)) {
+            fprintf(stderr, "Failed to read from stdin\n");
+            return EXIT_FAILURE;
+        }
+    } else if (!pipeline_run(STDIN_FILENO, (size_t) parsers, &r, &stats)) {
+        fprintf(stderr, "Failed to read from stdin\n");
+        return EXIT_FAILURE;
+    }
+    t = now() - t;
+
+    printf("%zu números (%zu líneas inválidas) en %.3f s\n", r.count, r.invalid, t);
+    if (0 != r.count) {
+        printf("promedio: %.17g\nmáximo: %g\nmínimo: %g\n", r.sum / r.count, r.max, r.min);
+    }
+
+    if (0 != parsers) {
+        printf("\n%zu bloques de %d bytes\n", stats.blocks, PIPELINE_BLOCK);
+        printf("%-10s %10s %10s %10s %10s\n", "etapa", "trabajo", "espera", "espera", "uso");
+        printf("%-10s %10s %10s %10s %10s\n", "", "(s)", "entrada", "salida", "");
+        print_stage("lectura", &stats.reader);
+        print_stage("conversión", &stats.parse);
+        print_stage("cómputo", &stats.compute);
+    }
+
+    return EXIT_SUCCESS;
+}
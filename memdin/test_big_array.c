@@ -0,0 +1,196 @@
+#include "big_array.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Llena un big_array_t de a un elemento y de a bloques en cada modo, con y sin huge pages, y verifica el contenido.
+ * En modo reserva comprueba que `data` no cambie y que no se pueda crecer más allá de la reserva; en modo remap
+ * cuenta cuántas veces se movió `data` y cuántos elementos se copiaron (0 si mremap está disponible). Con huge pages
+ * informa qué páginas se obtuvieron: si no hay páginas de 2 MB reservadas (/proc/sys/vm/nr_hugepages) el modo remap
+ * tiene que caer a transparent huge pages o a páginas normales.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O2 -o test_big_array test_big_array.c big_array.c
+ * $ ./test_big_array [elementos]
+ */
+
+#define DEFAULT_LENGTH (3UL << 20)
+#define BLOCK 1000
+
+
+static const char *pages_name(big_pages_t pages)
+{
+    switch (pages) {
+        case BIG_PAGES_NORMAL:
+            return "normales";
+        case BIG_PAGES_TRANSPARENT:
+            return "transparent huge pages";
+        case BIG_PAGES_EXPLICIT:
+            return "huge pages explícitas";
+        default:
+            return "?";
+    }
+}
+
+
+static bool check_contents(const big_array_t *a, size_t n)
+{
+    if (a->length != n) {
+        fprintf(stderr, "\tEl largo es %zu y debería ser %zu\n", a->length, n);
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (a->data[i] != (double) i) {
+            fprintf(stderr, "\tEl elemento %zu es %g y debería ser %zu\n", i, a->data[i], i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* the first half one element at a time, the rest in blocks of BLOCK; counts how many times data moved once mapped */
+static bool fill(big_array_t *a, size_t n, size_t *moves)
+{
+    double block[BLOCK];
+    double *data = a->data;
+    size_t k;
+
+    *moves = 0;
+    while (a->length < n / 2) {
+        if (!big_array_push(a, (double) a->length)) {
+            return false;
+        }
+        if (a->data != data) {
+            *moves += (NULL != data);
+            data = a->data;
+        }
+    }
+    while (a->length < n) {
+        k = (n - a->length < BLOCK) ? n - a->length : BLOCK;
+        for (size_t i = 0; i < k; ++i) {
+            block[i] = (double) (a->length + i);
+        }
+        if (!big_array_append(a, block, k)) {
+            return false;
+        }
+        if (a->data != data) {
+            *moves += (NULL != data);
+            data = a->data;
+        }
+    }
+
+    return true;
+}
+
+
+static bool test_reserve(size_t n, bool huge_pages)
+{
+    big_array_t a;
+    double *data;
+    double extra[2] = {-1, -1};
+    size_t moves;
+    bool ok = true;
+
+    printf("Modo reserva, %s huge pages:\n", huge_pages ? "con" : "sin");
+    if (!big_array_init(&a, BIG_ARRAY_RESERVE, n, huge_pages)) {
+        fprintf(stderr, "\tNo se pudo reservar el espacio de direcciones\n");
+        return false;
+    }
+    data = a.data;
+
+    if (!fill(&a, n, &moves)) {
+        fprintf(stderr, "\tNo se pudo crecer dentro de la reserva (%zu de %zu)\n", a.length, n);
+        ok = false;
+    }
+    ok = check_contents(&a, a.length) && ok;
+    if ((data != a.data) || (0 != moves)) {
+        fprintf(stderr, "\tdata cambió dentro de la reserva\n");
+        ok = false;
+    }
+
+    /* all of the reservation may already be usable (it is rounded to 2 MB): fill it before going past it */
+    while (big_array_push(&a, (double) a.length)) ;
+    if (a.length * sizeof(double) != a.reserved) {
+        fprintf(stderr, "\tSe llenaron %zu elementos de una reserva de %zu bytes\n", a.length, a.reserved);
+        ok = false;
+    }
+    if (big_array_append(&a, extra, 2) || big_array_reserve(&a, a.capacity + 1)) {
+        fprintf(stderr, "\tSe pudo crecer más allá de la reserva\n");
+        ok = false;
+    }
+    ok = check_contents(&a, a.length) && ok;
+
+    printf("\t%zu elementos en %zu bytes reservados, data sin cambios: %s, páginas %s\n", a.length, a.reserved,
+           (data == a.data) ? "sí" : "no", pages_name(a.pages));
+    big_array_free(&a);
+
+    return ok;
+}
+
+
+static bool test_remap(size_t n, bool huge_pages)
+{
+    big_array_t a;
+    size_t moves;
+    bool ok = true;
+
+    printf("Modo remap, %s huge pages:\n", huge_pages ? "con" : "sin");
+    if (!big_array_init(&a, BIG_ARRAY_REMAP, 0, huge_pages)) {
+        fprintf(stderr, "\tNo se pudo inicializar\n");
+        return false;
+    }
+
+    if (!fill(&a, n, &moves)) {
+        fprintf(stderr, "\tNo se pudo crecer (%zu de %zu)\n", a.length, n);
+        ok = false;
+    }
+    ok = check_contents(&a, a.length) && ok;
+    if (a.capacity * sizeof(double) != a.mapped) {
+        fprintf(stderr, "\tLa capacidad no coincide con lo mapeado\n");
+        ok = false;
+    }
+    if (huge_pages && (0 != a.mapped % BIG_ARRAY_HUGE_PAGE_SIZE)) {
+        fprintf(stderr, "\tLo mapeado no es múltiplo de 2 MB\n");
+        ok = false;
+    }
+
+    printf("\t%zu elementos en %zu bytes mapeados, data se movió %zu veces, %zu elementos copiados, páginas %s\n",
+           a.length, a.mapped, moves, a.copies, pages_name(a.pages));
+    big_array_free(&a);
+
+    return ok;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LENGTH;
+    big_array_t a;
+    bool ok = true;
+
+    if (0 == n) {
+        fprintf(stderr, "Uso: %s [elementos > 0]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ok = test_reserve(n, false) && ok;
+    ok = test_reserve(n, true) && ok;
+    ok = test_remap(n, false) && ok;
+    ok = test_remap(n, true) && ok;
+
+    puts("Prueba con una reserva de largo 0:");
+    if (big_array_init(&a, BIG_ARRAY_RESERVE, 0, false)) {
+        fprintf(stderr, "\tSe pudo inicializar\n");
+        big_array_free(&a);
+        ok = false;
+    } else {
+        puts("\tNo se pudo inicializar (como se esperaba)");
+    }
+
+    puts(ok ? "Todas las pruebas pasaron" : "Alguna prueba falló");
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
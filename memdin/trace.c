@@ -0,0 +1,193 @@
+#define _POSIX_C_SOURCE 200809L
+
+#ifndef TRACE
+#define TRACE
+#endif
+
+#include "trace.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_FILE "trace.json"
+
+
+typedef struct {
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+} event_t;
+
+
+/* one per thread, never freed: the events of a finished thread are still exported */
+typedef struct buffer {
+    struct buffer *next;
+    unsigned long tid;
+    atomic_size_t head;
+    event_t events[TRACE_CAPACITY];
+} buffer_t;
+
+
+static _Atomic(buffer_t *) buffers = NULL;
+static _Thread_local buffer_t *local = NULL;
+static atomic_ulong next_tid = 0;
+static atomic_flag installed = ATOMIC_FLAG_INIT;
+static uint64_t ticks_origin;
+static uint64_t ns_origin;
+
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+
+static void write_at_exit(void)
+{
+    const char *path = getenv("TRACE_FILE");
+
+    trace_write((NULL != path) ? path : DEFAULT_FILE);
+}
+
+
+static void install(void)
+{
+    if (atomic_flag_test_and_set(&installed)) {
+        return;
+    }
+
+    /* both clocks are read together now and again when writing: that pair converts ticks to nanoseconds */
+    ticks_origin = trace_now();
+    ns_origin = now_ns();
+    atexit(write_at_exit);
+}
+
+
+static buffer_t *local_buffer(void)
+{
+    buffer_t *b;
+
+    if (NULL != local) {
+        return local;
+    }
+
+    install();
+    b = (buffer_t *) calloc(1, sizeof(buffer_t));
+    if (NULL == b) {
+        return NULL;
+    }
+    b->tid = atomic_fetch_add(&next_tid, 1) + 1;
+
+    /* lock-free push: the list is only ever prepended to */
+    b->next = atomic_load(&buffers);
+    while (!atomic_compare_exchange_weak(&buffers, &b->next, b)) ;
+    local = b;
+
+    return b;
+}
+
+
+void trace_end(trace_span_t *span)
+{
+    uint64_t end = trace_now();
+    buffer_t *b = local_buffer();
+    event_t *e;
+    size_t head;
+
+    if (NULL == b) {
+        return;
+    }
+
+    /* single writer: a plain store of the event, then publish it by moving the head */
+    head = atomic_load_explicit(&b->head, memory_order_relaxed);
+    e = &b->events[head % TRACE_CAPACITY];
+    e->name = span->name;
+    e->start = span->start;
+    e->end = end;
+    atomic_store_explicit(&b->head, head + 1, memory_order_release);
+}
+
+
+static void write_name(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; '\0' != *s; ++s) {
+        if (('"' == *s) || ('\\' == *s)) {
+            fputc('\\', f);
+        }
+        if ((unsigned char) *s >= ' ') {
+            fputc(*s, f);
+        }
+    }
+    fputc('"', f);
+}
+
+
+bool trace_write(const char *path)
+{
+    FILE *f;
+    buffer_t *b;
+    const event_t *e;
+    size_t head;
+    size_t first;
+    double scale;
+    uint64_t ticks;
+    uint64_t origin = UINT64_MAX;
+    bool comma = false;
+    long pid = (long) getpid();
+
+    if (NULL == path) {
+        return false;
+    }
+
+    /* nothing was ever recorded */
+    if (NULL == atomic_load(&buffers)) {
+        return true;
+    }
+
+    ticks = trace_now() - ticks_origin;
+    scale = (0 != ticks) ? (double) (now_ns() - ns_origin) / ticks : 1.0;
+
+    /* the outermost spans start before the first one ends (and the clocks are paired): time 0 is the earliest start */
+    for (b = atomic_load(&buffers); NULL != b; b = b->next) {
+        head = atomic_load_explicit(&b->head, memory_order_acquire);
+        first = (head > TRACE_CAPACITY) ? head - TRACE_CAPACITY : 0;
+        for (size_t i = first; i < head; ++i) {
+            e = &b->events[i % TRACE_CAPACITY];
+            origin = (e->start < origin) ? e->start : origin;
+        }
+    }
+
+    f = fopen(path, "w");
+    if (NULL == f) {
+        return false;
+    }
+
+    /* Chrome's "complete" events (ph X): start and duration in microseconds */
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", f);
+    for (b = atomic_load(&buffers); NULL != b; b = b->next) {
+        head = atomic_load_explicit(&b->head, memory_order_acquire);
+        first = (head > TRACE_CAPACITY) ? head - TRACE_CAPACITY : 0;
+        for (size_t i = first; i < head; ++i) {
+            e = &b->events[i % TRACE_CAPACITY];
+            fputs(comma ? ",\n{\"name\":" : "{\"name\":", f);
+            write_name(f, e->name);
+            fprintf(f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%lu}",
+                    (double) (e->start - origin) * scale / 1e3,
+                    (double) (e->end - e->start) * scale / 1e3, pid, b->tid);
+            comma = true;
+        }
+    }
+    fputs("\n]}\n", f);
+
+    return 0 == fclose(f);
+}
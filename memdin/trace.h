@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Trazas de tiempo de bajo costo.
+ *
+ * TRACE_SCOPE("nombre") mide el tiempo desde ese punto hasta el final del bloque que lo contiene; TRACE_FUNCTION()
+ * hace lo mismo usando el nombre de la función. Si se compila sin TRACE las macros no generan código.
+ *
+ * Compilando con -DTRACE (y agregando trace.c) cada intervalo se guarda en un buffer circular propio del hilo (sin
+ * locks: cada buffer tiene un único escritor) de TRACE_CAPACITY eventos; si se llena se pisan los más viejos. Los
+ * tiempos se toman con rdtsc en x86-64 y con clock_gettime en el resto. Al terminar el programa los eventos de todos
+ * los hilos se escriben en formato Chrome trace-event (JSON) en el archivo indicado por la variable de entorno
+ * TRACE_FILE (por defecto trace.json), que puede abrirse con https://ui.perfetto.dev o chrome://tracing.
+ * trace_write permite escribirlos antes, mientras los demás hilos no estén registrando eventos.
+ */
+
+#define TRACE_CAPACITY 65536
+
+#ifdef TRACE
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#define TRACE_CAT_(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT_(a, b)
+
+/* the span variable ends its life with the block: the cleanup attribute records it there, on any exit path */
+#define TRACE_SCOPE(name)                                                                                           \
+    trace_span_t TRACE_CAT(trace_span_, __LINE__) __attribute__((cleanup(trace_end))) = trace_begin(name)
+#define TRACE_FUNCTION() TRACE_SCOPE(__func__)
+
+
+typedef struct {
+    const char *name;
+    uint64_t start;
+} trace_span_t;
+
+
+static inline uint64_t trace_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+static inline trace_span_t trace_begin(const char *name)
+{
+    trace_span_t span = {name, trace_now()};
+
+    return span;
+}
+
+
+void trace_end(trace_span_t *span);
+bool trace_write(const char *path);
+
+#else
+
+#define TRACE_SCOPE(name) ((void) 0)
+#define TRACE_FUNCTION() ((void) 0)
+
+#define trace_write(path) (true)
+
+#endif
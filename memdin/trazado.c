@@ -0,0 +1,140 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+#include "../estructuras/estudiante.h"
+#include "../punteros/src/meand.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * trace.h sobre código que no lo incluye: las funciones y los ciclos de los otros capítulos se miden desde afuera, con
+ * un TRACE_SCOPE alrededor de cada llamada, y los originales quedan como están.
+ *
+ * Lee números de stdin, uno por línea, con una copia del ciclo de fgets y strtod de ptr_array.c y ptr_array_2.c que
+ * sigue hasta el final de la entrada; después les aplica sum, sumar y meand, y por cada número crea y libera un
+ * estudiante con estudiante_crear. Cada llamada es un intervalo de la traza, que se escribe en $TRACE_FILE.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O2 -DTRACE -pthread -o trazado trazado.c trace.c ../arreglos/sum.c \
+ *       ../arreglos/sumar.c ../punteros/src/meand_st.c ../estructuras/estudiante.c ../estructuras/pool.c
+ * $ seq 10000 | TRACE_FILE=trazado.json ./trazado
+ */
+
+#define MAX_LENGTH 256
+#define INITIAL_CAPACITY 1024
+
+/* arreglos/sum.c y arreglos/sumar.c */
+double sum(const double v[], size_t n);
+void sumar(double lhs[], const double rhs1[], const double rhs2[], size_t n);
+
+
+static void strip_newline(char *s)
+{
+    char *p = strrchr(s, '\n');
+
+    if (NULL != p) {
+        *p = '\0';
+    }
+}
+
+
+/* the input loop of ptr_array.c, with a span for every fgets and every strtod */
+static double *leer(size_t *n)
+{
+    char input[MAX_LENGTH];
+    char *perr = NULL;
+    char *leido;
+    double *v = NULL;
+    double *aux_v;
+    double aux;
+    size_t capacidad = 0;
+    TRACE_FUNCTION();
+
+    *n = 0;
+    for (;;) {
+        {
+            TRACE_SCOPE("fgets");
+            leido = fgets(input, MAX_LENGTH, stdin);
+        }
+        if (NULL == leido) {
+            break;
+        }
+
+        strip_newline(input);
+        {
+            TRACE_SCOPE("strtod");
+            aux = strtod(input, &perr);
+        }
+        if (('\0' == *input) || ('\0' != *perr)) {
+            fprintf(stderr, "\"%s\" no puede ser convertido a un número\n", input);
+            continue;
+        }
+
+        if (*n == capacidad) {
+            capacidad = (0 == capacidad) ? INITIAL_CAPACITY : 2 * capacidad;
+            aux_v = (double *) realloc(v, capacidad * sizeof(double));
+            if (NULL == aux_v) {
+                free(v);
+                *n = 0;
+                return NULL;
+            }
+            v = aux_v;
+        }
+        v[(*n)++] = aux;
+    }
+
+    return v;
+}
+
+
+int main(void)
+{
+    estudiante_t *estudiante;
+    char nombre[32];
+    double *v;
+    double *w;
+    double suma;
+    double media;
+    size_t n;
+    status_t st;
+
+    v = leer(&n);
+    w = (double *) malloc(n * sizeof(double));
+    if ((0 == n) || (NULL == w)) {
+        fprintf(stderr, "No se leyó ningún número\n");
+        free(v);
+        free(w);
+        return EXIT_FAILURE;
+    }
+
+    {
+        TRACE_SCOPE("sum");
+        suma = sum(v, n);
+    }
+    {
+        TRACE_SCOPE("sumar");
+        sumar(w, v, v, n);
+    }
+    {
+        TRACE_SCOPE("meand");
+        st = meand(&media, v, n);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(nombre, sizeof(nombre), "%g", v[i]);
+        {
+            TRACE_SCOPE("estudiante_crear");
+            estudiante = estudiante_crear(nombre, "Trazado");
+        }
+        if (NULL != estudiante) {
+            estudiante_free(&estudiante);
+        }
+    }
+
+    printf("%zu números, suma %g, media %g (%s)\n", n, suma, media, (ST_OK == st) ? "ok" : "error");
+    free(v);
+    free(w);
+
+    return EXIT_SUCCESS;
+}
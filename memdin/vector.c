@@ -0,0 +1,6 @@
+#include "vector.h"
+
+
+VECTOR_DEFINE(double, double)
+VECTOR_DEFINE(float, float)
+VECTOR_DEFINE(int, int)
@@ -0,0 +1,182 @@
+#pragma once
+#include "alloc_hook.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Arreglo dinámico con crecimiento geométrico.
+ *
+ * Cada vez que falta lugar la capacidad se multiplica por `growth` (por defecto 2), de modo que agregar n elementos
+ * cuesta O(log n) llamadas a realloc en lugar de O(n). `stats` cuenta los realloc y los elementos que hubo que
+ * copiar porque realloc movió el bloque.
+ *
+ * VECTOR_DECLARE(T, name) declara vector_name_t y sus funciones; VECTOR_DEFINE(T, name) las implementa.
+ * vector.c las instancia para double, float e int.
+ */
+
+#define VECTOR_INITIAL_CAPACITY 8
+#define VECTOR_DEFAULT_GROWTH 2.0
+
+
+typedef struct {
+    size_t reallocs;
+    size_t copies;
+} vector_stats_t;
+
+
+#define VECTOR_DECLARE(T, name)                                                                                     \
+typedef struct {                                                                                                    \
+    T *data;                                                                                                        \
+    size_t length;                                                                                                  \
+    size_t capacity;                                                                                                \
+    double growth;                                                                                                  \
+    vector_stats_t stats;                                                                                           \
+} vector_##name##_t;                                                                                                \
+                                                                                                                    \
+bool vector_##name##_init(vector_##name##_t *v, size_t capacity, double growth);                                    \
+void vector_##name##_free(vector_##name##_t *v);                                                                    \
+bool vector_##name##_reserve(vector_##name##_t *v, size_t capacity);                                                \
+bool vector_##name##_append(vector_##name##_t *v, const T *src, size_t n);                                          \
+bool vector_##name##_shrink_to_fit(vector_##name##_t *v);                                                           \
+                                                                                                                    \
+/* push is inlined: only the (rare) growth goes through a function call */                                          \
+static inline bool vector_##name##_push(vector_##name##_t *v, T value)                                              \
+{                                                                                                                   \
+    if ((v->length == v->capacity) && !vector_##name##_reserve(v, v->length + 1)) {                                 \
+        return false;                                                                                               \
+    }                                                                                                               \
+    v->data[v->length++] = value;                                                                                   \
+    return true;                                                                                                    \
+}
+
+
+#define VECTOR_DEFINE(T, name)                                                                                      \
+static bool vector_##name##_resize(vector_##name##_t *v, size_t capacity)                                           \
+{                                                                                                                   \
+    uintptr_t before;                                                                                               \
+    T *aux;                                                                                                         \
+                                                                                                                    \
+    if (capacity > SIZE_MAX / sizeof(T)) {                                                                          \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    /* only the address is kept (as an integer) to tell whether realloc moved the block */                          \
+    memcpy(&before, &v->data, sizeof(before));                                                                      \
+    aux = (T *) HOOK_REALLOC(v->data, capacity * sizeof(T));                                                        \
+    if ((NULL == aux) && (0 != capacity)) {                                                                         \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    v->stats.reallocs++;                                                                                            \
+    if ((0 != before) && ((uintptr_t) aux != before)) {                                                             \
+        v->stats.copies += v->length;                                                                               \
+    }                                                                                                               \
+    v->data = aux;                                                                                                  \
+    v->capacity = capacity;                                                                                         \
+                                                                                                                    \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+bool vector_##name##_init(vector_##name##_t *v, size_t capacity, double growth)                                     \
+{                                                                                                                   \
+    if (NULL == v) {                                                                                                \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    v->data = NULL;                                                                                                 \
+    v->length = 0;                                                                                                  \
+    v->capacity = 0;                                                                                                \
+    v->growth = (growth > 1.0) ? growth : VECTOR_DEFAULT_GROWTH;                                                    \
+    v->stats.reallocs = 0;                                                                                          \
+    v->stats.copies = 0;                                                                                            \
+                                                                                                                    \
+    return (0 == capacity) || vector_##name##_resize(v, capacity);                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+void vector_##name##_free(vector_##name##_t *v)                                                                     \
+{                                                                                                                   \
+    if (NULL != v) {                                                                                                \
+        HOOK_FREE(v->data);                                                                                         \
+        v->data = NULL;                                                                                             \
+        v->length = 0;                                                                                              \
+        v->capacity = 0;                                                                                            \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+bool vector_##name##_reserve(vector_##name##_t *v, size_t capacity)                                                 \
+{                                                                                                                   \
+    double grown;                                                                                                   \
+    size_t target;                                                                                                  \
+                                                                                                                    \
+    if (NULL == v) {                                                                                                \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    if (capacity <= v->capacity) {                                                                                  \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    /* rounded up and at least one more: with a growth close to 1 truncating could leave the capacity as it was */  \
+    grown = v->capacity * v->growth;                                                                                \
+    target = (grown < (double) (SIZE_MAX / sizeof(T))) ? (size_t) grown : SIZE_MAX / sizeof(T);                     \
+    if (((double) target < grown) && (target < SIZE_MAX / sizeof(T))) {                                             \
+        target++;                                                                                                   \
+    }                                                                                                               \
+    if (target <= v->capacity) {                                                                                    \
+        target = v->capacity + 1;                                                                                   \
+    }                                                                                                               \
+    if (target < VECTOR_INITIAL_CAPACITY) {                                                                         \
+        target = VECTOR_INITIAL_CAPACITY;                                                                           \
+    }                                                                                                               \
+    if (target < capacity) {                                                                                        \
+        target = capacity;                                                                                          \
+    }                                                                                                               \
+                                                                                                                    \
+    return vector_##name##_resize(v, target);                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+bool vector_##name##_append(vector_##name##_t *v, const T *src, size_t n)                                           \
+{                                                                                                                   \
+    if ((NULL == v) || ((NULL == src) && (0 != n))) {                                                               \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    if ((n > SIZE_MAX - v->length) || !vector_##name##_reserve(v, v->length + n)) {                                 \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    if (0 != n) {                                                                                                   \
+        memcpy(v->data + v->length, src, n * sizeof(T));                                                            \
+        v->length += n;                                                                                             \
+    }                                                                                                               \
+                                                                                                                    \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+bool vector_##name##_shrink_to_fit(vector_##name##_t *v)                                                            \
+{                                                                                                                   \
+    if (NULL == v) {                                                                                                \
+        return false;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    if (v->length == v->capacity) {                                                                                 \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    if (0 == v->length) {                                                                                           \
+        HOOK_FREE(v->data);                                                                                         \
+        v->data = NULL;                                                                                             \
+        v->capacity = 0;                                                                                            \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    return vector_##name##_resize(v, v->length);                                                                    \
+}
+
+
+VECTOR_DECLARE(double, double)
+VECTOR_DECLARE(float, float)
+VECTOR_DECLARE(int, int)
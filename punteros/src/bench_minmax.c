@@ -0,0 +1,162 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "status.h"
+#include "minmax.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Compara argmax/minmax (contiguos y con arreglo de punteros) contra el ciclo de `maximo` de ptr_array.c.
+ * Los punteros se prueban apuntando en orden y mezclados, para ver el efecto del prefetch.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -o bench_minmax bench_minmax.c minmax.c
+ * $ ./bench_minmax [elementos] [repeticiones]
+ */
+
+#define DEFAULT_LENGTH (1UL << 22)
+#define DEFAULT_REPS 20
+
+
+/* copia de ptr_array.c */
+double maximo(double *ptrs[], size_t l)
+{
+    double m;
+
+    m = *ptrs[0];
+    while (--l) {
+        if (*ptrs[l] > m) {
+            m = *ptrs[l];
+        }
+    }
+    return m;
+}
+
+
+/* el mismo ciclo sobre el arreglo contiguo */
+double maximo_contiguo(const double v[], size_t l)
+{
+    double m;
+
+    m = v[0];
+    while (--l) {
+        if (v[l] > m) {
+            m = v[l];
+        }
+    }
+    return m;
+}
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+static void reportar(const char *nombre, double t, size_t n, size_t reps, double valor, size_t indice)
+{
+    printf("%-28s %8.3f ms %8.2f Melem/s   %g [%zu]\n", nombre, t / reps * 1e3, n * reps / t * 1e-6, valor, indice);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LENGTH;
+    size_t reps = (argc > 2) ? strtoul(argv[2], NULL, 10) : DEFAULT_REPS;
+    double *v = (double *) malloc(n * sizeof(double));
+    double **en_orden = (double **) malloc(n * sizeof(double *));
+    double **mezclados = (double **) malloc(n * sizeof(double *));
+    double *const *casos[] = {en_orden, mezclados};
+    const char *nombres[] = {"en orden", "mezclados"};
+    unsigned long semilla = 88172645463325252UL;
+    extremo_t e = {0, 0};
+    minmax_t r;
+    volatile double sink = 0;
+    double *aux;
+    double t;
+    size_t j;
+
+    if ((0 == n) || (0 == reps) || (NULL == v) || (NULL == en_orden) || (NULL == mezclados)) {
+        fprintf(stderr, "Uso: %s [elementos > 0] [repeticiones > 0]\n", argv[0]);
+        free(v);
+        free(en_orden);
+        free(mezclados);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = (double) (siguiente(&semilla) >> 11) / (1UL << 53);
+        en_orden[i] = &v[i];
+        mezclados[i] = &v[i];
+    }
+    for (size_t i = n - 1; i > 0; --i) {
+        j = siguiente(&semilla) % (i + 1);
+        aux = mezclados[i];
+        mezclados[i] = mezclados[j];
+        mezclados[j] = aux;
+    }
+
+    printf("%zu elementos, %zu repeticiones\n\n", n, reps);
+
+    t = now();
+    for (size_t k = 0; k < reps; ++k) {
+        sink = maximo_contiguo(v, n);
+    }
+    reportar("maximo (contiguo)", now() - t, n, reps, sink, 0);
+
+    t = now();
+    for (size_t k = 0; k < reps; ++k) {
+        argmax(&e, v, n);
+    }
+    reportar("argmax", now() - t, n, reps, e.value, e.index);
+
+    t = now();
+    for (size_t k = 0; k < reps; ++k) {
+        minmax(&r, v, n);
+    }
+    reportar("minmax (max)", now() - t, n, reps, r.max.value, r.max.index);
+
+    for (size_t c = 0; c < sizeof(casos) / sizeof(casos[0]); ++c) {
+        printf("\npunteros %s\n", nombres[c]);
+
+        t = now();
+        for (size_t k = 0; k < reps; ++k) {
+            sink = maximo((double **) casos[c], n);
+        }
+        reportar("maximo", now() - t, n, reps, sink, 0);
+
+        t = now();
+        for (size_t k = 0; k < reps; ++k) {
+            argmax_ptr(&e, casos[c], n);
+        }
+        reportar("argmax_ptr", now() - t, n, reps, e.value, e.index);
+
+        t = now();
+        for (size_t k = 0; k < reps; ++k) {
+            minmax_ptr(&r, casos[c], n);
+        }
+        reportar("minmax_ptr (max)", now() - t, n, reps, r.max.value, r.max.index);
+    }
+
+    free(v);
+    free(en_orden);
+    free(mezclados);
+
+    return EXIT_SUCCESS;
+}
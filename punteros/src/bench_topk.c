@@ -0,0 +1,202 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "status.h"
+#include "minmax.h"
+#include "topk.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Compara topk, nth_element y partial_sort (contiguos y con arreglo de punteros mezclados) contra ordenar todo con
+ * qsort y tomar lo que haga falta, que es lo que se hace sin ellas. También verifica que den lo mismo que qsort.
+ *
+ * $ gcc -Wall -pedantic -std=c17 -O3 -march=native -o bench_topk bench_topk.c topk.c
+ * $ ./bench_topk [elementos] [repeticiones]
+ */
+
+#define DEFAULT_LENGTH (1UL << 22)
+#define DEFAULT_REPS 5
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/* de mayor a menor y, entre iguales, por posición: el orden de topk (sin NaN) */
+static int comparar_top(const void *a, const void *b)
+{
+    const extremo_t *x = (const extremo_t *) a;
+    const extremo_t *y = (const extremo_t *) b;
+
+    if (x->value != y->value) {
+        return (x->value < y->value) ? 1 : -1;
+    }
+
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+
+static int comparar(const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+static void reportar(const char *nombre, size_t k, double t, size_t reps, bool ok)
+{
+    printf("%-22s k = %-8zu %10.3f ms   %s\n", nombre, k, t / reps * 1e3, ok ? "ok" : "DISTINTO");
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_LENGTH;
+    size_t reps = (argc > 2) ? strtoul(argv[2], NULL, 10) : DEFAULT_REPS;
+    double *v = (double *) malloc(n * sizeof(double));
+    double *copia = (double *) malloc(n * sizeof(double));
+    double *ordenado = (double *) malloc(n * sizeof(double));
+    double **ptrs = (double **) malloc(n * sizeof(double *));
+    double **mezclados = (double **) malloc(n * sizeof(double *));
+    extremo_t *todos = (extremo_t *) malloc(n * sizeof(extremo_t));
+    extremo_t *top = (extremo_t *) malloc(n * sizeof(extremo_t));
+    unsigned long semilla = 88172645463325252UL;
+    size_t ks[] = {1, 10, 100, 1000, 0};
+    bool ok;
+    double *aux;
+    double t;
+    size_t j;
+
+    if ((0 == n) || (0 == reps) || (NULL == v) || (NULL == copia) || (NULL == ordenado) || (NULL == ptrs) ||
+        (NULL == mezclados) || (NULL == todos) || (NULL == top)) {
+        fprintf(stderr, "Uso: %s [elementos > 0] [repeticiones > 0]\n", argv[0]);
+        free(v);
+        free(copia);
+        free(ordenado);
+        free(ptrs);
+        free(mezclados);
+        free(todos);
+        free(top);
+        return EXIT_FAILURE;
+    }
+
+    /* valores repetidos a propósito, para probar el desempate por posición */
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = (double) (siguiente(&semilla) % (n / 2 + 1));
+        mezclados[i] = &v[i];
+    }
+    for (size_t i = n - 1; i > 0; --i) {
+        j = siguiente(&semilla) % (i + 1);
+        aux = mezclados[i];
+        mezclados[i] = mezclados[j];
+        mezclados[j] = aux;
+    }
+    memcpy(ordenado, v, n * sizeof(double));
+    qsort(ordenado, n, sizeof(double), comparar);
+    ks[sizeof(ks) / sizeof(ks[0]) - 1] = n / 8;
+
+    printf("%zu elementos, %zu repeticiones\n\n", n, reps);
+
+    t = now();
+    for (size_t r = 0; r < reps; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            todos[i].value = v[i];
+            todos[i].index = i;
+        }
+        qsort(todos, n, sizeof(extremo_t), comparar_top);
+    }
+    reportar("qsort (cualquier k)", n, now() - t, reps, true);
+
+    for (size_t c = 0; c < sizeof(ks) / sizeof(ks[0]); ++c) {
+        size_t k = (ks[c] <= n) ? ks[c] : n;
+
+        printf("\n");
+
+        t = now();
+        for (size_t r = 0; r < reps; ++r) {
+            topk(top, k, v, n);
+        }
+        ok = (0 == memcmp(top, todos, k * sizeof(extremo_t)));
+        reportar("topk", k, now() - t, reps, ok);
+
+        t = now();
+        for (size_t r = 0; r < reps; ++r) {
+            topk_ptr(top, k, mezclados, n);
+        }
+        ok = true;
+        for (size_t i = 0; ok && (i < k); ++i) {
+            /* las posiciones son en el arreglo de punteros: se compara a qué valor apuntan */
+            ok = (top[i].value == todos[i].value) && (*mezclados[top[i].index] == top[i].value);
+        }
+        reportar("topk_ptr (mezclados)", k, now() - t, reps, ok);
+
+        t = now();
+        for (size_t r = 0; r < reps; ++r) {
+            memcpy(copia, v, n * sizeof(double));
+            partial_sort(copia, n, k);
+        }
+        reportar("partial_sort", k, now() - t, reps, 0 == memcmp(copia, ordenado, k * sizeof(double)));
+
+        t = now();
+        for (size_t r = 0; r < reps; ++r) {
+            memcpy(ptrs, mezclados, n * sizeof(double *));
+            partial_sort_ptr(ptrs, n, k);
+        }
+        ok = true;
+        for (size_t i = 0; ok && (i < k); ++i) {
+            ok = (*ptrs[i] == ordenado[i]);
+        }
+        reportar("partial_sort_ptr", k, now() - t, reps, ok);
+    }
+
+    printf("\n");
+    t = now();
+    for (size_t r = 0; r < reps; ++r) {
+        memcpy(copia, v, n * sizeof(double));
+        nth_element(copia, n, n / 2);
+    }
+    ok = (copia[n / 2] == ordenado[n / 2]);
+    for (size_t i = 0; ok && (i < n); ++i) {
+        ok = (i < n / 2) ? (copia[i] <= copia[n / 2]) : (copia[i] >= copia[n / 2]);
+    }
+    reportar("nth_element (mediana)", n / 2, now() - t, reps, ok);
+
+    t = now();
+    for (size_t r = 0; r < reps; ++r) {
+        memcpy(ptrs, mezclados, n * sizeof(double *));
+        nth_element_ptr(ptrs, n, n / 2);
+    }
+    reportar("nth_element_ptr", n / 2, now() - t, reps, *ptrs[n / 2] == ordenado[n / 2]);
+
+    free(v);
+    free(copia);
+    free(ordenado);
+    free(ptrs);
+    free(mezclados);
+    free(todos);
+    free(top);
+
+    return EXIT_SUCCESS;
+}
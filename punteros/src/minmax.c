@@ -0,0 +1,317 @@
+#include "status.h"
+#include "minmax.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/* how many pointers ahead to prefetch; enough to cover a memory access at the rate the loop consumes elements */
+#define PREFETCH_DISTANCE 32
+#define LANES 4
+
+
+typedef struct {
+    extremo_t min;
+    extremo_t max;
+    bool nan;
+} scan_t;
+
+
+/*
+ * Strict comparisons keep the first position of a repeated extreme. Written as "not less or equal" so that a NaN
+ * also takes the (rarely taken) branch and stops the scan, instead of paying for a separate test on every element.
+ */
+static inline void update(scan_t *s, double x, size_t i, bool do_min, bool do_max)
+{
+    if (do_min && !(x >= s->min.value)) {
+        s->nan = (x != x);
+        s->min.value = x;
+        s->min.index = i;
+    }
+    if (do_max && !(x <= s->max.value)) {
+        s->nan = s->nan || (x != x);
+        s->max.value = x;
+        s->max.index = i;
+    }
+}
+
+
+static void scan_start(scan_t *s, double x)
+{
+    s->min.value = x;
+    s->min.index = 0;
+    s->max = s->min;
+    s->nan = (x != x);
+}
+
+
+#ifdef __AVX2__
+typedef struct {
+    __m256d lo;
+    __m256d lo_idx;
+    __m256d hi;
+    __m256d hi_idx;
+    __m256d idx;
+    __m256d unord;
+} lanes_t;
+
+
+/* indices travel as doubles next to the values, so a single blend mask moves both; exact up to 2^53 */
+static inline void lanes_start(lanes_t *l, __m256d x)
+{
+    l->idx = _mm256_setr_pd(0, 1, 2, 3);
+    l->lo = x;
+    l->hi = x;
+    l->lo_idx = l->idx;
+    l->hi_idx = l->idx;
+    l->unord = _mm256_cmp_pd(x, x, _CMP_UNORD_Q);
+}
+
+
+static inline void lanes_update(lanes_t *l, __m256d x, bool do_min, bool do_max)
+{
+    __m256d mask;
+
+    l->idx = _mm256_add_pd(l->idx, _mm256_set1_pd(LANES));
+    l->unord = _mm256_or_pd(l->unord, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+    if (do_min) {
+        mask = _mm256_cmp_pd(x, l->lo, _CMP_LT_OQ);
+        l->lo = _mm256_blendv_pd(l->lo, x, mask);
+        l->lo_idx = _mm256_blendv_pd(l->lo_idx, l->idx, mask);
+    }
+    if (do_max) {
+        mask = _mm256_cmp_pd(x, l->hi, _CMP_GT_OQ);
+        l->hi = _mm256_blendv_pd(l->hi, x, mask);
+        l->hi_idx = _mm256_blendv_pd(l->hi_idx, l->idx, mask);
+    }
+}
+
+
+/* each lane holds the first extreme of its own positions: across lanes, equal values go to the smallest index */
+static void lanes_reduce(const lanes_t *l, scan_t *s)
+{
+    double lo[LANES];
+    double lo_idx[LANES];
+    double hi[LANES];
+    double hi_idx[LANES];
+
+    _mm256_storeu_pd(lo, l->lo);
+    _mm256_storeu_pd(lo_idx, l->lo_idx);
+    _mm256_storeu_pd(hi, l->hi);
+    _mm256_storeu_pd(hi_idx, l->hi_idx);
+
+    s->min.value = lo[0];
+    s->min.index = (size_t) lo_idx[0];
+    s->max.value = hi[0];
+    s->max.index = (size_t) hi_idx[0];
+    for (size_t k = 1; k < LANES; ++k) {
+        if ((lo[k] < s->min.value) || ((lo[k] == s->min.value) && ((size_t) lo_idx[k] < s->min.index))) {
+            s->min.value = lo[k];
+            s->min.index = (size_t) lo_idx[k];
+        }
+        if ((hi[k] > s->max.value) || ((hi[k] == s->max.value) && ((size_t) hi_idx[k] < s->max.index))) {
+            s->max.value = hi[k];
+            s->max.index = (size_t) hi_idx[k];
+        }
+    }
+    s->nan = !_mm256_testz_pd(l->unord, l->unord);
+}
+#endif
+
+
+static void scan(scan_t *s, const double v[], size_t length, bool do_min, bool do_max)
+{
+    size_t i = 1;
+
+#ifdef __AVX2__
+    lanes_t l;
+
+    if (length >= 2 * LANES) {
+        lanes_start(&l, _mm256_loadu_pd(v));
+        for (i = LANES; i + LANES <= length; i += LANES) {
+            lanes_update(&l, _mm256_loadu_pd(v + i), do_min, do_max);
+        }
+        lanes_reduce(&l, s);
+    } else {
+        scan_start(s, v[0]);
+    }
+#else
+    scan_start(s, v[0]);
+#endif
+
+    for (; !s->nan && (i < length); ++i) {
+        update(s, v[i], i, do_min, do_max);
+    }
+
+    /* rare case: the comparisons above ignored it, find the first one now */
+    if (s->nan) {
+        for (i = 0; v[i] == v[i]; ++i) ;
+        s->min.value = v[i];
+        s->min.index = i;
+        s->max = s->min;
+    }
+}
+
+
+static void scan_ptr(scan_t *s, double *const ptrs[], size_t length, bool do_min, bool do_max)
+{
+    size_t i = 1;
+
+#ifdef __AVX2__
+    lanes_t l;
+    __m256i p;
+
+    if (length >= 2 * LANES) {
+        /* the pointers are the gather offsets, from address 0 */
+        p = _mm256_loadu_si256((const __m256i *) ptrs);
+        lanes_start(&l, _mm256_i64gather_pd((const double *) 0, p, 1));
+        for (i = LANES; i + LANES <= length; i += LANES) {
+            if (i + PREFETCH_DISTANCE + LANES <= length) {
+                for (size_t k = 0; k < LANES; ++k) {
+                    _mm_prefetch((const char *) ptrs[i + PREFETCH_DISTANCE + k], _MM_HINT_T0);
+                }
+            }
+            p = _mm256_loadu_si256((const __m256i *) (ptrs + i));
+            lanes_update(&l, _mm256_i64gather_pd((const double *) 0, p, 1), do_min, do_max);
+        }
+        lanes_reduce(&l, s);
+    } else {
+        scan_start(s, *ptrs[0]);
+    }
+#else
+    scan_start(s, *ptrs[0]);
+#endif
+
+    for (; !s->nan && (i < length); ++i) {
+        if (i + PREFETCH_DISTANCE < length) {
+            __builtin_prefetch(ptrs[i + PREFETCH_DISTANCE]);
+        }
+        update(s, *ptrs[i], i, do_min, do_max);
+    }
+
+    if (s->nan) {
+        for (i = 0; *ptrs[i] == *ptrs[i]; ++i) ;
+        s->min.value = *ptrs[i];
+        s->min.index = i;
+        s->max = s->min;
+    }
+}
+
+
+status_t argmin(extremo_t *min, const double v[], size_t length)
+{
+    scan_t s;
+
+    if ((NULL == min) || (NULL == v)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    scan(&s, v, length, true, false);
+    *min = s.min;
+
+    return ST_OK;
+}
+
+
+status_t argmax(extremo_t *max, const double v[], size_t length)
+{
+    scan_t s;
+
+    if ((NULL == max) || (NULL == v)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    scan(&s, v, length, false, true);
+    *max = s.max;
+
+    return ST_OK;
+}
+
+
+status_t minmax(minmax_t *r, const double v[], size_t length)
+{
+    scan_t s;
+
+    if ((NULL == r) || (NULL == v)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    scan(&s, v, length, true, true);
+    r->min = s.min;
+    r->max = s.max;
+
+    return ST_OK;
+}
+
+
+status_t argmin_ptr(extremo_t *min, double *const ptrs[], size_t length)
+{
+    scan_t s;
+
+    if ((NULL == min) || (NULL == ptrs)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    scan_ptr(&s, ptrs, length, true, false);
+    *min = s.min;
+
+    return ST_OK;
+}
+
+
+status_t argmax_ptr(extremo_t *max, double *const ptrs[], size_t length)
+{
+    scan_t s;
+
+    if ((NULL == max) || (NULL == ptrs)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    scan_ptr(&s, ptrs, length, false, true);
+    *max = s.max;
+
+    return ST_OK;
+}
+
+
+status_t minmax_ptr(minmax_t *r, double *const ptrs[], size_t length)
+{
+    scan_t s;
+
+    if ((NULL == r) || (NULL == ptrs)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    scan_ptr(&s, ptrs, length, true, true);
+    r->min = s.min;
+    r->max = s.max;
+
+    return ST_OK;
+}
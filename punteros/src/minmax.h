@@ -0,0 +1,39 @@
+#pragma once
+#include "status.h"
+
+#include <stdlib.h>
+
+/*
+ * Mínimo, máximo y sus posiciones, en una única pasada.
+ *
+ * Las versiones para arreglos contiguos reciben `double v[]`; las versiones `_ptr` reciben un arreglo de punteros
+ * como el de la función `maximo` de ptr_array.c (ningún puntero puede ser NULL).
+ *
+ * - Si el valor extremo aparece varias veces, se devuelve la primera posición.
+ * - Si hay algún NaN, tanto el mínimo como el máximo son el primer NaN del arreglo y su posición (el resultado no
+ *   depende del orden en que se comparen los elementos).
+ * - `-0.0` y `0.0` son iguales: gana el que aparezca primero.
+ *
+ * Compilando con -mavx2 (o -march=native en una máquina que lo soporte) se usan instrucciones AVX2: de a 4 elementos
+ * para los arreglos contiguos y con lecturas `gather` y prefetch para los arreglos de punteros.
+ */
+
+typedef struct {
+    double value;
+    size_t index;
+} extremo_t;
+
+
+typedef struct {
+    extremo_t min;
+    extremo_t max;
+} minmax_t;
+
+
+status_t argmin(extremo_t *min, const double v[], size_t length);
+status_t argmax(extremo_t *max, const double v[], size_t length);
+status_t minmax(minmax_t *r, const double v[], size_t length);
+
+status_t argmin_ptr(extremo_t *min, double *const ptrs[], size_t length);
+status_t argmax_ptr(extremo_t *max, double *const ptrs[], size_t length);
+status_t minmax_ptr(minmax_t *r, double *const ptrs[], size_t length);
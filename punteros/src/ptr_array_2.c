@@ -51,7 +51,7 @@ int main (void)
 
 double traza(float **m, size_t filas, size_t columnas)
 {
-    double t;
+    double t = 0;
 
     if (filas == columnas) {
         for (size_t i = 0; i < filas; ++i) {
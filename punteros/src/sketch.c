@@ -0,0 +1,932 @@
+#include "status.h"
+#include "sketch.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KLL_MIN_K 8
+#define KLL_MIN_CAPACITY 2
+#define KLL_MIN_ALLOCATED 16
+#define KLL_SEED 0x9e3779b97f4a7c15ULL
+#define MAGIC_KLL 'K'
+#define MAGIC_HIST 'H'
+#define MAGIC_HDR 'R'
+#define FORMAT_VERSION 1
+
+
+/* writes past `size` (or to a NULL buffer) are only counted, to report how many bytes are needed */
+typedef struct {
+    unsigned char *buf;
+    size_t size;
+    size_t pos;
+} writer_t;
+
+
+/* reading past the end leaves ok false; the values read from then on are 0 */
+typedef struct {
+    const unsigned char *buf;
+    size_t size;
+    size_t pos;
+    bool ok;
+} reader_t;
+
+
+typedef struct {
+    double value;
+    uint64_t weight;
+} weighted_t;
+
+
+static void put_byte(writer_t *w, unsigned char b)
+{
+    if ((NULL != w->buf) && (w->pos < w->size)) {
+        w->buf[w->pos] = b;
+    }
+    w->pos++;
+}
+
+
+/* LEB128: 7 bits per byte, the high bit says another one follows; small counts take a single byte */
+static void put_varint(writer_t *w, uint64_t x)
+{
+    while (x >= 0x80) {
+        put_byte(w, (unsigned char) (x | 0x80));
+        x >>= 7;
+    }
+    put_byte(w, (unsigned char) x);
+}
+
+
+/* the bits of the double, least significant byte first whatever the machine */
+static void put_double(writer_t *w, double x)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &x, sizeof(bits));
+    for (unsigned i = 0; i < 8; ++i) {
+        put_byte(w, (unsigned char) (bits >> (8 * i)));
+    }
+}
+
+
+static status_t finish(const writer_t *w, size_t *size)
+{
+    bool fits = (w->pos <= w->size);
+
+    *size = w->pos;
+
+    return ((NULL == w->buf) || fits) ? ST_OK : ST_ERR_INVALID_ARG;
+}
+
+
+static unsigned char get_byte(reader_t *r)
+{
+    if (r->pos >= r->size) {
+        r->ok = false;
+        return 0;
+    }
+
+    return r->buf[r->pos++];
+}
+
+
+static uint64_t get_varint(reader_t *r)
+{
+    uint64_t x = 0;
+    unsigned char b;
+
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        b = get_byte(r);
+        x |= (uint64_t) (b & 0x7f) << shift;
+        if (0 == (b & 0x80)) {
+            return x;
+        }
+    }
+    r->ok = false;
+
+    return 0;
+}
+
+
+static double get_double(reader_t *r)
+{
+    uint64_t bits = 0;
+    double x;
+
+    for (unsigned i = 0; i < 8; ++i) {
+        bits |= (uint64_t) get_byte(r) << (8 * i);
+    }
+    memcpy(&x, &bits, sizeof(x));
+
+    return x;
+}
+
+
+/* what is left can hold at least n elements of `bytes` bytes each: guards the allocations of a corrupt input */
+static bool remaining(const reader_t *r, uint64_t n, size_t bytes)
+{
+    return r->ok && (n <= (r->size - r->pos) / bytes);
+}
+
+
+static bool valid_quantile(double q)
+{
+    return (q >= 0) && (q <= 1);
+}
+
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+static int compare_weighted(const void *a, const void *b)
+{
+    return compare_doubles(&((const weighted_t *) a)->value, &((const weighted_t *) b)->value);
+}
+
+
+static uint64_t next_random(uint64_t *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/*
+ * KLL keeps a stack of levels; an item at level h stands for 2^h of the input. The top level holds up to k items
+ * and each one below it, 2/3 of the one above (never less than KLL_MIN_CAPACITY).
+ */
+static size_t level_capacity(const kll_t *s, size_t h)
+{
+    size_t c = (size_t) ceil((double) s->k * pow(2.0 / 3.0, (double) (s->levels - 1 - h)));
+
+    return (c < KLL_MIN_CAPACITY) ? KLL_MIN_CAPACITY : c;
+}
+
+
+static size_t total_capacity(const kll_t *s)
+{
+    size_t total = 0;
+
+    for (size_t h = 0; h < s->levels; ++h) {
+        total += level_capacity(s, h);
+    }
+
+    return total;
+}
+
+
+static size_t retained(const kll_t *s)
+{
+    size_t total = 0;
+
+    for (size_t h = 0; h < s->levels; ++h) {
+        total += s->length[h];
+    }
+
+    return total;
+}
+
+
+static bool reserve_level(kll_t *s, size_t h, size_t n)
+{
+    size_t allocated = s->allocated[h] ? s->allocated[h] : KLL_MIN_ALLOCATED;
+    double *aux;
+
+    if (n > SIZE_MAX - s->length[h]) {
+        return false;
+    }
+    if (s->length[h] + n <= s->allocated[h]) {
+        return true;
+    }
+
+    while (allocated < s->length[h] + n) {
+        if (allocated > SIZE_MAX / 2 / sizeof(double)) {
+            return false;
+        }
+        allocated *= 2;
+    }
+    aux = (double *) realloc(s->items[h], allocated * sizeof(double));
+    if (NULL == aux) {
+        return false;
+    }
+    s->items[h] = aux;
+    s->allocated[h] = allocated;
+
+    return true;
+}
+
+
+/*
+ * Compacting a level sorts it and promotes every other item (starting at a random one of the first two) to the level
+ * above, where it weighs double. With an odd count the first item stays, so no weight is lost.
+ */
+static bool compact(kll_t *s, size_t h)
+{
+    size_t odd = s->length[h] % 2;
+    double *items = s->items[h];
+
+    if ((h + 1 == s->levels) && (KLL_MAX_LEVELS == s->levels)) {
+        return false;
+    }
+    if (h + 1 == s->levels) {
+        s->levels++;
+    }
+    if (!reserve_level(s, h + 1, s->length[h] / 2)) {
+        return false;
+    }
+
+    qsort(items, s->length[h], sizeof(double), compare_doubles);
+    for (size_t i = odd + (next_random(&s->random) & 1); i < s->length[h]; i += 2) {
+        s->items[h + 1][s->length[h + 1]++] = items[i];
+    }
+    s->length[h] = odd;
+
+    return true;
+}
+
+
+/* while the sketch holds more than its capacity, the lowest level that is over its own one is compacted */
+static bool compress(kll_t *s)
+{
+    size_t h;
+
+    while (retained(s) >= total_capacity(s)) {
+        for (h = 0; (h < s->levels) && (s->length[h] < level_capacity(s, h)); ++h) ;
+        if ((h == s->levels) || !compact(s, h)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+status_t kll_init(kll_t *s, size_t k)
+{
+    if (NULL == s) {
+        return ST_ERR_NULL_PTR;
+    }
+    if (k < KLL_MIN_K) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->k = k;
+    s->min = INFINITY;
+    s->max = -INFINITY;
+    s->random = KLL_SEED;
+    s->levels = 1;
+
+    return ST_OK;
+}
+
+
+void kll_free(kll_t *s)
+{
+    if (NULL != s) {
+        for (size_t h = 0; h < KLL_MAX_LEVELS; ++h) {
+            free(s->items[h]);
+            s->items[h] = NULL;
+            s->length[h] = 0;
+            s->allocated[h] = 0;
+        }
+        s->n = 0;
+    }
+}
+
+
+/* level 0 takes the input as it comes, up to what fits before the next compression */
+status_t kll_add(kll_t *s, const double v[], size_t length)
+{
+    size_t room;
+    size_t i = 0;
+
+    if ((NULL == s) || (NULL == v)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    while (i < length) {
+        room = total_capacity(s) - retained(s);
+        if (!reserve_level(s, 0, room)) {
+            return ST_ERR_UNKNOWN;
+        }
+        for (; (room > 0) && (i < length); ++i) {
+            if (isnan(v[i])) {
+                continue;
+            }
+            s->items[0][s->length[0]++] = v[i];
+            s->min = (v[i] < s->min) ? v[i] : s->min;
+            s->max = (v[i] > s->max) ? v[i] : s->max;
+            s->n++;
+            room--;
+        }
+        if ((0 == room) && !compress(s)) {
+            return ST_ERR_UNKNOWN;
+        }
+    }
+
+    return ST_OK;
+}
+
+
+status_t kll_merge(kll_t *s, const kll_t *other)
+{
+    if ((NULL == s) || (NULL == other)) {
+        return ST_ERR_NULL_PTR;
+    }
+    if (s == other) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    for (size_t h = 0; h < other->levels; ++h) {
+        if (!reserve_level(s, h, other->length[h])) {
+            return ST_ERR_UNKNOWN;
+        }
+        memcpy(s->items[h] + s->length[h], other->items[h], other->length[h] * sizeof(double));
+        s->length[h] += other->length[h];
+    }
+    s->levels = (other->levels > s->levels) ? other->levels : s->levels;
+    s->n += other->n;
+    s->min = (other->min < s->min) ? other->min : s->min;
+    s->max = (other->max > s->max) ? other->max : s->max;
+
+    return compress(s) ? ST_OK : ST_ERR_UNKNOWN;
+}
+
+
+/* every retained item with its weight, sorted: the rank of an item is the weight of the ones up to it */
+status_t kll_quantiles(const kll_t *s, const double q[], double out[], size_t m)
+{
+    weighted_t *all;
+    size_t n;
+    size_t j = 0;
+    uint64_t total;
+    double target;
+
+    if ((NULL == s) || (NULL == q) || (NULL == out)) {
+        return ST_ERR_NULL_PTR;
+    }
+    if (0 == s->n) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+    for (size_t i = 0; i < m; ++i) {
+        if (!valid_quantile(q[i])) {
+            return ST_ERR_INVALID_ARG;
+        }
+    }
+
+    n = retained(s);
+    all = (weighted_t *) malloc(n * sizeof(weighted_t));
+    if (NULL == all) {
+        return ST_ERR_UNKNOWN;
+    }
+    for (size_t h = 0; h < s->levels; ++h) {
+        for (size_t i = 0; i < s->length[h]; ++i, ++j) {
+            all[j].value = s->items[h][i];
+            all[j].weight = 1ULL << h;
+        }
+    }
+    qsort(all, n, sizeof(weighted_t), compare_weighted);
+
+    for (size_t i = 0; i < m; ++i) {
+        if ((0 == q[i]) || (1 == q[i])) {
+            out[i] = (0 == q[i]) ? s->min : s->max;
+            continue;
+        }
+        target = q[i] * (double) s->n;
+        total = 0;
+        for (j = 0; (j + 1 < n) && ((double) (total + all[j].weight) < target); ++j) {
+            total += all[j].weight;
+        }
+        out[i] = all[j].value;
+    }
+    free(all);
+
+    return ST_OK;
+}
+
+
+status_t kll_serialize(const kll_t *s, unsigned char *buf, size_t *size)
+{
+    writer_t w = {buf, 0, 0};
+
+    if ((NULL == s) || (NULL == size)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    w.size = *size;
+    put_byte(&w, MAGIC_KLL);
+    put_byte(&w, FORMAT_VERSION);
+    put_varint(&w, s->k);
+    put_varint(&w, s->n);
+    put_double(&w, s->min);
+    put_double(&w, s->max);
+    put_varint(&w, s->random);
+    put_varint(&w, s->levels);
+    for (size_t h = 0; h < s->levels; ++h) {
+        put_varint(&w, s->length[h]);
+        for (size_t i = 0; i < s->length[h]; ++i) {
+            put_double(&w, s->items[h][i]);
+        }
+    }
+
+    return finish(&w, size);
+}
+
+
+status_t kll_deserialize(kll_t *s, const unsigned char *buf, size_t size)
+{
+    reader_t r = {buf, size, 0, true};
+    uint64_t k;
+    uint64_t levels;
+    uint64_t length;
+    uint64_t weight = 0;
+
+    if ((NULL == s) || (NULL == buf)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if ((MAGIC_KLL != get_byte(&r)) || (FORMAT_VERSION != get_byte(&r))) {
+        return ST_ERR_INVALID_ARG;
+    }
+    k = get_varint(&r);
+    if (!r.ok || (k > SIZE_MAX) || (ST_OK != kll_init(s, (size_t) k))) {
+        return ST_ERR_INVALID_ARG;
+    }
+    s->n = get_varint(&r);
+    s->min = get_double(&r);
+    s->max = get_double(&r);
+    s->random = get_varint(&r);
+    levels = get_varint(&r);
+    if (!r.ok || (0 == levels) || (levels > KLL_MAX_LEVELS) || (0 == s->random)) {
+        return ST_ERR_INVALID_ARG;
+    }
+    s->levels = (size_t) levels;
+
+    for (size_t h = 0; h < s->levels; ++h) {
+        length = get_varint(&r);
+        if (!remaining(&r, length, 8)) {
+            kll_free(s);
+            return ST_ERR_INVALID_ARG;
+        }
+        if (!reserve_level(s, h, (size_t) length)) {
+            kll_free(s);
+            return ST_ERR_UNKNOWN;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            s->items[h][i] = get_double(&r);
+        }
+        s->length[h] = (size_t) length;
+        /* every item at level h stands for 2^h of the input */
+        if (length > (UINT64_MAX - weight) >> h) {
+            kll_free(s);
+            return ST_ERR_INVALID_ARG;
+        }
+        weight += length << h;
+    }
+
+    /*
+     * The levels have to be those of a sketch with this k: kll_add counts on some room being left. The weights must
+     * add up to n, and min and max must be ordered once there is data.
+     */
+    if ((retained(s) >= total_capacity(s)) || (s->n != weight) || ((0 != s->n) && !(s->min <= s->max))) {
+        kll_free(s);
+        return ST_ERR_INVALID_ARG;
+    }
+
+    return ST_OK;
+}
+
+
+status_t hist_init(hist_t *h, double lo, double hi, size_t buckets)
+{
+    if (NULL == h) {
+        return ST_ERR_NULL_PTR;
+    }
+    if (!(lo < hi) || !isfinite(hi - lo) || (0 == buckets) || (buckets > SIZE_MAX / sizeof(uint64_t) - 2)) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    /* counts[0] is for the values under lo and counts[buckets + 1] for those at hi or above */
+    h->counts = (uint64_t *) calloc(buckets + 2, sizeof(uint64_t));
+    if (NULL == h->counts) {
+        return ST_ERR_UNKNOWN;
+    }
+    h->lo = lo;
+    h->hi = hi;
+    h->buckets = buckets;
+    h->n = 0;
+    h->min = INFINITY;
+    h->max = -INFINITY;
+
+    return ST_OK;
+}
+
+
+void hist_free(hist_t *h)
+{
+    if (NULL != h) {
+        free(h->counts);
+        h->counts = NULL;
+        h->n = 0;
+    }
+}
+
+
+status_t hist_add(hist_t *h, const double v[], size_t length)
+{
+    double scale;
+    size_t b;
+
+    if ((NULL == h) || (NULL == h->counts) || (NULL == v)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    scale = (double) h->buckets / (h->hi - h->lo);
+    for (size_t i = 0; i < length; ++i) {
+        if (isnan(v[i])) {
+            continue;
+        }
+        if (v[i] < h->lo) {
+            b = 0;
+        } else if (v[i] >= h->hi) {
+            b = h->buckets + 1;
+        } else {
+            b = 1 + (size_t) ((v[i] - h->lo) * scale);
+            /* rounding can put a value just under hi one bucket too far */
+            b = (b > h->buckets) ? h->buckets : b;
+        }
+        h->counts[b]++;
+        h->min = (v[i] < h->min) ? v[i] : h->min;
+        h->max = (v[i] > h->max) ? v[i] : h->max;
+        h->n++;
+    }
+
+    return ST_OK;
+}
+
+
+status_t hist_merge(hist_t *h, const hist_t *other)
+{
+    if ((NULL == h) || (NULL == other) || (NULL == h->counts) || (NULL == other->counts)) {
+        return ST_ERR_NULL_PTR;
+    }
+    if ((h->lo != other->lo) || (h->hi != other->hi) || (h->buckets != other->buckets)) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    for (size_t b = 0; b < h->buckets + 2; ++b) {
+        h->counts[b] += other->counts[b];
+    }
+    h->n += other->n;
+    h->min = (other->min < h->min) ? other->min : h->min;
+    h->max = (other->max > h->max) ? other->max : h->max;
+
+    return ST_OK;
+}
+
+
+/* the values of a bucket are taken as evenly spread over it; the outer ones span up to the minimum and maximum */
+status_t hist_quantiles(const hist_t *h, const double q[], double out[], size_t m)
+{
+    double width;
+    double target;
+    double from;
+    double to;
+    uint64_t total;
+    size_t b;
+
+    if ((NULL == h) || (NULL == h->counts) || (NULL == q) || (NULL == out)) {
+        return ST_ERR_NULL_PTR;
+    }
+    if (0 == h->n) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+    for (size_t i = 0; i < m; ++i) {
+        if (!valid_quantile(q[i])) {
+            return ST_ERR_INVALID_ARG;
+        }
+    }
+
+    width = (h->hi - h->lo) / (double) h->buckets;
+    for (size_t i = 0; i < m; ++i) {
+        target = q[i] * (double) h->n;
+        total = 0;
+        for (b = 0; (b < h->buckets + 1) && ((double) (total + h->counts[b]) < target); ++b) {
+            total += h->counts[b];
+        }
+
+        if (0 == b) {
+            from = h->min;
+            to = h->lo;
+        } else if (h->buckets + 1 == b) {
+            from = h->hi;
+            to = h->max;
+        } else {
+            from = h->lo + (double) (b - 1) * width;
+            to = from + width;
+        }
+        out[i] = (0 == h->counts[b]) ? from : from + (to - from) * (target - (double) total) / (double) h->counts[b];
+        out[i] = (out[i] < h->min) ? h->min : (out[i] > h->max) ? h->max : out[i];
+    }
+
+    return ST_OK;
+}
+
+
+status_t hist_serialize(const hist_t *h, unsigned char *buf, size_t *size)
+{
+    writer_t w = {buf, 0, 0};
+
+    if ((NULL == h) || (NULL == h->counts) || (NULL == size)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    w.size = *size;
+    put_byte(&w, MAGIC_HIST);
+    put_byte(&w, FORMAT_VERSION);
+    put_double(&w, h->lo);
+    put_double(&w, h->hi);
+    put_varint(&w, h->buckets);
+    put_varint(&w, h->n);
+    put_double(&w, h->min);
+    put_double(&w, h->max);
+    for (size_t b = 0; b < h->buckets + 2; ++b) {
+        put_varint(&w, h->counts[b]);
+    }
+
+    return finish(&w, size);
+}
+
+
+status_t hist_deserialize(hist_t *h, const unsigned char *buf, size_t size)
+{
+    reader_t r = {buf, size, 0, true};
+    double lo;
+    double hi;
+    uint64_t buckets;
+    uint64_t total = 0;
+
+    if ((NULL == h) || (NULL == buf)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if ((MAGIC_HIST != get_byte(&r)) || (FORMAT_VERSION != get_byte(&r))) {
+        return ST_ERR_INVALID_ARG;
+    }
+    lo = get_double(&r);
+    hi = get_double(&r);
+    buckets = get_varint(&r);
+    /* every count takes at least one byte */
+    if (!remaining(&r, buckets, 1) || (ST_OK != hist_init(h, lo, hi, (size_t) buckets))) {
+        return ST_ERR_INVALID_ARG;
+    }
+    h->n = get_varint(&r);
+    h->min = get_double(&r);
+    h->max = get_double(&r);
+    for (size_t b = 0; b < h->buckets + 2; ++b) {
+        h->counts[b] = get_varint(&r);
+        total += h->counts[b];
+    }
+    if (!r.ok || (total != h->n)) {
+        hist_free(h);
+        return ST_ERR_INVALID_ARG;
+    }
+
+    return ST_OK;
+}
+
+
+/*
+ * Values under 2^bits have a bucket each. Above that, each power of two [2^e, 2^(e + 1)) is split in 2^(bits - 1)
+ * buckets of equal width: a bucket is never wider than 2^-(bits - 1) times its lower bound.
+ */
+static size_t hdr_index(unsigned bits, uint64_t v)
+{
+    unsigned shift;
+
+    if (v < (1ULL << bits)) {
+        return (size_t) v;
+    }
+    shift = (unsigned) (63 - __builtin_clzll(v)) - bits + 1;
+
+    return ((size_t) shift << (bits - 1)) + (size_t) (v >> shift);
+}
+
+
+/* the middle of the bucket, so that the error is at most half its width */
+static uint64_t hdr_value(unsigned bits, size_t index)
+{
+    unsigned shift;
+    uint64_t sub;
+
+    if (index < (1ULL << bits)) {
+        return index;
+    }
+    shift = (unsigned) (index >> (bits - 1)) - 1;
+    sub = index - ((size_t) shift << (bits - 1));
+
+    return (sub << shift) + ((1ULL << shift) - 1) / 2;
+}
+
+
+status_t hdr_init(hdr_t *h, unsigned bits)
+{
+    if (NULL == h) {
+        return ST_ERR_NULL_PTR;
+    }
+    if ((0 == bits) || (bits > HDR_MAX_BITS)) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    h->bits = bits;
+    h->buckets = (size_t) (66 - bits) << (bits - 1);
+    h->counts = (uint64_t *) calloc(h->buckets, sizeof(uint64_t));
+    if (NULL == h->counts) {
+        return ST_ERR_UNKNOWN;
+    }
+    h->n = 0;
+    h->min = UINT64_MAX;
+    h->max = 0;
+
+    return ST_OK;
+}
+
+
+void hdr_free(hdr_t *h)
+{
+    if (NULL != h) {
+        free(h->counts);
+        h->counts = NULL;
+        h->n = 0;
+    }
+}
+
+
+status_t hdr_add(hdr_t *h, const uint64_t v[], size_t length)
+{
+    uint64_t min;
+    uint64_t max;
+
+    if ((NULL == h) || (NULL == h->counts) || (NULL == v)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    min = h->min;
+    max = h->max;
+    for (size_t i = 0; i < length; ++i) {
+        h->counts[hdr_index(h->bits, v[i])]++;
+        min = (v[i] < min) ? v[i] : min;
+        max = (v[i] > max) ? v[i] : max;
+    }
+    h->min = min;
+    h->max = max;
+    h->n += length;
+
+    return ST_OK;
+}
+
+
+status_t hdr_merge(hdr_t *h, const hdr_t *other)
+{
+    if ((NULL == h) || (NULL == other) || (NULL == h->counts) || (NULL == other->counts)) {
+        return ST_ERR_NULL_PTR;
+    }
+    if (h->bits != other->bits) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    for (size_t b = 0; b < h->buckets; ++b) {
+        h->counts[b] += other->counts[b];
+    }
+    h->n += other->n;
+    h->min = (other->min < h->min) ? other->min : h->min;
+    h->max = (other->max > h->max) ? other->max : h->max;
+
+    return ST_OK;
+}
+
+
+status_t hdr_quantiles(const hdr_t *h, const double q[], uint64_t out[], size_t m)
+{
+    double target;
+    uint64_t total;
+    size_t b;
+
+    if ((NULL == h) || (NULL == h->counts) || (NULL == q) || (NULL == out)) {
+        return ST_ERR_NULL_PTR;
+    }
+    if (0 == h->n) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+    for (size_t i = 0; i < m; ++i) {
+        if (!valid_quantile(q[i])) {
+            return ST_ERR_INVALID_ARG;
+        }
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+        if ((0 == q[i]) || (1 == q[i])) {
+            out[i] = (0 == q[i]) ? h->min : h->max;
+            continue;
+        }
+        target = q[i] * (double) h->n;
+        total = 0;
+        for (b = 0; (b + 1 < h->buckets) && ((0 == h->counts[b]) || ((double) (total + h->counts[b]) < target));
+             ++b) {
+            total += h->counts[b];
+        }
+        out[i] = hdr_value(h->bits, b);
+        out[i] = (out[i] < h->min) ? h->min : (out[i] > h->max) ? h->max : out[i];
+    }
+
+    return ST_OK;
+}
+
+
+/* only the buckets in use: the distance to the previous one and the count, both as varints */
+status_t hdr_serialize(const hdr_t *h, unsigned char *buf, size_t *size)
+{
+    writer_t w = {buf, 0, 0};
+    size_t used = 0;
+    size_t previous = 0;
+
+    if ((NULL == h) || (NULL == h->counts) || (NULL == size)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    for (size_t b = 0; b < h->buckets; ++b) {
+        used += (0 != h->counts[b]);
+    }
+
+    w.size = *size;
+    put_byte(&w, MAGIC_HDR);
+    put_byte(&w, FORMAT_VERSION);
+    put_byte(&w, (unsigned char) h->bits);
+    put_varint(&w, h->n);
+    put_varint(&w, h->min);
+    put_varint(&w, h->max);
+    put_varint(&w, used);
+    for (size_t b = 0; b < h->buckets; ++b) {
+        if (0 != h->counts[b]) {
+            put_varint(&w, b - previous);
+            put_varint(&w, h->counts[b]);
+            previous = b;
+        }
+    }
+
+    return finish(&w, size);
+}
+
+
+status_t hdr_deserialize(hdr_t *h, const unsigned char *buf, size_t size)
+{
+    reader_t r = {buf, size, 0, true};
+    uint64_t used;
+    uint64_t gap;
+    uint64_t b = 0;
+    uint64_t total = 0;
+
+    if ((NULL == h) || (NULL == buf)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if ((MAGIC_HDR != get_byte(&r)) || (FORMAT_VERSION != get_byte(&r))) {
+        return ST_ERR_INVALID_ARG;
+    }
+    if (ST_OK != hdr_init(h, get_byte(&r))) {
+        return ST_ERR_INVALID_ARG;
+    }
+    h->n = get_varint(&r);
+    h->min = get_varint(&r);
+    h->max = get_varint(&r);
+    used = get_varint(&r);
+    for (uint64_t i = 0; r.ok && (i < used); ++i) {
+        gap = get_varint(&r);
+        b += gap;
+        if ((b >= h->buckets) || ((0 != i) && (0 == gap))) {
+            r.ok = false;
+            break;
+        }
+        h->counts[b] = get_varint(&r);
+        total += h->counts[b];
+    }
+    if (!r.ok || (total != h->n)) {
+        hdr_free(h);
+        return ST_ERR_INVALID_ARG;
+    }
+
+    return ST_OK;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "status.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Cuantiles e histogramas de un flujo de datos, en memoria acotada.
+ *
+ * Calcular la mediana o el percentil 99 de forma exacta requiere guardar y ordenar todos los datos. Los resúmenes
+ * (sketches) de este módulo se alimentan de a bloques (sin guardar los datos), ocupan una cantidad de memoria que no
+ * depende (o depende muy poco) de cuántos datos recibieron, se pueden combinar (merge: el resumen de dos partes es el
+ * resumen del total, por ejemplo uno por hilo) y se pueden serializar en pocos bytes para guardarlos o enviarlos.
+ *
+ * -   kll_t (Karnin, Lang y Liberty): cuantiles de doubles con error en el rango de aproximadamente 1.7 / k (con
+ *     k = 200, menos del 1%: el valor devuelto para p99 está entre el p98.2 y el p99.8 reales). Ocupa unos 3k doubles.
+ *     Los NaN se ignoran.
+ * -   hist_t: histograma de `buckets` intervalos iguales entre `lo` y `hi`, más uno por debajo y otro por encima.
+ *     Los cuantiles se interpolan dentro del intervalo: el error es a lo sumo el ancho de un intervalo.
+ * -   hdr_t: histograma logarítmico de enteros no negativos (por ejemplo, latencias en nanosegundos), como
+ *     HdrHistogram. Cubre de 0 a UINT64_MAX con error relativo de a lo sumo 2^-bits en cada cuantil; con bits = 8
+ *     (0.4%) ocupa 58 KB.
+ *
+ * Los cuantiles se piden de a varios (q entre 0 y 1, en cualquier orden): kll_quantiles ordena el resumen una única
+ * vez para todos. Para q = 0 y q = 1 se devuelven el mínimo y el máximo exactos.
+ *
+ * *_serialize escribe en buf a lo sumo *size bytes y deja en *size los que usó; si buf es NULL o no alcanza, sólo
+ * calcula cuántos hacen falta (y en el segundo caso devuelve ST_ERR_INVALID_ARG). El formato es el mismo en cualquier
+ * máquina. Todas las funciones que reservan memoria devuelven ST_ERR_UNKNOWN si no la consiguen.
+ */
+
+#define KLL_DEFAULT_K 200
+#define KLL_MAX_LEVELS 60
+#define HDR_MAX_BITS 16
+
+
+typedef struct {
+    size_t k;
+    uint64_t n;
+    double min;
+    double max;
+    uint64_t random;
+    size_t levels;
+    double *items[KLL_MAX_LEVELS];
+    size_t length[KLL_MAX_LEVELS];
+    size_t allocated[KLL_MAX_LEVELS];
+} kll_t;
+
+
+typedef struct {
+    double lo;
+    double hi;
+    size_t buckets;
+    uint64_t *counts;
+    uint64_t n;
+    double min;
+    double max;
+} hist_t;
+
+
+typedef struct {
+    unsigned bits;
+    size_t buckets;
+    uint64_t *counts;
+    uint64_t n;
+    uint64_t min;
+    uint64_t max;
+} hdr_t;
+
+
+status_t kll_init(kll_t *s, size_t k);
+void kll_free(kll_t *s);
+status_t kll_add(kll_t *s, const double v[], size_t length);
+status_t kll_merge(kll_t *s, const kll_t *other);
+status_t kll_quantiles(const kll_t *s, const double q[], double out[], size_t m);
+status_t kll_serialize(const kll_t *s, unsigned char *buf, size_t *size);
+status_t kll_deserialize(kll_t *s, const unsigned char *buf, size_t size);
+
+status_t hist_init(hist_t *h, double lo, double hi, size_t buckets);
+void hist_free(hist_t *h);
+status_t hist_add(hist_t *h, const double v[], size_t length);
+/* sólo histogramas con los mismos lo, hi y buckets */
+status_t hist_merge(hist_t *h, const hist_t *other);
+status_t hist_quantiles(const hist_t *h, const double q[], double out[], size_t m);
+status_t hist_serialize(const hist_t *h, unsigned char *buf, size_t *size);
+status_t hist_deserialize(hist_t *h, const unsigned char *buf, size_t size);
+
+status_t hdr_init(hdr_t *h, unsigned bits);
+void hdr_free(hdr_t *h);
+status_t hdr_add(hdr_t *h, const uint64_t v[], size_t length);
+/* sólo histogramas con los mismos bits */
+status_t hdr_merge(hdr_t *h, const hdr_t *other);
+status_t hdr_quantiles(const hdr_t *h, const double q[], uint64_t out[], size_t m);
+status_t hdr_serialize(const hdr_t *h, unsigned char *buf, size_t *size);
+status_t hdr_deserialize(hdr_t *h, const unsigned char *buf, size_t size);
@@ -0,0 +1,11 @@
+#include "status.h"
+#include "stats.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+STATS_DEFINE(float, f32, double)
+STATS_DEFINE(int32_t, i32, int64_t)
+STATS_DEFINE(int64_t, i64, stats_i128_t)
+STATS_DEFINE(uint16_t, u16, uint64_t)
@@ -0,0 +1,224 @@
+#pragma once
+#include "status.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Estadísticas (suma, media, varianza, mínimo y máximo) para arreglos de float, int32_t, int64_t y uint16_t, sin
+ * convertirlos antes a double.
+ *
+ * STATS_DECLARE(T, name, ACC) declara las funciones stats_<operación>_name; STATS_DEFINE(T, name, ACC) las implementa
+ * acumulando en ACC, un tipo más ancho que T para que la suma no desborde ni pierda precisión:
+ *
+ * | T        | name | ACC      |
+ * |----------|------|----------|
+ * | float    | f32  | double   |
+ * | int32_t  | i32  | int64_t  |
+ * | int64_t  | i64  | __int128 |
+ * | uint16_t | u16  | uint64_t |
+ *
+ * Los ciclos mantienen STATS_LANES acumuladores independientes, lo que le permite al compilador usar instrucciones
+ * SIMD (con -O3) sin cambiar el resultado según la máquina.
+ *
+ * La varianza es la poblacional (se divide por `length`) y se calcula en dos pasadas, en double. Con float, los NaN
+ * se propagan a la suma, la media y la varianza, pero el mínimo y el máximo no los tienen en cuenta salvo que esté en
+ * la primera posición.
+ *
+ * stats_sum, stats_mean, stats_var, stats_min y stats_max eligen la versión según el tipo del arreglo (_Generic).
+ */
+
+#define STATS_LANES 8
+
+__extension__ typedef __int128 stats_i128_t;
+
+
+#define STATS_DECLARE(T, name, ACC)                                                                                 \
+status_t stats_sum_##name(ACC *sum, const T v[], size_t length);                                                    \
+status_t stats_mean_##name(double *mean, const T v[], size_t length);                                               \
+status_t stats_var_##name(double *var, const T v[], size_t length);                                                 \
+status_t stats_min_##name(T *min, const T v[], size_t length);                                                      \
+status_t stats_max_##name(T *max, const T v[], size_t length);
+
+
+#define STATS_DEFINE(T, name, ACC)                                                                                  \
+/* the lanes are independent chains: the compiler can keep them in one vector register */                           \
+static ACC stats_accumulate_##name(const T v[], size_t length)                                                      \
+{                                                                                                                   \
+    ACC lanes[STATS_LANES] = {0};                                                                                   \
+    ACC total = 0;                                                                                                  \
+    size_t i = 0;                                                                                                   \
+                                                                                                                    \
+    for (; i + STATS_LANES <= length; i += STATS_LANES) {                                                           \
+        for (size_t k = 0; k < STATS_LANES; ++k) {                                                                  \
+            lanes[k] += (ACC) v[i + k];                                                                             \
+        }                                                                                                           \
+    }                                                                                                               \
+    for (size_t k = 0; k < STATS_LANES; ++k) {                                                                      \
+        total += lanes[k];                                                                                          \
+    }                                                                                                               \
+    for (; i < length; ++i) {                                                                                       \
+        total += (ACC) v[i];                                                                                        \
+    }                                                                                                               \
+                                                                                                                    \
+    return total;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static double stats_deviation_##name(const T v[], size_t length, double mean)                                       \
+{                                                                                                                   \
+    double lanes[STATS_LANES] = {0};                                                                                \
+    double total = 0;                                                                                               \
+    double d;                                                                                                       \
+    size_t i = 0;                                                                                                   \
+                                                                                                                    \
+    for (; i + STATS_LANES <= length; i += STATS_LANES) {                                                           \
+        for (size_t k = 0; k < STATS_LANES; ++k) {                                                                  \
+            d = (double) v[i + k] - mean;                                                                           \
+            lanes[k] += d * d;                                                                                      \
+        }                                                                                                           \
+    }                                                                                                               \
+    for (size_t k = 0; k < STATS_LANES; ++k) {                                                                      \
+        total += lanes[k];                                                                                          \
+    }                                                                                                               \
+    for (; i < length; ++i) {                                                                                       \
+        d = (double) v[i] - mean;                                                                                   \
+        total += d * d;                                                                                             \
+    }                                                                                                               \
+                                                                                                                    \
+    return total;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+status_t stats_sum_##name(ACC *sum, const T v[], size_t length)                                                     \
+{                                                                                                                   \
+    if ((NULL == sum) || (NULL == v)) {                                                                             \
+        return ST_ERR_NULL_PTR;                                                                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    *sum = stats_accumulate_##name(v, length);                                                                      \
+                                                                                                                    \
+    return ST_OK;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+status_t stats_mean_##name(double *mean, const T v[], size_t length)                                                \
+{                                                                                                                   \
+    if ((NULL == mean) || (NULL == v)) {                                                                            \
+        return ST_ERR_NULL_PTR;                                                                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    if (0 == length) {                                                                                              \
+        return ST_ERR_LZERO_ARRAY;                                                                                  \
+    }                                                                                                               \
+                                                                                                                    \
+    *mean = (double) stats_accumulate_##name(v, length) / length;                                                   \
+                                                                                                                    \
+    return ST_OK;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+status_t stats_var_##name(double *var, const T v[], size_t length)                                                  \
+{                                                                                                                   \
+    double mean;                                                                                                    \
+                                                                                                                    \
+    if ((NULL == var) || (NULL == v)) {                                                                             \
+        return ST_ERR_NULL_PTR;                                                                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    if (0 == length) {                                                                                              \
+        return ST_ERR_LZERO_ARRAY;                                                                                  \
+    }                                                                                                               \
+                                                                                                                    \
+    mean = (double) stats_accumulate_##name(v, length) / length;                                                    \
+    *var = stats_deviation_##name(v, length, mean) / length;                                                        \
+                                                                                                                    \
+    return ST_OK;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+status_t stats_min_##name(T *min, const T v[], size_t length)                                                       \
+{                                                                                                                   \
+    T lanes[STATS_LANES];                                                                                           \
+    T m;                                                                                                            \
+    size_t i = 0;                                                                                                   \
+                                                                                                                    \
+    if ((NULL == min) || (NULL == v)) {                                                                             \
+        return ST_ERR_NULL_PTR;                                                                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    if (0 == length) {                                                                                              \
+        return ST_ERR_LZERO_ARRAY;                                                                                  \
+    }                                                                                                               \
+                                                                                                                    \
+    for (size_t k = 0; k < STATS_LANES; ++k) {                                                                      \
+        lanes[k] = v[0];                                                                                            \
+    }                                                                                                               \
+    for (; i + STATS_LANES <= length; i += STATS_LANES) {                                                           \
+        for (size_t k = 0; k < STATS_LANES; ++k) {                                                                  \
+            lanes[k] = (v[i + k] < lanes[k]) ? v[i + k] : lanes[k];                                                 \
+        }                                                                                                           \
+    }                                                                                                               \
+    m = lanes[0];                                                                                                   \
+    for (size_t k = 1; k < STATS_LANES; ++k) {                                                                      \
+        m = (lanes[k] < m) ? lanes[k] : m;                                                                          \
+    }                                                                                                               \
+    for (; i < length; ++i) {                                                                                       \
+        m = (v[i] < m) ? v[i] : m;                                                                                  \
+    }                                                                                                               \
+    *min = m;                                                                                                       \
+                                                                                                                    \
+    return ST_OK;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+status_t stats_max_##name(T *max, const T v[], size_t length)                                                       \
+{                                                                                                                   \
+    T lanes[STATS_LANES];                                                                                           \
+    T m;                                                                                                            \
+    size_t i = 0;                                                                                                   \
+                                                                                                                    \
+    if ((NULL == max) || (NULL == v)) {                                                                             \
+        return ST_ERR_NULL_PTR;                                                                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    if (0 == length) {                                                                                              \
+        return ST_ERR_LZERO_ARRAY;                                                                                  \
+    }                                                                                                               \
+                                                                                                                    \
+    for (size_t k = 0; k < STATS_LANES; ++k) {                                                                      \
+        lanes[k] = v[0];                                                                                            \
+    }                                                                                                               \
+    for (; i + STATS_LANES <= length; i += STATS_LANES) {                                                           \
+        for (size_t k = 0; k < STATS_LANES; ++k) {                                                                  \
+            lanes[k] = (v[i + k] > lanes[k]) ? v[i + k] : lanes[k];                                                 \
+        }                                                                                                           \
+    }                                                                                                               \
+    m = lanes[0];                                                                                                   \
+    for (size_t k = 1; k < STATS_LANES; ++k) {                                                                      \
+        m = (lanes[k] > m) ? lanes[k] : m;                                                                          \
+    }                                                                                                               \
+    for (; i < length; ++i) {                                                                                       \
+        m = (v[i] > m) ? v[i] : m;                                                                                  \
+    }                                                                                                               \
+    *max = m;                                                                                                       \
+                                                                                                                    \
+    return ST_OK;                                                                                                   \
+}
+
+
+STATS_DECLARE(float, f32, double)
+STATS_DECLARE(int32_t, i32, int64_t)
+STATS_DECLARE(int64_t, i64, stats_i128_t)
+STATS_DECLARE(uint16_t, u16, uint64_t)
+
+
+#define STATS_SELECT(fn, v) _Generic((v),                                                                           \
+    float *: fn##_f32,                                                                                              \
+    const float *: fn##_f32,                                                                                        \
+    int32_t *: fn##_i32,                                                                                            \
+    const int32_t *: fn##_i32,                                                                                      \
+    int64_t *: fn##_i64,                                                                                            \
+    const int64_t *: fn##_i64,                                                                                      \
+    uint16_t *: fn##_u16,                                                                                           \
+    const uint16_t *: fn##_u16)
+
+#define stats_sum(sum, v, length) STATS_SELECT(stats_sum, v)(sum, v, length)
+#define stats_mean(mean, v, length) STATS_SELECT(stats_mean, v)(mean, v, length)
+#define stats_var(var, v, length) STATS_SELECT(stats_var, v)(var, v, length)
+#define stats_min(min, v, length) STATS_SELECT(stats_min, v)(min, v, length)
+#define stats_max(max, v, length) STATS_SELECT(stats_max, v)(max, v, length)
@@ -0,0 +1,241 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "status.h"
+#include "meand.h"
+#include "sketch.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Latencias simuladas (log-normales, en nanosegundos) repartidas entre HILOS hilos: cada uno arma sus resúmenes de a
+ * bloques, se combinan y se comparan los percentiles con los exactos (ordenando todo) y la media con meand.
+ *
+ * $ gcc -std=c17 -Wall -pedantic -O2 -pthread -o test_sketch test_sketch.c sketch.c meand_st.c -lm
+ * $ ./test_sketch
+ */
+
+#define MUESTRAS 4000000
+#define HILOS 4
+#define BLOQUE 4096
+#define HIST_MAX 2e6
+#define HIST_BUCKETS 2000
+#define HDR_BITS 8
+
+
+typedef struct {
+    const double *v;
+    size_t n;
+    kll_t kll;
+    hist_t hist;
+    hdr_t hdr;
+    status_t st;
+} parte_t;
+
+
+static int comparar(const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+static void *resumir(void *arg)
+{
+    parte_t *p = (parte_t *) arg;
+    uint64_t enteros[BLOQUE];
+    size_t n;
+
+    p->st = kll_init(&p->kll, KLL_DEFAULT_K);
+    if (ST_OK == p->st) {
+        p->st = hist_init(&p->hist, 0, HIST_MAX, HIST_BUCKETS);
+    }
+    if (ST_OK == p->st) {
+        p->st = hdr_init(&p->hdr, HDR_BITS);
+    }
+
+    for (size_t i = 0; (ST_OK == p->st) && (i < p->n); i += BLOQUE) {
+        n = (p->n - i < BLOQUE) ? p->n - i : BLOQUE;
+        for (size_t j = 0; j < n; ++j) {
+            enteros[j] = (uint64_t) p->v[i + j];
+        }
+        p->st = kll_add(&p->kll, p->v + i, n);
+        if (ST_OK == p->st) {
+            p->st = hist_add(&p->hist, p->v + i, n);
+        }
+        if (ST_OK == p->st) {
+            p->st = hdr_add(&p->hdr, enteros, n);
+        }
+    }
+
+    return NULL;
+}
+
+
+static unsigned long siguiente(unsigned long *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return *x;
+}
+
+
+/* serializes and reads back, so what is printed has gone through the compact format */
+static status_t ida_y_vuelta(parte_t *p, size_t tamanos[3])
+{
+    unsigned char *buf;
+    size_t size;
+    status_t st;
+
+    size = 0;
+    kll_serialize(&p->kll, NULL, &size);
+    tamanos[0] = size;
+    hist_serialize(&p->hist, NULL, &size);
+    tamanos[1] = size;
+    hdr_serialize(&p->hdr, NULL, &size);
+    tamanos[2] = size;
+
+    buf = (unsigned char *) malloc(tamanos[0] + tamanos[1] + tamanos[2]);
+    if (NULL == buf) {
+        return ST_ERR_UNKNOWN;
+    }
+
+    size = tamanos[0];
+    st = kll_serialize(&p->kll, buf, &size);
+    if (ST_OK == st) {
+        size = tamanos[1];
+        st = hist_serialize(&p->hist, buf + tamanos[0], &size);
+    }
+    if (ST_OK == st) {
+        size = tamanos[2];
+        st = hdr_serialize(&p->hdr, buf + tamanos[0] + tamanos[1], &size);
+    }
+    kll_free(&p->kll);
+    hist_free(&p->hist);
+    hdr_free(&p->hdr);
+    if (ST_OK == st) {
+        st = kll_deserialize(&p->kll, buf, tamanos[0]);
+    }
+    if (ST_OK == st) {
+        st = hist_deserialize(&p->hist, buf + tamanos[0], tamanos[1]);
+    }
+    if (ST_OK == st) {
+        st = hdr_deserialize(&p->hdr, buf + tamanos[0] + tamanos[1], tamanos[2]);
+    }
+    free(buf);
+
+    return st;
+}
+
+
+int main(void)
+{
+    const double q[] = {0, 0.5, 0.9, 0.99, 0.999, 1};
+    const size_t m = sizeof(q) / sizeof(q[0]);
+    double *v = (double *) malloc(MUESTRAS * sizeof(double));
+    double *ordenado = (double *) malloc(MUESTRAS * sizeof(double));
+    unsigned long semilla = 88172645463325252UL;
+    parte_t partes[HILOS];
+    pthread_t hilos[HILOS];
+    bool lanzado[HILOS];
+    size_t tamanos[3];
+    double kll[sizeof(q) / sizeof(q[0])];
+    double hist[sizeof(q) / sizeof(q[0])];
+    uint64_t hdr[sizeof(q) / sizeof(q[0])];
+    double u1;
+    double u2;
+    double exacto;
+    double mean;
+    status_t st = ST_OK;
+
+    if ((NULL == v) || (NULL == ordenado)) {
+        fprintf(stderr, "No hay memoria para la prueba\n");
+        free(v);
+        free(ordenado);
+        return EXIT_FAILURE;
+    }
+
+    /* Box-Muller: median around 50 us, with a long tail */
+    for (size_t i = 0; i < MUESTRAS; ++i) {
+        u1 = ((double) (siguiente(&semilla) >> 11) + 1) / (1UL << 53);
+        u2 = (double) (siguiente(&semilla) >> 11) / (1UL << 53);
+        v[i] = floor(exp(log(50000) + 0.8 * sqrt(-2 * log(u1)) * cos(2 * acos(-1) * u2)));
+    }
+
+    for (size_t h = 0; h < HILOS; ++h) {
+        partes[h].v = v + h * (MUESTRAS / HILOS);
+        partes[h].n = (HILOS - 1 == h) ? MUESTRAS - h * (MUESTRAS / HILOS) : MUESTRAS / HILOS;
+        lanzado[h] = (0 == pthread_create(&hilos[h], NULL, resumir, &partes[h]));
+        if (!lanzado[h]) {
+            resumir(&partes[h]);
+        }
+    }
+    for (size_t h = 0; h < HILOS; ++h) {
+        if (lanzado[h]) {
+            pthread_join(hilos[h], NULL);
+        }
+        st = (ST_OK == st) ? partes[h].st : st;
+    }
+
+    for (size_t h = 1; (ST_OK == st) && (h < HILOS); ++h) {
+        st = kll_merge(&partes[0].kll, &partes[h].kll);
+        if (ST_OK == st) {
+            st = hist_merge(&partes[0].hist, &partes[h].hist);
+        }
+        if (ST_OK == st) {
+            st = hdr_merge(&partes[0].hdr, &partes[h].hdr);
+        }
+    }
+    if (ST_OK == st) {
+        st = ida_y_vuelta(&partes[0], tamanos);
+    }
+    if (ST_OK == st) {
+        st = kll_quantiles(&partes[0].kll, q, kll, m);
+    }
+    if (ST_OK == st) {
+        st = hist_quantiles(&partes[0].hist, q, hist, m);
+    }
+    if (ST_OK == st) {
+        st = hdr_quantiles(&partes[0].hdr, q, hdr, m);
+    }
+    if ((ST_OK != st) || (ST_OK != meand(&mean, v, MUESTRAS))) {
+        fprintf(stderr, "Ocurrió un error inesperado (%d)\n", (int) st);
+    } else {
+        memcpy(ordenado, v, MUESTRAS * sizeof(double));
+        qsort(ordenado, MUESTRAS, sizeof(double), comparar);
+
+        printf("%d muestras en %d hilos, media (meand): %.1f ns\n", MUESTRAS, HILOS, mean);
+        printf("bytes serializados: kll %zu, hist %zu, hdr %zu (los datos: %zu)\n\n", tamanos[0], tamanos[1],
+               tamanos[2], MUESTRAS * sizeof(double));
+        printf("%8s %12s %12s %12s %12s\n", "cuantil", "exacto", "kll", "hist", "hdr");
+        for (size_t i = 0; i < m; ++i) {
+            exacto = ordenado[(size_t) ceil(q[i] * MUESTRAS) - (q[i] > 0)];
+            printf("%8g %12.0f %12.0f %12.0f %12llu\n", q[i], exacto, kll[i], hist[i], (unsigned long long) hdr[i]);
+        }
+    }
+
+    puts("\nPrueba con un resumen vacío:");
+    kll_free(&partes[1].kll);
+    if (ST_OK != kll_quantiles(&partes[1].kll, q, kll, m)) {
+        fprintf(stderr, "\tNo se pudieron calcular los cuantiles (posiblemente no tenga datos)\n");
+    }
+
+    for (size_t h = 0; h < HILOS; ++h) {
+        kll_free(&partes[h].kll);
+        hist_free(&partes[h].hist);
+        hdr_free(&partes[h].hdr);
+    }
+    free(v);
+    free(ordenado);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include "status.h"
+#include "stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MUCHOS 10000000
+
+int main(void)
+{
+    float array[] = {34.2f, 97.01f, 0.0003f, 1092.7f, 5.0f, -12.5f, 3.25f, 0.5f, 7.0f};
+    size_t length = sizeof(array) / sizeof(array[0]);
+    float *unos;
+    double sum;
+    double mean;
+    double var;
+    float min;
+    float max;
+
+    puts("Prueba con valores típicos:");
+    if ((ST_OK != stats_sum(&sum, array, length)) || (ST_OK != stats_mean(&mean, array, length))
+        || (ST_OK != stats_var(&var, array, length)) || (ST_OK != stats_min(&min, array, length))
+        || (ST_OK != stats_max(&max, array, length))) {
+        fprintf(stderr, "Ocurrió un error inesperado\n");
+    } else {
+        printf("\tSum: %.4f\n\tMean: %.4f\n\tVar: %.4f\n\tMin: %.4f\n\tMax: %.4f\n", sum, mean, var, min, max);
+    }
+
+    puts("Prueba con muchos valores (el acumulador es double):");
+    unos = (float *) malloc(MUCHOS * sizeof(float));
+    if (NULL == unos) {
+        fprintf(stderr, "\tNo hay memoria para la prueba\n");
+    } else {
+        for (size_t i = 0; i < MUCHOS; ++i) {
+            unos[i] = 0.1f;
+        }
+        if (ST_OK != stats_mean(&mean, unos, MUCHOS)) {
+            fprintf(stderr, "Ocurrió un error inesperado\n");
+        } else {
+            printf("\tMean: %.7f (con un acumulador float daría lejos de 0.1)\n", mean);
+        }
+        free(unos);
+    }
+
+    puts("Prueba con arreglo de largo 0:");
+    if (ST_OK != stats_mean(&mean, array, 0)) {
+        fprintf(stderr, "\tNo se pudo calcular la media (posiblemente el largo 0 tenga algo que ver)\n");
+    } else {
+        printf("\tMean: %.4f\n", mean);
+    }
+
+    puts("Prueba con arreglo NULL:");
+    if (ST_OK != stats_var_f32(&var, NULL, length)) {
+        fprintf(stderr, "\tNo se pudo calcular la varianza (posiblemente el puntero nulo tenga algo que ver)\n");
+    } else {
+        printf("\tVar: %.4f\n", var);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,51 @@
+#include "status.h"
+#include "stats.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(void)
+{
+    int32_t array[] = {-7, 3, 12, 0, 5, 5, -20, 41, 9, 2};
+    int32_t grandes[] = {INT32_MAX, INT32_MAX, INT32_MAX, INT32_MIN, INT32_MAX};
+    size_t length = sizeof(array) / sizeof(array[0]);
+    int64_t sum;
+    double mean;
+    double var;
+    int32_t min;
+    int32_t max;
+
+    puts("Prueba con valores típicos:");
+    if ((ST_OK != stats_sum(&sum, array, length)) || (ST_OK != stats_mean(&mean, array, length))
+        || (ST_OK != stats_var(&var, array, length)) || (ST_OK != stats_min(&min, array, length))
+        || (ST_OK != stats_max(&max, array, length))) {
+        fprintf(stderr, "Ocurrió un error inesperado\n");
+    } else {
+        printf("\tSum: %lld\n\tMean: %.4f\n\tVar: %.4f\n", (long long) sum, mean, var);
+        printf("\tMin: %ld\n\tMax: %ld\n", (long) min, (long) max);
+    }
+
+    puts("Prueba con valores cuya suma no entra en 32 bits:");
+    if (ST_OK != stats_sum(&sum, grandes, sizeof(grandes) / sizeof(grandes[0]))) {
+        fprintf(stderr, "Ocurrió un error inesperado\n");
+    } else {
+        printf("\tSum: %lld\n", (long long) sum);
+    }
+
+    puts("Prueba con arreglo de largo 0:");
+    if (ST_OK != stats_min(&min, array, 0)) {
+        fprintf(stderr, "\tNo se pudo calcular el mínimo (posiblemente el largo 0 tenga algo que ver)\n");
+    } else {
+        printf("\tMin: %ld\n", (long) min);
+    }
+
+    puts("Prueba con arreglo NULL:");
+    if (ST_OK != stats_mean_i32(&mean, NULL, length)) {
+        fprintf(stderr, "\tNo se pudo calcular la media (posiblemente el puntero nulo tenga algo que ver)\n");
+    } else {
+        printf("\tMean: %.4f\n", mean);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#include "status.h"
+#include "stats.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(void)
+{
+    int64_t array[] = {-7000000000, 3, 12, 0, 5000000000, 5, -20, 41, 9, 2};
+    int64_t grandes[] = {INT64_MAX, INT64_MAX, INT64_MAX, 1};
+    size_t length = sizeof(array) / sizeof(array[0]);
+    stats_i128_t sum;
+    double mean;
+    double var;
+    int64_t min;
+    int64_t max;
+
+    puts("Prueba con valores típicos:");
+    if ((ST_OK != stats_sum(&sum, array, length)) || (ST_OK != stats_mean(&mean, array, length))
+        || (ST_OK != stats_var(&var, array, length)) || (ST_OK != stats_min(&min, array, length))
+        || (ST_OK != stats_max(&max, array, length))) {
+        fprintf(stderr, "Ocurrió un error inesperado\n");
+    } else {
+        printf("\tSum: %lld\n\tMean: %.4f\n\tVar: %.6g\n", (long long) sum, mean, var);
+        printf("\tMin: %lld\n\tMax: %lld\n", (long long) min, (long long) max);
+    }
+
+    /* the sum does not fit in 64 bits: it is printed as a double */
+    puts("Prueba con valores cuya suma no entra en 64 bits:");
+    if ((ST_OK != stats_sum(&sum, grandes, sizeof(grandes) / sizeof(grandes[0])))
+        || (ST_OK != stats_mean(&mean, grandes, sizeof(grandes) / sizeof(grandes[0])))) {
+        fprintf(stderr, "Ocurrió un error inesperado\n");
+    } else {
+        printf("\tSum: %.6e\n\tMean: %.6e\n", (double) sum, mean);
+    }
+
+    puts("Prueba con arreglo de largo 0:");
+    if (ST_OK != stats_var(&var, array, 0)) {
+        fprintf(stderr, "\tNo se pudo calcular la varianza (posiblemente el largo 0 tenga algo que ver)\n");
+    } else {
+        printf("\tVar: %.4f\n", var);
+    }
+
+    puts("Prueba con arreglo NULL:");
+    if (ST_OK != stats_max_i64(&max, NULL, length)) {
+        fprintf(stderr, "\tNo se pudo calcular el máximo (posiblemente el puntero nulo tenga algo que ver)\n");
+    } else {
+        printf("\tMax: %lld\n", (long long) max);
+    }
+
+    return EXIT_SUCCESS;
+}
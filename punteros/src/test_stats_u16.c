@@ -0,0 +1,56 @@
+#include "status.h"
+#include "stats.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MUCHOS 100000
+
+int main(void)
+{
+    uint16_t array[] = {512, 1023, 0, 4095, 700, 701, 65535, 12, 300};
+    size_t length = sizeof(array) / sizeof(array[0]);
+    uint16_t saturados[MUCHOS];
+    uint64_t sum;
+    double mean;
+    double var;
+    uint16_t min;
+    uint16_t max;
+
+    puts("Prueba con valores típicos:");
+    if ((ST_OK != stats_sum(&sum, array, length)) || (ST_OK != stats_mean(&mean, array, length))
+        || (ST_OK != stats_var(&var, array, length)) || (ST_OK != stats_min(&min, array, length))
+        || (ST_OK != stats_max(&max, array, length))) {
+        fprintf(stderr, "Ocurrió un error inesperado\n");
+    } else {
+        printf("\tSum: %llu\n\tMean: %.4f\n\tVar: %.4f\n", (unsigned long long) sum, mean, var);
+        printf("\tMin: %u\n\tMax: %u\n", (unsigned) min, (unsigned) max);
+    }
+
+    puts("Prueba con lecturas saturadas (la suma no entra en 32 bits):");
+    for (size_t i = 0; i < MUCHOS; ++i) {
+        saturados[i] = UINT16_MAX;
+    }
+    if ((ST_OK != stats_sum(&sum, saturados, MUCHOS)) || (ST_OK != stats_var(&var, saturados, MUCHOS))) {
+        fprintf(stderr, "Ocurrió un error inesperado\n");
+    } else {
+        printf("\tSum: %llu\n\tVar: %.4f\n", (unsigned long long) sum, var);
+    }
+
+    puts("Prueba con arreglo de largo 0:");
+    if (ST_OK != stats_max(&max, array, 0)) {
+        fprintf(stderr, "\tNo se pudo calcular el máximo (posiblemente el largo 0 tenga algo que ver)\n");
+    } else {
+        printf("\tMax: %u\n", (unsigned) max);
+    }
+
+    puts("Prueba con arreglo NULL:");
+    if (ST_OK != stats_sum_u16(&sum, NULL, length)) {
+        fprintf(stderr, "\tNo se pudo calcular la suma (posiblemente el puntero nulo tenga algo que ver)\n");
+    } else {
+        printf("\tSum: %llu\n", (unsigned long long) sum);
+    }
+
+    return EXIT_SUCCESS;
+}
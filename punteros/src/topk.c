@@ -0,0 +1,483 @@
+#include "status.h"
+#include "minmax.h"
+#include "topk.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define PREFETCH_DISTANCE 32
+#define LANES 4
+/* below this many elements, insertion sort beats partitioning */
+#define INSERTION_MAX 16
+/* topk with k above length / SELECT_RATIO selects over a copy instead of keeping a heap */
+#define SELECT_RATIO 16
+
+
+/* ascending, with NaN after every number: a total order, so partitioning always terminates */
+static inline bool before(double a, double b)
+{
+    return (a < b) || ((a == a) && (b != b));
+}
+
+
+/* topk order: larger value first, then smaller position */
+static inline bool better(const extremo_t *a, const extremo_t *b)
+{
+    return before(b->value, a->value) || (!before(a->value, b->value) && (a->index < b->index));
+}
+
+
+#define BEFORE_VALUE(a, b) before((a), (b))
+#define BEFORE_PTR(a, b) before(*(a), *(b))
+#define BEFORE_TOP(a, b) better(&(a), &(b))
+
+
+/* about twice log2(n) partitions before giving up on quickselect */
+static size_t depth_limit(size_t n)
+{
+    size_t d = 0;
+
+    while (n >>= 1) {
+        d += 2;
+    }
+
+    return d;
+}
+
+
+/*
+ * The same algorithms for the three element types: the values themselves, pointers to them (ordered by what they
+ * point to) and value/position pairs (ordered as topk wants them). BEFORE(a, b) is a strict order.
+ */
+#define SELECT_DEFINE(T, name, BEFORE)                                                                              \
+static inline void swap_##name(T *a, T *b)                                                                          \
+{                                                                                                                   \
+    T t = *a;                                                                                                       \
+                                                                                                                    \
+    *a = *b;                                                                                                        \
+    *b = t;                                                                                                         \
+}                                                                                                                   \
+                                                                                                                    \
+static void insertion_##name(T v[], size_t n)                                                                       \
+{                                                                                                                   \
+    T x;                                                                                                            \
+    size_t j;                                                                                                       \
+                                                                                                                    \
+    for (size_t i = 1; i < n; ++i) {                                                                                \
+        x = v[i];                                                                                                   \
+        for (j = i; (j > 0) && BEFORE(x, v[j - 1]); --j) {                                                          \
+            v[j] = v[j - 1];                                                                                        \
+        }                                                                                                           \
+        v[j] = x;                                                                                                   \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+/* max-heap in this order: the root is the element that would go last */                                           \
+static void sift_##name(T v[], size_t i, size_t n)                                                                  \
+{                                                                                                                   \
+    T x = v[i];                                                                                                     \
+    size_t c;                                                                                                       \
+                                                                                                                    \
+    while ((c = 2 * i + 1) < n) {                                                                                   \
+        if ((c + 1 < n) && BEFORE(v[c], v[c + 1])) {                                                                \
+            ++c;                                                                                                    \
+        }                                                                                                           \
+        if (!BEFORE(x, v[c])) {                                                                                     \
+            break;                                                                                                  \
+        }                                                                                                           \
+        v[i] = v[c];                                                                                                \
+        i = c;                                                                                                      \
+    }                                                                                                               \
+    v[i] = x;                                                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+static void heapify_##name(T v[], size_t n)                                                                         \
+{                                                                                                                   \
+    for (size_t i = n / 2; i-- > 0;) {                                                                              \
+        sift_##name(v, i, n);                                                                                       \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void heap_sort_##name(T v[], size_t n)                                                                       \
+{                                                                                                                   \
+    heapify_##name(v, n);                                                                                           \
+    while (n > 1) {                                                                                                 \
+        swap_##name(&v[0], &v[--n]);                                                                                \
+        sift_##name(v, 0, n);                                                                                       \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+/* the k first elements of v[0..n) end up in v[0..k), as a heap */                                                  \
+static void heap_select_##name(T v[], size_t n, size_t k)                                                           \
+{                                                                                                                   \
+    heapify_##name(v, k);                                                                                           \
+    for (size_t i = k; i < n; ++i) {                                                                                \
+        if (BEFORE(v[i], v[0])) {                                                                                   \
+            swap_##name(&v[0], &v[i]);                                                                              \
+            sift_##name(v, 0, k);                                                                                   \
+        }                                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+/* median of three as the pivot, Hoare partition around it; returns where the pivot ends (n > 2) */                 \
+static size_t partition_##name(T v[], size_t n)                                                                     \
+{                                                                                                                   \
+    size_t m = n / 2;                                                                                               \
+    size_t i = 0;                                                                                                   \
+    size_t j = n;                                                                                                   \
+    T p;                                                                                                            \
+                                                                                                                    \
+    if (BEFORE(v[m], v[0])) {                                                                                       \
+        swap_##name(&v[m], &v[0]);                                                                                  \
+    }                                                                                                               \
+    if (BEFORE(v[n - 1], v[m])) {                                                                                   \
+        swap_##name(&v[n - 1], &v[m]);                                                                              \
+        if (BEFORE(v[m], v[0])) {                                                                                   \
+            swap_##name(&v[m], &v[0]);                                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+    swap_##name(&v[0], &v[m]);                                                                                      \
+    p = v[0];                                                                                                       \
+                                                                                                                    \
+    /* both scans stop on elements equal to the pivot, so runs of equal values split in half */                     \
+    for (;;) {                                                                                                      \
+        do {                                                                                                        \
+            ++i;                                                                                                    \
+        } while ((i < n) && BEFORE(v[i], p));                                                                       \
+        do {                                                                                                        \
+            --j;                                                                                                    \
+        } while (BEFORE(p, v[j]));                                                                                  \
+        if (i >= j) {                                                                                               \
+            break;                                                                                                  \
+        }                                                                                                           \
+        swap_##name(&v[i], &v[j]);                                                                                  \
+    }                                                                                                               \
+    swap_##name(&v[0], &v[j]);                                                                                      \
+                                                                                                                    \
+    return j;                                                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+/* introselect: only the side holding position nth is partitioned again */                                          \
+static void select_##name(T v[], size_t n, size_t nth)                                                              \
+{                                                                                                                   \
+    size_t depth = depth_limit(n);                                                                                  \
+    size_t p;                                                                                                       \
+                                                                                                                    \
+    while (n > INSERTION_MAX) {                                                                                     \
+        if (0 == depth--) {                                                                                         \
+            heap_select_##name(v, n, nth + 1);                                                                      \
+            swap_##name(&v[0], &v[nth]);                                                                            \
+            return;                                                                                                 \
+        }                                                                                                           \
+        p = partition_##name(v, n);                                                                                 \
+        if (p == nth) {                                                                                             \
+            return;                                                                                                 \
+        }                                                                                                           \
+        if (nth < p) {                                                                                              \
+            n = p;                                                                                                  \
+        } else {                                                                                                    \
+            v += p + 1;                                                                                             \
+            n -= p + 1;                                                                                             \
+            nth -= p + 1;                                                                                           \
+        }                                                                                                           \
+    }                                                                                                               \
+    insertion_##name(v, n);                                                                                         \
+}                                                                                                                   \
+                                                                                                                    \
+/* introsort: recursion only into the smaller side, so the stack stays logarithmic */                               \
+static void sort_##name(T v[], size_t n, size_t depth)                                                              \
+{                                                                                                                   \
+    size_t p;                                                                                                       \
+                                                                                                                    \
+    while (n > INSERTION_MAX) {                                                                                     \
+        if (0 == depth--) {                                                                                         \
+            heap_sort_##name(v, n);                                                                                 \
+            return;                                                                                                 \
+        }                                                                                                           \
+        p = partition_##name(v, n);                                                                                 \
+        if (p < n - p - 1) {                                                                                        \
+            sort_##name(v, p, depth);                                                                               \
+            v += p + 1;                                                                                             \
+            n -= p + 1;                                                                                             \
+        } else {                                                                                                    \
+            sort_##name(v + p + 1, n - p - 1, depth);                                                               \
+            n = p;                                                                                                  \
+        }                                                                                                           \
+    }                                                                                                               \
+    insertion_##name(v, n);                                                                                         \
+}                                                                                                                   \
+                                                                                                                    \
+static void partial_##name(T v[], size_t n, size_t k)                                                               \
+{                                                                                                                   \
+    if (0 == k) {                                                                                                   \
+        return;                                                                                                     \
+    }                                                                                                               \
+    if (k < n) {                                                                                                    \
+        select_##name(v, n, k - 1);                                                                                 \
+    }                                                                                                               \
+    sort_##name(v, k, depth_limit(k));                                                                              \
+}
+
+
+SELECT_DEFINE(double, value, BEFORE_VALUE)
+SELECT_DEFINE(double *, ptr, BEFORE_PTR)
+SELECT_DEFINE(extremo_t, top, BEFORE_TOP)
+
+
+/* top[] is a heap with the worst of the k kept at the root; x enters only if it goes before it */
+static inline void offer(extremo_t top[], size_t k, double x, size_t i)
+{
+    if (before(top[0].value, x)) {
+        top[0].value = x;
+        top[0].index = i;
+        sift_top(top, 0, k);
+    }
+}
+
+
+#ifdef __AVX2__
+/* lanes greater than the root, or NaN: in a large array, after the first few thousand, almost never */
+static inline int candidates(__m256d x, const extremo_t top[])
+{
+    return _mm256_movemask_pd(_mm256_cmp_pd(x, _mm256_set1_pd(top[0].value), _CMP_NLE_UQ));
+}
+#endif
+
+
+static void topk_heap(extremo_t top[], size_t k, const double v[], size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < k; ++i) {
+        top[i].value = v[i];
+        top[i].index = i;
+    }
+    heapify_top(top, k);
+
+#ifdef __AVX2__
+    int mask;
+
+    /* lanes are offered in order, so an equal value never displaces an earlier position */
+    for (; i + LANES <= length; i += LANES) {
+        for (mask = candidates(_mm256_loadu_pd(v + i), top); 0 != mask; mask &= mask - 1) {
+            offer(top, k, v[i + __builtin_ctz(mask)], i + __builtin_ctz(mask));
+        }
+    }
+#endif
+
+    for (; i < length; ++i) {
+        offer(top, k, v[i], i);
+    }
+}
+
+
+static void topk_heap_ptr(extremo_t top[], size_t k, double *const ptrs[], size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < k; ++i) {
+        top[i].value = *ptrs[i];
+        top[i].index = i;
+    }
+    heapify_top(top, k);
+
+#ifdef __AVX2__
+    __m256i p;
+    int mask;
+
+    for (; i + LANES <= length; i += LANES) {
+        if (i + PREFETCH_DISTANCE + LANES <= length) {
+            for (size_t j = 0; j < LANES; ++j) {
+                _mm_prefetch((const char *) ptrs[i + PREFETCH_DISTANCE + j], _MM_HINT_T0);
+            }
+        }
+        /* the pointers are the gather offsets, from address 0 */
+        p = _mm256_loadu_si256((const __m256i *) (ptrs + i));
+        for (mask = candidates(_mm256_i64gather_pd((const double *) 0, p, 1), top); 0 != mask; mask &= mask - 1) {
+            offer(top, k, *ptrs[i + __builtin_ctz(mask)], i + __builtin_ctz(mask));
+        }
+    }
+#endif
+
+    for (; i < length; ++i) {
+        if (i + PREFETCH_DISTANCE < length) {
+            __builtin_prefetch(ptrs[i + PREFETCH_DISTANCE]);
+        }
+        offer(top, k, *ptrs[i], i);
+    }
+}
+
+
+/* every value with its position, partially sorted in topk order; the first k are copied out */
+static void topk_select(extremo_t top[], size_t k, extremo_t all[], size_t length)
+{
+    partial_top(all, length, k);
+    memcpy(top, all, k * sizeof(extremo_t));
+}
+
+
+status_t topk(extremo_t top[], size_t k, const double v[], size_t length)
+{
+    extremo_t *all;
+
+    if ((NULL == top) || (NULL == v)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    if (k > length) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    if (0 == k) {
+        return ST_OK;
+    }
+
+    if (k <= length / SELECT_RATIO) {
+        topk_heap(top, k, v, length);
+        sort_top(top, k, depth_limit(k));
+        return ST_OK;
+    }
+
+    all = (extremo_t *) malloc(length * sizeof(extremo_t));
+    if (NULL == all) {
+        return ST_ERR_UNKNOWN;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        all[i].value = v[i];
+        all[i].index = i;
+    }
+    topk_select(top, k, all, length);
+    free(all);
+
+    return ST_OK;
+}
+
+
+status_t topk_ptr(extremo_t top[], size_t k, double *const ptrs[], size_t length)
+{
+    extremo_t *all;
+
+    if ((NULL == top) || (NULL == ptrs)) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    if (k > length) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    if (0 == k) {
+        return ST_OK;
+    }
+
+    if (k <= length / SELECT_RATIO) {
+        topk_heap_ptr(top, k, ptrs, length);
+        sort_top(top, k, depth_limit(k));
+        return ST_OK;
+    }
+
+    all = (extremo_t *) malloc(length * sizeof(extremo_t));
+    if (NULL == all) {
+        return ST_ERR_UNKNOWN;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        all[i].value = *ptrs[i];
+        all[i].index = i;
+    }
+    topk_select(top, k, all, length);
+    free(all);
+
+    return ST_OK;
+}
+
+
+status_t nth_element(double v[], size_t length, size_t n)
+{
+    if (NULL == v) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    if (n >= length) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    select_value(v, length, n);
+
+    return ST_OK;
+}
+
+
+status_t nth_element_ptr(double *ptrs[], size_t length, size_t n)
+{
+    if (NULL == ptrs) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    if (n >= length) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    select_ptr(ptrs, length, n);
+
+    return ST_OK;
+}
+
+
+status_t partial_sort(double v[], size_t length, size_t k)
+{
+    if (NULL == v) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    if (k > length) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    partial_value(v, length, k);
+
+    return ST_OK;
+}
+
+
+status_t partial_sort_ptr(double *ptrs[], size_t length, size_t k)
+{
+    if (NULL == ptrs) {
+        return ST_ERR_NULL_PTR;
+    }
+
+    if (0 == length) {
+        return ST_ERR_LZERO_ARRAY;
+    }
+
+    if (k > length) {
+        return ST_ERR_INVALID_ARG;
+    }
+
+    partial_ptr(ptrs, length, k);
+
+    return ST_OK;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "status.h"
+#include "minmax.h"
+
+#include <stdlib.h>
+
+/*
+ * Los k mayores, el n-ésimo y ordenamiento parcial: lo que hace `maximo` pero para más de un elemento, sin ordenar
+ * todo el arreglo.
+ *
+ * -   topk deja en top[0..k) los k mayores valores con sus posiciones, de mayor a menor (entre valores iguales, primero
+ *     la posición más chica). No modifica el arreglo. Para k chico usa un heap de k elementos dentro del mismo `top`,
+ *     y descarta de a 4 (con AVX2) los elementos que no superan al menor del heap, que son casi todos en un arreglo
+ *     grande; si k es una fracción grande del arreglo, copia valores y posiciones y usa nth_element.
+ * -   nth_element reordena el arreglo de modo que en la posición n quede el valor que tendría si se ordenara, con
+ *     ninguno mayor antes ni ninguno menor después (introselect: quickselect con mediana de tres que, si no avanza,
+ *     pasa a un heap; O(length) en promedio y O(length log length) en el peor caso).
+ * -   partial_sort reordena el arreglo de modo que v[0..k) sean los k menores, ordenados de menor a mayor; el resto
+ *     queda en cualquier orden.
+ *
+ * Las versiones `_ptr` reciben un arreglo de punteros como el de `maximo` de ptr_array.c (ningún puntero puede ser
+ * NULL) y reordenan los punteros, no los valores: para saber de qué posición vino cada uno, alcanza con armar el
+ * arreglo de punteros con &v[i] y restar v.
+ *
+ * Los NaN se consideran mayores que cualquier número (quedan al final al ordenar y primeros en topk), así que el
+ * orden está bien definido aunque los haya.
+ *
+ * Devuelven ST_ERR_INVALID_ARG si k > length o n >= length, y ST_ERR_UNKNOWN si topk necesita memoria y no la
+ * consigue.
+ */
+
+status_t topk(extremo_t top[], size_t k, const double v[], size_t length);
+status_t topk_ptr(extremo_t top[], size_t k, double *const ptrs[], size_t length);
+
+status_t nth_element(double v[], size_t length, size_t n);
+status_t nth_element_ptr(double *ptrs[], size_t length, size_t n);
+
+status_t partial_sort(double v[], size_t length, size_t k);
+status_t partial_sort_ptr(double *ptrs[], size_t length, size_t k);